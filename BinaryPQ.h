@@ -5,14 +5,99 @@
 
 
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include "Eecs281PQ.h"
+#include "ParallelRebuild.h"
+
+
+// How BinaryPQ arranges the nodes of its heap in memory, given as its
+// LAYOUT template argument.
+//   Classic  the children of node i are nodes 2i and 2i + 1. Every level
+//            down a sift lands twice as far away, so in a heap much larger
+//            than the caches each level is a cache miss, and past the
+//            first few levels a TLB miss as well.
+//   BHeap    Kamp's B-heap: the nodes are grouped in pages of memory, each
+//            holding whole subtrees about log2(page) levels deep, so a
+//            sift touches O(log(n) / log(page)) pages instead of O(log(n)).
+//            The tree is up to a third deeper and the index arithmetic
+//            longer, which pays off only where touching a new page costs
+//            far more than that: a heap that is paged out, or a machine
+//            whose caches and TLB are much smaller than the heap. Measure
+//            with benchPQ (the BHeap queue) before choosing it.
+struct HeapLayout {
+    struct Classic {};
+    struct BHeap {};
+};
+
+
+// Description: Nodes per page of a BHeap layout for elements of the given
+//              size: the largest power of two that fits in 4096 bytes, but
+//              at least 8.
+// Runtime: O(1)
+constexpr std::size_t bheapPageSlots(std::size_t elementSize) {
+    std::size_t slots = 8;
+    while (slots * 2 * elementSize <= 4096)
+        slots *= 2;
+    return slots;
+} // bheapPageSlots()
+
+
+// Allocator for the heap array of a BHeap layout BinaryPQ. Node i is
+// element i - 1 of the array; the allocator puts element 0 one element
+// past a page boundary, so that node i lies i elements past it and every
+// page of nodes starts at a page boundary (exactly, when sizeof(TYPE) is a
+// power of two).
+template<typename TYPE>
+class PageAllocator {
+public:
+    using value_type = TYPE;
+
+    static constexpr std::size_t PAGE_BYTES = 4096;
+    static_assert(alignof(TYPE) <= PAGE_BYTES, "over-aligned types are not supported");
+
+    PageAllocator() = default;
+    template<typename OTHER>
+    PageAllocator(const PageAllocator<OTHER> &) {}
+
+    TYPE *allocate(std::size_t n) {
+        char *block = static_cast<char *>(
+            ::operator new(n * sizeof(TYPE) + offset(), std::align_val_t{ PAGE_BYTES }));
+        return reinterpret_cast<TYPE *>(block + offset());
+    } // allocate()
+
+    void deallocate(TYPE *ptr, std::size_t) {
+        ::operator delete(reinterpret_cast<char *>(ptr) - offset(), std::align_val_t{ PAGE_BYTES });
+    } // deallocate()
+
+    template<typename OTHER>
+    bool operator==(const PageAllocator<OTHER> &) const { return true; }
+    template<typename OTHER>
+    bool operator!=(const PageAllocator<OTHER> &) const { return false; }
+
+private:
+    // Bytes between the aligned block and element 0. A multiple of
+    // alignof(TYPE), since both sizeof(TYPE) and PAGE_BYTES are.
+    static constexpr std::size_t offset() {
+        return sizeof(TYPE) % PAGE_BYTES;
+    } // offset()
+}; // PageAllocator
+
 
 // A specialized version of the priority queue ADT implemented as a binary heap.
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class BinaryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+// LAYOUT chooses where the nodes are kept (see HeapLayout).
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename LAYOUT = HeapLayout::Classic>
+class BinaryPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
+    static constexpr bool CLASSIC = std::is_same<LAYOUT, HeapLayout::Classic>::value;
+    static_assert(CLASSIC || std::is_same<LAYOUT, HeapLayout::BHeap>::value,
+                  "LAYOUT must be HeapLayout::Classic or HeapLayout::BHeap");
+
 public:
     // Description: Construct an empty PQ with an optional comparison functor.
     // Runtime: O(1)
@@ -40,25 +125,111 @@ public:
 
 
     // Description: Assumes that all elements inside the heap are out of order and
-    //              'rebuilds' the heap by fixing the heap invariant.
+    //              'rebuilds' the heap by fixing the heap invariant. Large
+    //              heaps in the classic layout are rebuilt with the threads
+    //              allowed by setRebuildThreads(); a B-heap is always
+    //              rebuilt serially.
     // Runtime: O(n)
     virtual void updatePriorities() {
         // TODO: Implement this function.
+        if constexpr (CLASSIC) {
+            size_t threads = rebuildWorkers(size());
+            if (threads > 1) {
+                parallelHeapify(threads);
+                return;
+            }
+        }
+        // Children always come after their parents, in either layout.
         for (size_t i = size(); i > 0; i--) {
             fixDown(i);
         }
     } // updatePriorities()
 
 
+    // Description: Repairs the heap after the elements in 'changed' were
+    //              modified in place. One scan finds their positions without
+    //              calling the comparator, then only those positions and
+    //              their ancestors are sifted. Rebuilds the whole heap when
+    //              many elements changed or TYPE cannot be searched.
+    // Runtime: O(n log(k) + k log^2(n)) for k changed elements
+    virtual void notifyChanged(const std::vector<TYPE> &changed) {
+        if constexpr (ChangedSet<TYPE>::SEARCHABLE) {
+            if (!BaseClass::rebuildCheaper(changed.size(), size())) {
+                ChangedSet<TYPE> dirty{ changed };
+                std::vector<size_t> positions;
+                for (size_t i = 1; i <= size(); i++) {
+                    if (dirty.contains(getVal(i)))
+                        positions.push_back(i);
+                }
+                repair(positions);
+                return;
+            }
+        }
+        BaseClass::notifyChanged(changed);
+    } // notifyChanged()
+
+
     // Description: Add a new element to the PQ.
     // Runtime: O(log(n))
     virtual void push(const TYPE &val) {
         // TODO: Implement this function.
         data.push_back(val);
-        fixUp();
+        fixUp(size());
     } // push()
 
 
+    // Description: Add a new element to the PQ, moving from val.
+    // Runtime: O(log(n))
+    virtual void push(TYPE &&val) {
+        data.push_back(std::move(val));
+        fixUp(size());
+    } // push()
+
+
+    // Description: Construct a new element in place at the end of the heap
+    //              and sift it up.
+    // Runtime: O(log(n))
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        data.emplace_back(std::forward<Args>(args)...);
+        fixUp(size());
+    } // emplace()
+
+
+    // Description: Moves every element of other into this PQ and leaves
+    //              other empty. other's elements are appended to the heap,
+    //              which is then restored by sifting each of them up when
+    //              there are few, or rebuilt with updatePriorities() when
+    //              that is cheaper. other must order elements the same way
+    //              as this PQ.
+    // Runtime: O(min(m log(n + m), n + m)) for m elements in other
+    void merge(BinaryPQ &&other) {
+        if (&other == this || other.empty())
+            return;
+        const size_t old = size();
+        if (old == 0) {
+            data.swap(other.data);
+        }
+        else {
+            data.reserve(old + other.size());
+            data.insert(data.end(), std::make_move_iterator(other.data.begin()),
+                        std::make_move_iterator(other.data.end()));
+        }
+        other.data.clear();
+
+        size_t depth = 1;
+        while ((size_t{ 1 } << depth) <= size())
+            ++depth;
+        if ((size() - old) * depth < size()) {
+            for (size_t i = old + 1; i <= size(); i++)
+                fixUp(i);
+        }
+        else if (old != 0) {
+            updatePriorities();
+        }
+    } // merge()
+
+
     // Description: Remove the most extreme (defined by 'compare') element
     //              from the PQ.
     // Note: We will not run tests on your code that would require it to pop
@@ -67,12 +238,26 @@ public:
     // Runtime: O(log(n))
     virtual void pop() {
         // TODO: Implement this function.
-        getVal(1) = getVal(size());
+        if (size() == 1) {
+            data.pop_back();
+            return;
+        }
+        TYPE last = std::move(getVal(size()));
         data.pop_back();
-        fixDown(1);
+        fillRoot(std::move(last));
     } // pop()
 
 
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value (moved, not copied).
+    // Runtime: O(log(n))
+    virtual TYPE pop_top() {
+        TYPE result = std::move(getVal(1));
+        pop();
+        return result;
+    } // pop_top()
+
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the PQ. This should be a reference for speed. It MUST
     //              be const because we cannot allow it to be modified, as
@@ -103,8 +288,15 @@ public:
 
 
 private:
+    using Allocator = std::conditional_t<CLASSIC, std::allocator<TYPE>, PageAllocator<TYPE>>;
+
+    // Nodes per page in the BHeap layout, and the mask that gives the slot
+    // of a node in its page.
+    static constexpr size_t PAGE_SLOTS = bheapPageSlots(sizeof(TYPE));
+    static constexpr size_t SLOT_MASK = PAGE_SLOTS - 1;
+
     // Note: This vector *must* be used for your PQ implementation.
-    std::vector<TYPE> data;
+    std::vector<TYPE, Allocator> data;
     // NOTE: You are not allowed to add any member variables. You don't need
     //       a "heapSize", since you can call your own size() member
     //       function, or check data.size().
@@ -115,29 +307,185 @@ private:
         return data[v - 1];
     }
 
-    void fixUp() {
-        size_t i = size();
+    // Node indices are 1-based, and in both layouts a node's children come
+    // after it, so the first n indices always form a tree.
+    //
+    // In the BHeap layout, slot s of page p is node p * PAGE_SLOTS + s. Page
+    // 0 is a classic heap in slots 1 .. PAGE_SLOTS - 1. Every other page
+    // holds two subtrees, rooted at slots 0 and 1: each of those has one
+    // child, slots 2 and 3, and from there on the children of slot s are
+    // slots 2s and 2s + 1 as usual. The children of the bottom row of a
+    // page, slots PAGE_SLOTS / 2 and up, are the two roots of a page of
+    // their own; pages are numbered in breadth-first order, so the heap
+    // grows one page at a time.
 
-        while (i > 1 && this->compare(getVal(i / 2), getVal(i))) {
-            std::swap(getVal(i), getVal(i / 2));
-            i /= 2;
+    // Description: Index of the parent of node i; 0 for the root.
+    // Runtime: O(1)
+    static size_t parent(size_t i) {
+        if constexpr (CLASSIC) {
+            return i / 2;
         }
-    }
+        else {
+            const size_t slot = i & SLOT_MASK;
+            if (i < PAGE_SLOTS || slot >= 4)
+                return (i & ~SLOT_MASK) | (slot / 2);
+            if (slot >= 2)
+                return i - 2;
+            // A page root: its parent is in the bottom row of an earlier page.
+            const size_t page = i / PAGE_SLOTS - 1;
+            return page / (PAGE_SLOTS / 2) * PAGE_SLOTS + PAGE_SLOTS / 2 + page % (PAGE_SLOTS / 2);
+        }
+    } // parent()
+
+    // Description: Index of the first child of node i, whether or not it
+    //              is in the heap.
+    // Runtime: O(1)
+    static size_t firstChild(size_t i) {
+        if constexpr (CLASSIC) {
+            return 2 * i;
+        }
+        else {
+            const size_t slot = i & SLOT_MASK;
+            if (i >= PAGE_SLOTS && slot < 2)
+                return i + 2;
+            if (slot >= PAGE_SLOTS / 2)
+                return (i / PAGE_SLOTS * (PAGE_SLOTS / 2) + slot - PAGE_SLOTS / 2 + 1) * PAGE_SLOTS;
+            return i + slot;
+        }
+    } // firstChild()
+
+    // Description: True if node i can have a second child, right after its
+    //              first. Only the page roots of a B-heap have just one.
+    // Runtime: O(1)
+    static bool twoChildren(size_t i) {
+        return CLASSIC || i < PAGE_SLOTS || (i & SLOT_MASK) >= 2;
+    } // twoChildren()
+
+    // Description: Index of the more extreme child of node i in a heap of n
+    //              nodes, or 0 if node i has no children.
+    // Runtime: O(1)
+    size_t extremeChild(size_t i, size_t n) {
+        size_t j = firstChild(i);
+        if (j > n)
+            return 0;
+        if (j < n && twoChildren(i) && this->compare(getVal(j), getVal(j + 1))) {
+            ++j;
+        }
+        return j;
+    } // extremeChild()
+
+    // The sift routines below do not swap. The element being sifted is
+    // moved out once, leaving a "hole" that travels through the heap with
+    // one move per level, and is moved into its final position at the end.
 
+    // Description: Moves the element at index i up until its parent is
+    //              not less extreme.
+    // Runtime: O(log(n))
+    void fixUp(size_t i) {
+        if (i <= 1 || !this->compare(getVal(parent(i)), getVal(i)))
+            return;
+
+        TYPE value = std::move(getVal(i));
+        do {
+            getVal(i) = std::move(getVal(parent(i)));
+            i = parent(i);
+        } while (i > 1 && this->compare(getVal(parent(i)), value));
+        getVal(i) = std::move(value);
+    } // fixUp()
+
+    // Description: Moves the element at index i down until neither child
+    //              is more extreme.
+    // Runtime: O(log(n))
     void fixDown(size_t i) {
-        while (2 * i <= size()) {
-            size_t j = 2 * i;
-            if (j < size() && this->compare(getVal(j), getVal(j + 1))) {
-                ++j;
-            }
+        const size_t n = size();
+        size_t j = extremeChild(i, n);
+        if (j == 0)
+            return;
 
-            if (!this->compare(getVal(i), getVal(j))) {
+        TYPE value = std::move(getVal(i));
+        do {
+            if (!this->compare(value, getVal(j))) {
                 break;
             }
-            std::swap(getVal(i), getVal(j));
+            getVal(i) = std::move(getVal(j));
             i = j;
+        } while ((j = extremeChild(i, n)) != 0);
+        getVal(i) = std::move(value);
+    } // fixDown()
+
+    // Description: Restores the heap when only the elements at the given
+    //              positions may be out of order. updatePriorities() runs
+    //              fixDown() on every node bottom-up, but on a subtree that
+    //              holds no changed element fixDown() does nothing, so it is
+    //              enough to run it on the changed nodes and their
+    //              ancestors, still bottom-up.
+    // Runtime: O(k log^2(n)) for k positions
+    void repair(const std::vector<size_t> &positions) {
+        std::vector<size_t> nodes;
+        for (size_t i : positions) {
+            for (; i >= 1; i = parent(i))
+                nodes.push_back(i);
         }
-    }
+        std::sort(nodes.begin(), nodes.end(), std::greater<size_t>());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+        for (size_t i : nodes)
+            fixDown(i);
+    } // repair()
+
+    // Description: updatePriorities() with several threads. fixDown() on a
+    //              node only touches that node's subtree, so the subtrees
+    //              rooted at one level are independent: they are handed out
+    //              to the threads, each heapified bottom-up level by level.
+    //              The few nodes above that level are done serially last.
+    // Runtime: O(n / threads + threads log(n))
+    void parallelHeapify(size_t threads) {
+        const size_t lastParent = size() / 2;
+        // Four subtrees per thread even out their uneven bottom levels.
+        size_t first = 1;
+        while (first < 4 * threads)
+            first *= 2;
+
+        parallelFor(threads, first, [&](size_t k) {
+            const size_t root = first + k;
+            if (root > lastParent)
+                return;
+            size_t depth = 0;
+            while ((root << (depth + 1)) <= lastParent)
+                ++depth;
+            for (size_t d = depth + 1; d > 0; d--) {
+                size_t begin = root << (d - 1);
+                size_t end = std::min(begin + (size_t{ 1 } << (d - 1)), lastParent + 1);
+                for (size_t i = end; i > begin; i--)
+                    fixDown(i - 1);
+            }
+        });
+        for (size_t i = std::min(first - 1, lastParent); i > 0; i--) {
+            fixDown(i);
+        }
+    } // parallelHeapify()
+
+    // Description: Fills the root, whose element has just been removed, with
+    //              value (Floyd's bottom-up deletion). The hole is first
+    //              carried all the way down to a leaf by promoting the more
+    //              extreme child at each level, then value is sifted up from
+    //              that leaf. Because the element taken from the back of the
+    //              heap almost always belongs near the bottom, this needs
+    //              about log(n) comparisons instead of the 2 log(n) of
+    //              fixDown().
+    // Runtime: O(log(n))
+    void fillRoot(TYPE &&value) {
+        const size_t n = size();
+        size_t i = 1;
+        for (size_t j; (j = extremeChild(i, n)) != 0; i = j) {
+            getVal(i) = std::move(getVal(j));
+        }
+
+        while (i > 1 && this->compare(getVal(parent(i)), value)) {
+            getVal(i) = std::move(getVal(parent(i)));
+            i = parent(i);
+        }
+        getVal(i) = std::move(value);
+    } // fillRoot()
 
 }; // BinaryPQ
 
@@ -0,0 +1,282 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef BUCKETPQ_H
+#define BUCKETPQ_H
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Eecs281PQ.h"
+#include "PQKey.h"
+
+
+// A specialized version of the priority queue ADT implemented as a bucket
+// queue, for integer priorities in a small range known up front, such as
+// QoS classes. KEY_OF()(val) gives the priority of an element (see
+// PriorityOf in PQKey.h), and every priority in [lowest, highest] has a
+// bucket of its own. HighestFirst<COMP_FUNCTOR> tells which end of the
+// range is the top; COMP_FUNCTOR itself is never called.
+//
+// Buckets are numbered by rank, 0 being the most extreme priority. A
+// bitmap marks the nonempty buckets and a summary bitmap the nonzero words
+// of the first one, so the next nonempty bucket is found with a count of
+// trailing zeros per 4096 buckets. Each bucket is a vector read from a head
+// index, so elements of equal priority come out in the order they were
+// pushed (FIFO), and a bucket that has been emptied keeps its capacity.
+//
+// An element whose priority is outside the range is rejected with a
+// std::out_of_range, which leaves the PQ unchanged.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename KEY_OF = PriorityOf>
+class BucketPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(HasHighestFirst<COMP_FUNCTOR>::value,
+                  "BucketPQ needs to know which end is the top: specialize HighestFirst for this comparator");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    using priority_type = std::decay_t<decltype(std::declval<const KEY_OF &>()(std::declval<const TYPE &>()))>;
+    static_assert(std::is_integral<priority_type>::value, "KEY_OF must return an integer priority");
+
+    // Description: Construct an empty PQ for priorities from lowest to
+    //              highest, inclusive, with an optional comparison functor
+    //              and key extractor.
+    // Runtime: O(highest - lowest)
+    BucketPQ(priority_type lowest, priority_type highest, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             KEY_OF keyOf = KEY_OF()) :
+        BaseClass{ comp }, keyOf{ keyOf }, lowest{ lowest }, highest{ highest } {
+        if (highest < lowest)
+            throw std::invalid_argument("BucketPQ: the highest priority is below the lowest");
+        const std::size_t ranks = distance(lowest, highest) + 1;
+        buckets.resize(ranks);
+        bits.resize((ranks + 63) / 64);
+        summary.resize((bits.size() + 63) / 64);
+    } // BucketPQ()
+
+
+    // Description: Construct a PQ out of an iterator range, for priorities
+    //              from lowest to highest, with an optional comparison
+    //              functor and key extractor.
+    // Runtime: O(n + highest - lowest) where n is number of elements in range.
+    template<typename InputIterator>
+    BucketPQ(InputIterator start, InputIterator end, priority_type lowest, priority_type highest,
+             COMP_FUNCTOR comp = COMP_FUNCTOR(), KEY_OF keyOf = KEY_OF()) :
+        BucketPQ{ lowest, highest, comp, keyOf } {
+        for (; start != end; ++start)
+            push(*start);
+    } // BucketPQ()
+
+
+    // Description: Destructor doesn't need any code, the buckets will be
+    //              destroyed automatically.
+    virtual ~BucketPQ() {
+    } // ~BucketPQ()
+
+
+    // Description: Assumes that all elements are out of order and moves each
+    //              to the bucket of its current priority. Elements that end
+    //              up in the same bucket keep their order. Throws
+    //              std::out_of_range, leaving the PQ unchanged, if a
+    //              priority is now outside the range.
+    // Runtime: O(n + highest - lowest)
+    virtual void updatePriorities() {
+        for (const Bucket &bucket : buckets) {
+            for (std::size_t i = bucket.head; i < bucket.items.size(); ++i)
+                rankOf(bucket.items[i]);
+        }
+        std::vector<TYPE> all;
+        all.reserve(count);
+        for (Bucket &bucket : buckets) {
+            for (std::size_t i = bucket.head; i < bucket.items.size(); ++i)
+                all.push_back(std::move(bucket.items[i]));
+            bucket.items.clear();
+            bucket.head = 0;
+        }
+        std::fill(bits.begin(), bits.end(), 0);
+        std::fill(summary.begin(), summary.end(), 0);
+        count = 0;
+        for (TYPE &val : all)
+            insert(rankOf(val), std::move(val));
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ. Throws std::out_of_range,
+    //              leaving the PQ unchanged, if its priority is outside the
+    //              range.
+    // Runtime: Amortized O(1)
+    virtual void push(const TYPE &val) {
+        insert(rankOf(val), TYPE(val));
+    } // push()
+
+
+    // Description: Add a new element to the PQ, moving from val. Throws like
+    //              push(const TYPE &).
+    // Runtime: Amortized O(1)
+    virtual void push(TYPE &&val) {
+        const std::size_t rank = rankOf(val);
+        insert(rank, std::move(val));
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ: the oldest element of the top bucket.
+    // Note: We will not run tests on your code that would require it to pop
+    // an element when the PQ is empty. Though you are welcome to if you are
+    // familiar with them, you do not need to use exceptions in this project.
+    // Runtime: Amortized O(1) plus O(ranks / 4096) when a bucket runs empty
+    virtual void pop() {
+        pop_top();
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value (moved, not copied).
+    // Runtime: As pop().
+    virtual TYPE pop_top() {
+        Bucket &bucket = buckets[topRank];
+        TYPE result = std::move(bucket.items[bucket.head++]);
+        --count;
+        if (bucket.head == bucket.items.size()) {
+            bucket.items.clear();
+            bucket.head = 0;
+            clearBit(topRank);
+            if (count > 0)
+                topRank = firstRank(topRank + 1);
+        }
+        else if (bucket.head >= COMPACT_MIN && bucket.head * 2 >= bucket.items.size()) {
+            // Drop the popped front, so a bucket that never runs empty does
+            // not grow without bound.
+            bucket.items.erase(bucket.items.begin(),
+                               bucket.items.begin() + static_cast<std::ptrdiff_t>(bucket.head));
+            bucket.head = 0;
+        }
+        return result;
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ. This should be a reference for speed. It MUST
+    //              be const because we cannot allow it to be modified, as
+    //              that might make it no longer be the most extreme element.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        const Bucket &bucket = buckets[topRank];
+        return bucket.items[bucket.head];
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+private:
+    // Popped elements a bucket holds before it may be compacted.
+    static constexpr std::size_t COMPACT_MIN = 32;
+
+    struct Bucket {
+        std::vector<TYPE> items;
+        // Index of the oldest element still in the bucket.
+        std::size_t head = 0;
+    };
+
+    KEY_OF keyOf;
+    priority_type lowest;
+    priority_type highest;
+    std::vector<Bucket> buckets;
+    // Bit r % 64 of bits[r / 64] is set when bucket r is nonempty.
+    std::vector<std::uint64_t> bits;
+    // Bit w % 64 of summary[w / 64] is set when bits[w] is nonzero.
+    std::vector<std::uint64_t> summary;
+    std::size_t count = 0;
+    // Rank of the top bucket, valid while the PQ is not empty.
+    std::size_t topRank = 0;
+
+
+    // Description: b - a for a <= b, without overflow.
+    // Runtime: O(1)
+    static std::size_t distance(priority_type a, priority_type b) {
+        using Unsigned = std::make_unsigned_t<priority_type>;
+        return static_cast<std::size_t>(static_cast<Unsigned>(static_cast<Unsigned>(b) - static_cast<Unsigned>(a)));
+    } // distance()
+
+    static std::size_t lowestBit(std::uint64_t word) {
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+        std::size_t bit = 0;
+        for (; (word & 1) == 0; word >>= 1)
+            ++bit;
+        return bit;
+#endif
+    } // lowestBit()
+
+    // Description: The rank of val's bucket. Throws std::out_of_range if its
+    //              priority is outside the range.
+    // Runtime: O(1)
+    std::size_t rankOf(const TYPE &val) const {
+        const priority_type priority = keyOf(val);
+        if (priority < lowest || highest < priority)
+            throw std::out_of_range("BucketPQ: priority outside the range the PQ was constructed for");
+        return HighestFirst<COMP_FUNCTOR>::value ? distance(priority, highest) : distance(lowest, priority);
+    } // rankOf()
+
+    // Description: Appends val to the bucket of the given rank.
+    // Runtime: Amortized O(1)
+    void insert(std::size_t rank, TYPE &&val) {
+        Bucket &bucket = buckets[rank];
+        bucket.items.push_back(std::move(val));
+        if (bucket.items.size() - bucket.head == 1) {
+            bits[rank / 64] |= std::uint64_t{ 1 } << (rank % 64);
+            summary[rank / 4096] |= std::uint64_t{ 1 } << (rank / 64 % 64);
+        }
+        if (count++ == 0 || rank < topRank)
+            topRank = rank;
+    } // insert()
+
+    // Description: Marks the bucket of the given rank empty.
+    // Runtime: O(1)
+    void clearBit(std::size_t rank) {
+        std::uint64_t &word = bits[rank / 64];
+        word &= ~(std::uint64_t{ 1 } << (rank % 64));
+        if (word == 0)
+            summary[rank / 4096] &= ~(std::uint64_t{ 1 } << (rank / 64 % 64));
+    } // clearBit()
+
+    // Description: The lowest rank at or after from whose bucket is
+    //              nonempty. There must be one.
+    // Runtime: O(1) plus O(ranks / 4096) to skip summary words
+    std::size_t firstRank(std::size_t from) const {
+        std::size_t word = from / 64;
+        if (word < bits.size()) {
+            std::uint64_t rest = bits[word] & (~std::uint64_t{ 0 } << (from % 64));
+            if (rest != 0)
+                return word * 64 + lowestBit(rest);
+        }
+        // Nothing left in from's word: look for the next nonzero word.
+        ++word;
+        std::size_t group = word / 64;
+        std::uint64_t rest = summary[group] & (~std::uint64_t{ 0 } << (word % 64));
+        while (rest == 0)
+            rest = summary[++group];
+        word = group * 64 + lowestBit(rest);
+        return word * 64 + lowestBit(bits[word]);
+    } // firstRank()
+}; // BucketPQ
+
+
+#endif // BUCKETPQ_H
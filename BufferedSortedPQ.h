@@ -0,0 +1,194 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef BUFFEREDSORTEDPQ_H
+#define BUFFEREDSORTEDPQ_H
+
+#include "Eecs281PQ.h"
+#include "SortedPQ.h"
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+// A SortedPQ with a push buffer in front of it. push() and emplace() append
+// to the buffer and only track its most extreme element, so they cost O(1)
+// instead of the O(n) moves of a sorted insert. The buffer is merged into
+// the sorted array with SortedPQ::push_batch() when its most extreme
+// element is about to be popped, or when flush() is called, so a burst of
+// k pushes costs one O(k log(k) + n) merge.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class BufferedSortedPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit BufferedSortedPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp }, sorted{ comp } {
+    } // BufferedSortedPQ
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n log n) where n is number of elements in range.
+    template<typename InputIterator>
+    BufferedSortedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp }, sorted{ start, end, comp } {
+    } // BufferedSortedPQ
+
+
+    // Description: Destructor doesn't need any code, the members clean up
+    //              after themselves.
+    virtual ~BufferedSortedPQ() {
+    } // ~BufferedSortedPQ()
+
+
+    // Description: Add a new element to the buffer.
+    // Runtime: O(1) amortized
+    virtual void push(const TYPE &val) {
+        addPending(val);
+    } // push()
+
+
+    // Description: Add a new element to the buffer, moving from val.
+    // Runtime: O(1) amortized
+    virtual void push(TYPE &&val) {
+        addPending(std::move(val));
+    } // push()
+
+
+    // Description: Add a new element to the buffer, constructed from args.
+    // Runtime: O(1) amortized
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        addPending(TYPE(std::forward<Args>(args)...));
+    } // emplace()
+
+
+    // Description: Add the elements of [first, last) straight to the sorted
+    //              array in one merge; the buffer is left alone.
+    // Runtime: O(k log(k) + n + k) for k new elements
+    template<typename InputIterator>
+    void push_batch(InputIterator first, InputIterator last) {
+        sorted.push_batch(first, last);
+    } // push_batch()
+
+
+    // Description: Moves every element of other into this PQ and leaves
+    //              other empty. other's buffer is merged into its sorted
+    //              array first, which is then merged with this PQ's in one
+    //              pass; this PQ's buffer stays as it is. other must order
+    //              elements the same way as this PQ.
+    // Runtime: O(n + m) for m elements in other, plus other's flush
+    void merge(BufferedSortedPQ &&other) {
+        if (&other == this)
+            return;
+        other.flush();
+        sorted.merge(std::move(other.sorted));
+    } // merge()
+
+
+    // Description: Merges the buffer into the sorted array.
+    // Runtime: O(k log(k) + n + k) for k buffered elements
+    void flush() {
+        if (pending.empty())
+            return;
+        sorted.push_batch(std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.end()));
+        pending.clear();
+    } // flush()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the PQ.
+    // Runtime: Amortized O(1), plus a merge when the top is in the buffer
+    virtual void pop() {
+        if (pendingOnTop())
+            flush();
+        sorted.pop();
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the PQ and return it by value (moved, not copied).
+    // Runtime: Amortized O(1), plus a merge when the top is in the buffer
+    virtual TYPE pop_top() {
+        if (pendingOnTop())
+            flush();
+        return sorted.pop_top();
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ, from the sorted array or the buffer.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return pendingOnTop() ? pending[pendingTop] : sorted.top();
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return sorted.size() + pending.size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return sorted.empty() && pending.empty();
+    } // empty()
+
+
+    // Description: Assumes that all elements inside the PQ are out of order and
+    //              'rebuilds' the PQ by fixing the PQ invariant. The sorted
+    //              array is re-sorted first, so that the buffer, which is
+    //              sorted on its own when it is merged, meets a valid order.
+    // Runtime: O(n log n)
+    virtual void updatePriorities() {
+        sorted.updatePriorities();
+        flush();
+    } // updatePriorities()
+
+
+    // Description: Re-sorts the PQ after the elements in 'changed' were
+    //              modified in place. The sorted array fixes itself with
+    //              SortedPQ::notifyChanged(); the buffer is unordered, so
+    //              only its most extreme element has to be found again.
+    // Runtime: O(n log(k) + b) for k changed elements and b buffered ones
+    virtual void notifyChanged(const std::vector<TYPE> &changed) {
+        sorted.notifyChanged(changed);
+        pendingTop = 0;
+        for (std::size_t i = 1; i < pending.size(); ++i)
+            if (this->compare(pending[pendingTop], pending[i]))
+                pendingTop = i;
+    } // notifyChanged()
+
+
+private:
+    // The elements that have been merged, and the pushes waiting to be, with
+    // the index of the most extreme of them.
+    SortedPQ<TYPE, COMP_FUNCTOR> sorted;
+    std::vector<TYPE> pending;
+    std::size_t pendingTop = 0;
+
+    // Description: True if the most extreme element is in the buffer.
+    // Runtime: O(1)
+    bool pendingOnTop() const {
+        return !pending.empty() && (sorted.empty() || this->compare(sorted.top(), pending[pendingTop]));
+    } // pendingOnTop()
+
+    // Description: Appends val to the buffer.
+    // Runtime: O(1) amortized
+    template<typename T>
+    void addPending(T &&val) {
+        pending.push_back(std::forward<T>(val));
+        if (pending.size() == 1 || this->compare(pending[pendingTop], pending.back()))
+            pendingTop = pending.size() - 1;
+    } // addPending()
+
+}; // BufferedSortedPQ
+
+#endif // BUFFEREDSORTEDPQ_H
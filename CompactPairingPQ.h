@@ -0,0 +1,419 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef COMPACTPAIRINGPQ_H
+#define COMPACTPAIRINGPQ_H
+
+#include "Eecs281PQ.h"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A pairing heap like PairingPQ, but without pointers: all nodes live in one
+// vector and link to each other with 32-bit indices. A node costs 12 bytes
+// of links instead of PairingPQ's 24 bytes plus allocator overhead, nodes
+// that were added together sit next to each other in memory, and the whole
+// heap can be copied, or written to a flat buffer, as one block.
+//
+// Handles returned by addNode() are node indices. They stay valid until the
+// node is popped; after that the index may be handed out again. The heap
+// holds at most 2^32 - 2 elements.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class CompactPairingPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Stable ID of an element, returned by addNode().
+    using Handle = std::uint32_t;
+
+
+    // Description: Construct an empty pairing heap with an optional
+    //              comparison functor.
+    // Runtime: O(1)
+    explicit CompactPairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+    } // CompactPairingPQ()
+
+
+    // Description: Construct a pairing heap out of an iterator range with an
+    //              optional comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    CompactPairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+        while (start != end) {
+            push(*start);
+            ++start;
+        }
+    } // CompactPairingPQ()
+
+
+    // The compiler-generated copy constructor, assignment operator and
+    // destructor copy or free the node vector as a whole.
+
+
+    // Description: Assumes that all elements inside the pairing heap are out
+    //              of order and 'rebuilds' it. Nodes keep their indices, so
+    //              handles stay valid. The scan over the node vector is
+    //              sequential.
+    // Runtime: O(n + number of free slots)
+    virtual void updatePriorities() {
+        root = NIL;
+        for (Handle i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].prev == FREE)
+                continue;
+            nodes[i].child = nodes[i].sibling = nodes[i].prev = NIL;
+            root = (root == NIL) ? i : meld(root, i);
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the pairing heap.
+    // Runtime: O(1) amortized
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Add a new element to the pairing heap, moving from val.
+    // Runtime: O(1) amortized
+    virtual void push(TYPE &&val) {
+        addNode(std::move(val));
+    } // push()
+
+
+    // Description: Add a new element to the pairing heap, constructed from
+    //              args (in place when no freed slot can be reused).
+    // Runtime: O(1) amortized
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        if (freeList == NIL) {
+            nodes.emplace_back(std::forward<Args>(args)...);
+            linkNode(static_cast<Handle>(nodes.size() - 1));
+        }
+        else {
+            addNode(TYPE(std::forward<Args>(args)...));
+        }
+    } // emplace()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the pairing heap. The children of the root are
+    //              combined with the two-pass rule: meld them in pairs left
+    //              to right, then meld the pairs right to left. Both passes
+    //              relink the sibling list in place.
+    // Runtime: Amortized O(log(n))
+    virtual void pop() {
+        Handle old = root;
+        root = combine(nodes[old].child);
+        release(old);
+        // An empty heap has no live handles, so its storage can go.
+        if (numN == 0) {
+            nodes.clear();
+            freeList = NIL;
+        }
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the pairing heap and return it by value.
+    // Runtime: Amortized O(log(n))
+    virtual TYPE pop_top() {
+        TYPE result = std::move(nodes[root].elt);
+        pop();
+        return result;
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the pairing heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return nodes[root].elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the pairing heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return numN;
+    } // size()
+
+
+    // Description: Return true if the pairing heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return numN == 0;
+    } // empty()
+
+
+    // Description: Return the element with the given handle.
+    // Runtime: O(1)
+    const TYPE &getElt(Handle node) const {
+        return nodes[node].elt;
+    } // getElt()
+
+
+    // Description: Updates the priority of an element already in the pairing
+    //              heap. The new value must be at least as extreme as the
+    //              old one.
+    // Runtime: O(1) amortized
+    void updateElt(Handle node, const TYPE &new_value) {
+        updateElt(node, TYPE(new_value));
+    } // updateElt()
+
+
+    // Description: Same as above, but moves new_value into the node.
+    // Runtime: O(1) amortized
+    void updateElt(Handle node, TYPE &&new_value) {
+        nodes[node].elt = std::move(new_value);
+        if (node == root)
+            return;
+        // A leftmost child's prev is its parent; if the parent still wins
+        // the heap is in order and nothing moves.
+        Handle prev = nodes[node].prev;
+        if (nodes[prev].child == node && !this->compare(nodes[prev].elt, nodes[node].elt))
+            return;
+        cut(node);
+        root = meld(root, node);
+    } // updateElt()
+
+
+    // Description: Add a new element to the pairing heap and return its
+    //              handle. Freed slots are reused before the vector grows.
+    // Runtime: O(1) amortized
+    Handle addNode(const TYPE &val) {
+        return addNode(TYPE(val));
+    } // addNode()
+
+
+    // Description: Same as above, but moves val into the node.
+    // Runtime: O(1) amortized
+    Handle addNode(TYPE &&val) {
+        Handle node;
+        if (freeList == NIL) {
+            nodes.emplace_back(std::move(val));
+            node = static_cast<Handle>(nodes.size() - 1);
+        }
+        else {
+            node = freeList;
+            freeList = nodes[node].sibling;
+            nodes[node].elt = std::move(val);
+            nodes[node].prev = NIL;
+            nodes[node].sibling = NIL;
+        }
+        return linkNode(node);
+    } // addNode()
+
+
+    // Description: Writes the heap to a flat byte buffer that deserialize()
+    //              can load, on a machine with the same TYPE layout. Only
+    //              available for trivially copyable TYPEs.
+    // Runtime: O(n + number of free slots)
+    std::vector<unsigned char> serialize() const {
+        static_assert(std::is_trivially_copyable<TYPE>::value, "serialize() copies elements bytewise");
+        Header header{ static_cast<std::uint64_t>(nodes.size()), static_cast<std::uint64_t>(numN), root, freeList };
+        std::vector<unsigned char> buffer(sizeof(Header) + nodes.size() * sizeof(Slot));
+        std::memcpy(buffer.data(), &header, sizeof(Header));
+        if (!nodes.empty())
+            std::memcpy(buffer.data() + sizeof(Header), nodes.data(), nodes.size() * sizeof(Slot));
+        return buffer;
+    } // serialize()
+
+
+    // Description: Replaces the contents of the heap with a buffer written
+    //              by serialize(). Handles are preserved. The comparison
+    //              functor of this heap must order the elements the same way
+    //              as the one that wrote the buffer. Throws
+    //              std::invalid_argument, leaving the heap unchanged, if the
+    //              buffer is truncated, its free list or tree links are
+    //              inconsistent, or the tree does not hold exactly 'size'
+    //              live slots.
+    // Runtime: O(n + number of free slots)
+    void deserialize(const std::vector<unsigned char> &buffer) {
+        static_assert(std::is_trivially_copyable<TYPE>::value, "deserialize() copies elements bytewise");
+        Header header;
+        if (buffer.size() < sizeof(Header))
+            throw std::invalid_argument("CompactPairingPQ: buffer too short for a header");
+        std::memcpy(&header, buffer.data(), sizeof(Header));
+        const std::size_t bytes = buffer.size() - sizeof(Header);
+        if (header.slots > bytes / sizeof(Slot) || bytes != header.slots * sizeof(Slot) || header.slots > NIL)
+            throw std::invalid_argument("CompactPairingPQ: buffer size does not match its slot count");
+        const Handle slots = static_cast<Handle>(header.slots);
+        auto valid = [slots](Handle link) { return link == NIL || link < slots; };
+        if (!valid(header.root) || !valid(header.freeList) || header.size > slots
+            || (header.size == 0) != (header.root == NIL))
+            throw std::invalid_argument("CompactPairingPQ: header out of range");
+
+        std::vector<Slot> loaded(slots);
+        if (slots != 0)
+            std::memcpy(static_cast<void *>(loaded.data()), buffer.data() + sizeof(Header), bytes);
+        // The free list must hold exactly the slots not in use, and every
+        // link must stay inside the array.
+        std::size_t free = 0;
+        for (Handle slot = header.freeList; slot != NIL; slot = loaded[slot].sibling) {
+            if (++free > slots || loaded[slot].prev != FREE || !valid(loaded[slot].sibling))
+                throw std::invalid_argument("CompactPairingPQ: corrupt free list");
+        }
+        if (free + header.size != slots)
+            throw std::invalid_argument("CompactPairingPQ: size does not match the free list");
+        // Walking the tree from the root must reach every live slot exactly
+        // once, and each child or sibling must point back with its prev.
+        // Free slots have prev FREE, so they are never reached, and a cycle
+        // would reach some slot twice.
+        std::size_t reached = 0;
+        if (header.root != NIL) {
+            std::vector<bool> seen(slots);
+            std::vector<Handle> stack { header.root };
+            if (loaded[header.root].prev != NIL || loaded[header.root].sibling != NIL)
+                throw std::invalid_argument("CompactPairingPQ: root has a parent or siblings");
+            while (!stack.empty()) {
+                const Handle node = stack.back();
+                stack.pop_back();
+                if (seen[node])
+                    throw std::invalid_argument("CompactPairingPQ: slot reached twice");
+                seen[node] = true;
+                ++reached;
+                for (Handle link : { loaded[node].child, loaded[node].sibling }) {
+                    if (link == NIL)
+                        continue;
+                    if (!valid(link) || loaded[link].prev != node)
+                        throw std::invalid_argument("CompactPairingPQ: inconsistent link");
+                    stack.push_back(link);
+                }
+            }
+        }
+        if (reached != header.size)
+            throw std::invalid_argument("CompactPairingPQ: size does not match the tree");
+
+        nodes.swap(loaded);
+        numN = static_cast<std::size_t>(header.size);
+        root = header.root;
+        freeList = header.freeList;
+    } // deserialize()
+
+
+private:
+    static constexpr Handle NIL = UINT32_MAX;
+    // Marks a slot on the free list (stored in prev).
+    static constexpr Handle FREE = UINT32_MAX - 1;
+
+    // prev is the parent for a leftmost child and the left sibling
+    // otherwise, so a node can be cut out in O(1).
+    struct Slot {
+        TYPE elt;
+        Handle child = NIL;
+        Handle sibling = NIL;
+        Handle prev = NIL;
+
+        template<typename... Args>
+        explicit Slot(Args &&...args) : elt(std::forward<Args>(args)...) {}
+    };
+
+    struct Header {
+        std::uint64_t slots;
+        std::uint64_t size;
+        Handle root;
+        Handle freeList;
+    };
+
+    std::vector<Slot> nodes;
+    Handle root = NIL;
+    // Free slots are chained through their sibling index.
+    Handle freeList = NIL;
+    std::size_t numN = 0;
+
+    // Description: Melds a new, unlinked node into the heap.
+    // Runtime: O(1)
+    Handle linkNode(Handle node) {
+        root = (root == NIL) ? node : meld(root, node);
+        ++numN;
+        return node;
+    } // linkNode()
+
+    // Description: Melds two root nodes, whose sibling and prev must be NIL,
+    //              and returns the winner.
+    // Runtime: O(1)
+    Handle meld(Handle a, Handle b) {
+        if (this->compare(nodes[a].elt, nodes[b].elt))
+            std::swap(a, b);
+        // a wins; b becomes its leftmost child.
+        Handle first = nodes[a].child;
+        nodes[b].sibling = first;
+        if (first != NIL)
+            nodes[first].prev = b;
+        nodes[b].prev = a;
+        nodes[a].child = b;
+        return a;
+    } // meld()
+
+    // Description: Unlinks node, with its subtree, from its parent's child
+    //              list.
+    // Runtime: O(1)
+    void cut(Handle node) {
+        Handle prev = nodes[node].prev;
+        Handle next = nodes[node].sibling;
+        if (nodes[prev].child == node)
+            nodes[prev].child = next;
+        else
+            nodes[prev].sibling = next;
+        if (next != NIL)
+            nodes[next].prev = prev;
+        nodes[node].prev = nodes[node].sibling = NIL;
+    } // cut()
+
+    // Description: Two-pass pairing of the sibling list starting at first.
+    //              Returns the new root, or NIL for an empty list.
+    // Runtime: O(length of the list)
+    Handle combine(Handle first) {
+        if (first == NIL)
+            return NIL;
+
+        // First pass: meld pairs left to right. The results are chained
+        // through sibling in reverse order, ready for the second pass.
+        Handle pairs = NIL;
+        while (first != NIL) {
+            Handle a = first;
+            Handle b = nodes[a].sibling;
+            if (b == NIL) {
+                first = NIL;
+            }
+            else {
+                first = nodes[b].sibling;
+                nodes[b].sibling = nodes[b].prev = NIL;
+            }
+            nodes[a].sibling = nodes[a].prev = NIL;
+            Handle winner = (b == NIL) ? a : meld(a, b);
+            nodes[winner].sibling = pairs;
+            pairs = winner;
+        }
+
+        // Second pass: meld the pairs right to left into one tree.
+        Handle result = pairs;
+        pairs = nodes[pairs].sibling;
+        nodes[result].sibling = NIL;
+        while (pairs != NIL) {
+            Handle next = nodes[pairs].sibling;
+            nodes[pairs].sibling = NIL;
+            result = meld(result, pairs);
+            pairs = next;
+        }
+        return result;
+    } // combine()
+
+    // Description: Puts a popped node's slot on the free list.
+    // Runtime: O(1)
+    void release(Handle node) {
+        nodes[node].child = NIL;
+        nodes[node].prev = FREE;
+        nodes[node].sibling = freeList;
+        freeList = node;
+        --numN;
+    } // release()
+}; // CompactPairingPQ
+
+
+#endif // COMPACTPAIRINGPQ_H
@@ -0,0 +1,307 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef DARYPQ_H
+#define DARYPQ_H
+
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include "Eecs281PQ.h"
+
+
+// Allocator for the heap array of DaryPQ. It places element 1 (the first
+// child of the root) at the start of a cache line. Since the children of
+// node i are elements ARITY * i + 1 .. ARITY * i + ARITY, every group of
+// siblings then starts at a multiple of ARITY * sizeof(TYPE) bytes past a
+// cache line boundary: with 8 ints, 4 doubles or 4 16-byte structs a
+// group is exactly one cache line, and smaller groups never straddle two.
+template<typename TYPE>
+class DaryAllocator {
+    static_assert(alignof(TYPE) <= 64, "over-aligned types are not supported");
+
+public:
+    using value_type = TYPE;
+
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    DaryAllocator() = default;
+    template<typename OTHER>
+    DaryAllocator(const DaryAllocator<OTHER> &) {}
+
+    TYPE *allocate(std::size_t n) {
+        char *block = static_cast<char *>(
+            ::operator new(n * sizeof(TYPE) + CACHE_LINE, std::align_val_t{ CACHE_LINE }));
+        return reinterpret_cast<TYPE *>(block + offset());
+    } // allocate()
+
+    void deallocate(TYPE *ptr, std::size_t) {
+        ::operator delete(reinterpret_cast<char *>(ptr) - offset(), std::align_val_t{ CACHE_LINE });
+    } // deallocate()
+
+    template<typename OTHER>
+    bool operator==(const DaryAllocator<OTHER> &) const { return true; }
+    template<typename OTHER>
+    bool operator!=(const DaryAllocator<OTHER> &) const { return false; }
+
+private:
+    // Bytes between the aligned block and element 0, chosen so that
+    // element 1 is cache line aligned. Always a multiple of alignof(TYPE).
+    static constexpr std::size_t offset() {
+        return (CACHE_LINE - sizeof(TYPE) % CACHE_LINE) % CACHE_LINE;
+    } // offset()
+}; // DaryAllocator
+
+
+// A specialized version of the priority queue ADT implemented as a d-ary
+// heap: every node has up to ARITY children. Compared to BinaryPQ, a wider
+// heap is log2(ARITY) times shallower, so fixDown() and pop() touch fewer
+// cache lines in large heaps, at the price of ARITY - 1 comparisons per
+// level instead of 1. ARITY 4 or 8 is usually the sweet spot; benchPQ runs
+// both as Dary4 and Dary8.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, std::size_t ARITY = 4>
+class DaryPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    static_assert(ARITY >= 2, "a d-ary heap needs at least two children per node");
+
+public:
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit DaryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+    } // DaryPQ
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    DaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp }, data(start, end) {
+        updatePriorities();
+    } // DaryPQ
+
+
+    // Description: Destructor doesn't need any code, the data vector will
+    //              be destroyed automatically.
+    virtual ~DaryPQ() {
+    } // ~DaryPQ()
+
+
+    // Description: Assumes that all elements inside the heap are out of order and
+    //              'rebuilds' the heap by fixing the heap invariant, bottom-up
+    //              from the last node that has a child.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        if (size() < 2)
+            return;
+        for (std::size_t i = parent(size() - 1) + 1; i > 0; i--) {
+            fixDown(i - 1);
+        }
+    } // updatePriorities()
+
+
+    // Description: Repairs the heap after the elements in 'changed' were
+    //              modified in place, sifting only their positions and
+    //              ancestors (see BinaryPQ::notifyChanged()). Rebuilds the
+    //              whole heap when many elements changed or TYPE cannot be
+    //              searched.
+    // Runtime: O(n log(k) + k ARITY log^2(n) / log^2(ARITY)) for k changed
+    //          elements
+    virtual void notifyChanged(const std::vector<TYPE> &changed) {
+        if constexpr (ChangedSet<TYPE>::SEARCHABLE) {
+            if (!BaseClass::rebuildCheaper(changed.size(), size())) {
+                ChangedSet<TYPE> dirty{ changed };
+                std::vector<std::size_t> positions;
+                for (std::size_t i = 0; i < size(); ++i) {
+                    if (dirty.contains(data[i]))
+                        positions.push_back(i);
+                }
+                repair(positions);
+                return;
+            }
+        }
+        BaseClass::notifyChanged(changed);
+    } // notifyChanged()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: O(log(n) / log(ARITY))
+    virtual void push(const TYPE &val) {
+        data.push_back(val);
+        fixUp(size() - 1);
+    } // push()
+
+
+    // Description: Add a new element to the PQ, moving from val.
+    // Runtime: O(log(n) / log(ARITY))
+    virtual void push(TYPE &&val) {
+        data.push_back(std::move(val));
+        fixUp(size() - 1);
+    } // push()
+
+
+    // Description: Construct a new element in place at the end of the heap
+    //              and sift it up.
+    // Runtime: O(log(n) / log(ARITY))
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        data.emplace_back(std::forward<Args>(args)...);
+        fixUp(size() - 1);
+    } // emplace()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: O(ARITY * log(n) / log(ARITY))
+    virtual void pop() {
+        if (size() == 1) {
+            data.pop_back();
+            return;
+        }
+        TYPE last = std::move(data.back());
+        data.pop_back();
+        fillRoot(std::move(last));
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value (moved, not copied).
+    // Runtime: O(ARITY * log(n) / log(ARITY))
+    virtual TYPE pop_top() {
+        TYPE result = std::move(data.front());
+        pop();
+        return result;
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return data.front();
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return data.size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return data.empty();
+    } // empty()
+
+
+private:
+    // The heap is stored 0-based: the children of node i are
+    // ARITY * i + 1 .. ARITY * i + ARITY, so siblings are contiguous.
+    std::vector<TYPE, DaryAllocator<TYPE>> data;
+
+    static std::size_t parent(std::size_t i) {
+        return (i - 1) / ARITY;
+    } // parent()
+
+    static std::size_t firstChild(std::size_t i) {
+        return ARITY * i + 1;
+    } // firstChild()
+
+    // Description: Index of the most extreme child of node i, which must
+    //              have at least one child.
+    // Runtime: O(ARITY)
+    std::size_t extremeChild(std::size_t i) const {
+        std::size_t first = firstChild(i);
+        std::size_t last = std::min(first + ARITY, size());
+        std::size_t best = first;
+        for (std::size_t j = first + 1; j < last; ++j) {
+            if (this->compare(data[best], data[j]))
+                best = j;
+        }
+        return best;
+    } // extremeChild()
+
+    // Like BinaryPQ, the sift routines move a hole through the heap instead
+    // of swapping.
+
+    // Description: Moves the element at index i up until its parent is
+    //              not less extreme.
+    // Runtime: O(log(n) / log(ARITY))
+    void fixUp(std::size_t i) {
+        if (i == 0 || !this->compare(data[parent(i)], data[i]))
+            return;
+
+        TYPE value = std::move(data[i]);
+        do {
+            data[i] = std::move(data[parent(i)]);
+            i = parent(i);
+        } while (i > 0 && this->compare(data[parent(i)], value));
+        data[i] = std::move(value);
+    } // fixUp()
+
+    // Description: Moves the element at index i down until none of its
+    //              children is more extreme.
+    // Runtime: O(ARITY * log(n) / log(ARITY))
+    void fixDown(std::size_t i) {
+        if (firstChild(i) >= size())
+            return;
+
+        TYPE value = std::move(data[i]);
+        while (firstChild(i) < size()) {
+            std::size_t j = extremeChild(i);
+            if (!this->compare(value, data[j]))
+                break;
+            data[i] = std::move(data[j]);
+            i = j;
+        }
+        data[i] = std::move(value);
+    } // fixDown()
+
+    // Description: Restores the heap when only the elements at the given
+    //              positions may be out of order, by running fixDown() on
+    //              them and their ancestors, deepest first (see
+    //              BinaryPQ::repair()).
+    // Runtime: O(k ARITY log^2(n) / log^2(ARITY)) for k positions
+    void repair(const std::vector<std::size_t> &positions) {
+        std::vector<std::size_t> nodes;
+        for (std::size_t i : positions) {
+            nodes.push_back(i);
+            while (i > 0) {
+                i = parent(i);
+                nodes.push_back(i);
+            }
+        }
+        std::sort(nodes.begin(), nodes.end(), std::greater<std::size_t>());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+        for (std::size_t i : nodes)
+            fixDown(i);
+    } // repair()
+
+    // Description: Fills the root, whose element has just been removed, with
+    //              value: the hole goes down to a leaf through the most
+    //              extreme children, then value is sifted up from there
+    //              (Floyd's bottom-up deletion, as in BinaryPQ).
+    // Runtime: O(ARITY * log(n) / log(ARITY))
+    void fillRoot(TYPE &&value) {
+        std::size_t i = 0;
+        while (firstChild(i) < size()) {
+            std::size_t j = extremeChild(i);
+            data[i] = std::move(data[j]);
+            i = j;
+        }
+
+        while (i > 0 && this->compare(data[parent(i)], value)) {
+            data[i] = std::move(data[parent(i)]);
+            i = parent(i);
+        }
+        data[i] = std::move(value);
+    } // fillRoot()
+}; // DaryPQ
+
+
+#endif // DARYPQ_H
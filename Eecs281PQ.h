@@ -3,20 +3,46 @@
 #ifndef EECS281_PQ_H
 #define EECS281_PQ_H
 
+#include <algorithm>
 #include <functional>
 #include <iterator>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // A simple interface that implements a generic priority queue.
 // Runtime specifications assume constant time comparison and copying.
+//
+// Every concrete priority queue is declared final. Calls made through
+// an Eecs281PQ & go through the vtable as usual, but calls made through the
+// concrete type (a BinaryPQ<int> &, or a template parameter deduced as one)
+// are bound statically, so the compiler can inline the member function and
+// the comparator. Generic code that wants the static path should be written
+// as a template over the queue type; see IsStaticPQ below.
 template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
 class Eecs281PQ {
 public:
+    using value_type = TYPE;
+    using value_compare = COMP_FUNCTOR;
+
     virtual ~Eecs281PQ() {}
 
     // Description: Add a new element to the priority queue.
     virtual void push(const TYPE &val) = 0;
 
+    // Description: Add a new element to the priority queue, moving from val
+    //              instead of copying it.
+    virtual void push(TYPE &&val) = 0;
+
+    // Description: Add a new element to the priority queue, constructed
+    //              from args. Derived queues hide this with a version that
+    //              constructs the element in place where they can; through
+    //              an Eecs281PQ & it constructs a temporary and moves it in.
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        push(TYPE(std::forward<Args>(args)...));
+    } // emplace()
+
     // Description: Remove the most extreme (defined by 'compare') element
     //              from the priority queue.
     // Note: We will not run tests on your code that would require it to pop
@@ -25,6 +51,12 @@ public:
     // this project.
     virtual void pop() = 0;
 
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the priority queue and return it. The element is
+    //              moved out, so this is cheaper than copying top() and then
+    //              calling pop().
+    virtual TYPE pop_top() = 0;
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the priority queue.
     virtual const TYPE &top() const = 0;
@@ -41,10 +73,33 @@ public:
     //              implement this appropriately.
     virtual void updatePriorities() = 0;
 
+    // Description: Tells the priority queue that only the elements in
+    //              'changed', which are already in it, may be out of order,
+    //              e.g. pointers whose pointees were modified. Queues that
+    //              can find those elements (see ChangedSet below) repair
+    //              just their positions, and fall back to
+    //              updatePriorities() when more than one element in
+    //              NOTIFY_REBUILD_RATIO changed. The default always does.
+    virtual void notifyChanged(const std::vector<TYPE> &changed) {
+        if (!changed.empty())
+            updatePriorities();
+    } // notifyChanged()
+
 protected:
     Eecs281PQ() {}
     explicit Eecs281PQ(const COMP_FUNCTOR &comp) : compare{ comp } {}
 
+    // Past this fraction of changed elements, a targeted repair does about
+    // as much work as rebuilding, and touches memory less sequentially.
+    static constexpr std::size_t NOTIFY_REBUILD_RATIO = 16;
+
+    // Description: True if notifyChanged() should rebuild a queue of n
+    //              elements of which 'changed' were reported.
+    // Runtime: O(1)
+    static bool rebuildCheaper(std::size_t changed, std::size_t n) {
+        return changed > n / NOTIFY_REBUILD_RATIO;
+    } // rebuildCheaper()
+
     // Note: These data members *must* be used in all of your priority queue
     //       implementations.
 
@@ -56,4 +111,73 @@ protected:
 }; // Eecs281PQ
 
 
+// Description: Compile-time check that PQ provides the priority queue
+//              operations with static dispatch, i.e. it is a final class
+//              with push, pop, top, size, empty and updatePriorities.
+//              Use as static_assert(IsStaticPQ<PQ>::value, "...") in
+//              templates that rely on the comparator being inlined.
+template<typename PQ, typename = void>
+struct IsStaticPQ : std::false_type {};
+
+template<typename PQ>
+struct IsStaticPQ<PQ, std::void_t<
+        typename PQ::value_type,
+        decltype(std::declval<PQ &>().push(std::declval<const typename PQ::value_type &>())),
+        decltype(std::declval<PQ &>().pop()),
+        decltype(std::declval<const PQ &>().top()),
+        decltype(std::declval<const PQ &>().size()),
+        decltype(std::declval<const PQ &>().empty()),
+        decltype(std::declval<PQ &>().updatePriorities())>> :
+    std::bool_constant<std::is_final<PQ>::value> {};
+
+
+// The elements passed to notifyChanged(), sorted with std::less<TYPE> so a
+// queue can check each of its own elements against them in O(log(k)).
+// std::less only orders the elements themselves: for pointers it compares
+// addresses and never reads the pointees, which are the values that
+// changed. An element that is merely equivalent to a changed one is
+// repaired too, which is harmless. Only usable when TYPE has operator<;
+// queues test SEARCHABLE and rebuild otherwise.
+template<typename TYPE, typename = void>
+struct ChangedSet {
+    static constexpr bool SEARCHABLE = false;
+};
+
+template<typename TYPE>
+struct ChangedSet<TYPE, std::void_t<decltype(std::declval<const TYPE &>() < std::declval<const TYPE &>())>> {
+    static constexpr bool SEARCHABLE = true;
+
+    explicit ChangedSet(const std::vector<TYPE> &changed) : sorted{ changed } {
+        std::sort(sorted.begin(), sorted.end(), std::less<TYPE>{});
+    } // ChangedSet()
+
+    // Description: True if val is (equivalent to) a changed element. Queues
+    //              call this once for each of their elements, nearly always
+    //              with a miss, so the search halves the range without
+    //              branching on the comparisons, which would be
+    //              mispredicted about once per step.
+    // Runtime: O(log(k))
+    bool contains(const TYPE &val) const {
+        std::less<TYPE> less;
+        if (sorted.empty())
+            return false;
+        const TYPE *base = sorted.data();
+        std::size_t n = sorted.size();
+        while (n > 1) {
+            std::size_t half = n / 2;
+            base = less(base[half], val) ? base + half : base;
+            n -= half;
+        }
+        // The lower bound is base or the element after it; past the end,
+        // the last element stands in for it and cannot match.
+        std::size_t i = std::min(static_cast<std::size_t>(base - sorted.data()) + less(*base, val),
+                                 sorted.size() - 1);
+        return !less(sorted[i], val) & !less(val, sorted[i]);
+    } // contains()
+
+private:
+    std::vector<TYPE> sorted;
+}; // ChangedSet
+
+
 #endif
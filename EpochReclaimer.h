@@ -0,0 +1,205 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef EPOCHRECLAIMER_H
+#define EPOCHRECLAIMER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Epoch-based memory reclamation (Fraser, "Practical lock-freedom", 2004)
+// for the lock-free queues. A thread pins itself with a Guard before it
+// reads shared nodes and unpins when the Guard goes away. A node that has
+// been unlinked is handed to retire() instead of being deleted: it is only
+// freed once every thread that was pinned at the time has unpinned, so no
+// thread can still be reading it.
+//
+// There is one global epoch. Pinning announces the epoch the thread saw;
+// the epoch only advances when every pinned thread has announced the
+// current one. A node retired in epoch e is therefore safe to free once the
+// epoch reaches e + 2. Each thread keeps its retired nodes in three buckets,
+// one per epoch modulo 3, and empties a bucket when it comes round again.
+//
+// The state is shared by the whole process, so a queue does not have to
+// outlive the threads that used it. A thread that exits leaves its bucket
+// record to the next thread that starts; whatever is still retired at
+// program exit is freed then.
+class EpochReclaimer {
+    struct Record;
+
+public:
+    // Pins the calling thread for its lifetime. Guards may nest.
+    class Guard {
+    public:
+        Guard() : record{ EpochReclaimer::local() } {
+            EpochReclaimer::pin(record);
+        } // Guard()
+
+        ~Guard() {
+            EpochReclaimer::unpin(record);
+        } // ~Guard()
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+    private:
+        Record &record;
+    }; // Guard
+
+
+    // Description: Frees ptr with deleter once no thread can be reading it.
+    //              ptr must already be unreachable for threads that pin
+    //              from now on.
+    // Runtime: O(1) amortized; every RETIRE_BATCH calls, O(threads) plus
+    //          the cost of the deleters that run.
+    static void retire(void *ptr, void (*deleter)(void *)) {
+        Record &record = local();
+        const std::uint64_t epoch = state().epoch.load();
+        Bucket &bucket = record.limbo[epoch % 3];
+        if (bucket.epoch != epoch) {
+            // The bucket was last used three or more epochs ago.
+            release(bucket);
+            bucket.epoch = epoch;
+        }
+        bucket.retired.push_back({ ptr, deleter });
+        if (++record.sinceAdvance >= RETIRE_BATCH) {
+            record.sinceAdvance = 0;
+            tryAdvance();
+            collect(record);
+        }
+    } // retire()
+
+
+private:
+    // Retirements between two attempts to advance the epoch.
+    static constexpr std::size_t RETIRE_BATCH = 64;
+
+    struct Retired {
+        void *ptr;
+        void (*deleter)(void *);
+    };
+
+    struct Bucket {
+        std::uint64_t epoch = 0;
+        std::vector<Retired> retired;
+    };
+
+    // One per thread that ever pinned; reused after the thread exits.
+    struct Record {
+        // The epoch the thread announced while pinned, 0 while not pinned.
+        std::atomic<std::uint64_t> active{ 0 };
+        std::atomic<bool> owned{ true };
+        Record *next = nullptr;
+        // Only touched by the owning thread.
+        std::size_t nesting = 0;
+        std::size_t sinceAdvance = 0;
+        Bucket limbo[3];
+    };
+
+    struct State {
+        std::atomic<std::uint64_t> epoch{ 1 };
+        std::atomic<Record *> records{ nullptr };
+
+        ~State() {
+            Record *record = records.load();
+            while (record != nullptr) {
+                Record *next = record->next;
+                for (Bucket &bucket : record->limbo)
+                    release(bucket);
+                delete record;
+                record = next;
+            }
+        } // ~State()
+    };
+
+    // Gives the thread's record back when the thread exits.
+    struct Handle {
+        Record *record;
+
+        Handle() : record{ acquire() } {}
+        ~Handle() {
+            record->owned.store(false);
+        }
+    };
+
+    static State &state() {
+        static State s;
+        return s;
+    } // state()
+
+    static Record &local() {
+        thread_local Handle handle;
+        return *handle.record;
+    } // local()
+
+    // Description: Takes over the record of an exited thread, or adds one.
+    // Runtime: O(threads)
+    static Record *acquire() {
+        State &s = state();
+        for (Record *record = s.records.load(); record != nullptr; record = record->next) {
+            bool owned = false;
+            if (!record->owned.load() && record->owned.compare_exchange_strong(owned, true))
+                return record;
+        }
+        Record *record = new Record;
+        Record *head = s.records.load();
+        do {
+            record->next = head;
+        } while (!s.records.compare_exchange_weak(head, record));
+        return record;
+    } // acquire()
+
+    static void pin(Record &record) {
+        if (record.nesting++ > 0)
+            return;
+        // Announce, then check the epoch did not move meanwhile; otherwise
+        // an advance could have missed the announcement.
+        std::uint64_t epoch = state().epoch.load();
+        while (true) {
+            record.active.store(epoch);
+            const std::uint64_t now = state().epoch.load();
+            if (now == epoch)
+                break;
+            epoch = now;
+        }
+    } // pin()
+
+    static void unpin(Record &record) {
+        if (--record.nesting == 0)
+            record.active.store(0);
+    } // unpin()
+
+    // Description: Advances the epoch if every pinned thread has seen it.
+    // Runtime: O(threads)
+    static void tryAdvance() {
+        State &s = state();
+        std::uint64_t epoch = s.epoch.load();
+        for (Record *record = s.records.load(); record != nullptr; record = record->next) {
+            const std::uint64_t active = record->active.load();
+            if (active != 0 && active != epoch)
+                return;
+        }
+        s.epoch.compare_exchange_strong(epoch, epoch + 1);
+    } // tryAdvance()
+
+    // Description: Frees the buckets of record that are two epochs old.
+    // Runtime: O(nodes freed)
+    static void collect(Record &record) {
+        const std::uint64_t epoch = state().epoch.load();
+        for (Bucket &bucket : record.limbo) {
+            if (bucket.epoch + 2 <= epoch)
+                release(bucket);
+        }
+    } // collect()
+
+    static void release(Bucket &bucket) {
+        for (const Retired &retired : bucket.retired)
+            retired.deleter(retired.ptr);
+        bucket.retired.clear();
+    } // release()
+}; // EpochReclaimer
+
+
+#endif // EPOCHRECLAIMER_H
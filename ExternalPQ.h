@@ -0,0 +1,501 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef EXTERNALPQ_H
+#define EXTERNALPQ_H
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Eecs281PQ.h"
+
+
+// A specialized version of the priority queue ADT for more elements than
+// fit in memory (an external-memory priority queue). New elements go to an
+// in-memory binary heap, the insertion buffer. When it holds memoryElements
+// elements, it is emptied in order into a sorted run at the end of a spill
+// file, an unlinked temporary file in $TMPDIR (or /tmp, or the directory
+// given to the constructor) that disappears with the PQ. top() and pop()
+// then do a lazy k-way merge of the buffer and the fronts of the runs.
+//
+// The runs are written and read in blocks of blockElements elements,
+// double buffered: while one block is filled from the buffer, the one
+// before it is being written, and while a run is popped from one block,
+// its next block is already being read, each by a std::async task. Apart
+// from the buffer, the PQ holds two blocks per run that is not used up, so
+// blocks should be much smaller than the buffer: with the defaults, 1 GiB
+// of ints spills 4 runs and keeps 8 MiB of blocks. The spill file is
+// truncated whenever every run has been used up.
+//
+// Elements are written to the file as bytes, so TYPE must be trivially
+// copyable (and default constructible, to make room for a block). Pointers
+// can be spilled too, as long as what they point to stays alive. A failed
+// read or write throws std::system_error; a failed spill keeps every
+// element in the buffer.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class ExternalPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(std::is_trivially_copyable<TYPE>::value && std::is_default_constructible<TYPE>::value,
+                  "ExternalPQ writes elements to disk as bytes: TYPE must be trivially copyable");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Default size of the insertion buffer, and of a block of I/O.
+    static constexpr std::size_t DEFAULT_MEMORY_BYTES = std::size_t{ 1 } << 28;
+    static constexpr std::size_t DEFAULT_BLOCK_BYTES = std::size_t{ 1 } << 20;
+
+    // Description: Construct an empty PQ with an optional comparison
+    //              functor, number of elements the insertion buffer holds
+    //              before it is spilled, number of elements per block of
+    //              I/O (0 means DEFAULT_BLOCK_BYTES worth) and directory for
+    //              the spill file (empty means $TMPDIR, or /tmp). The file
+    //              is created at the first spill.
+    // Runtime: O(1)
+    explicit ExternalPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                        std::size_t memoryElements = DEFAULT_MEMORY_BYTES / sizeof(TYPE),
+                        std::size_t blockElements = 0, std::string directory = std::string()) :
+        BaseClass{ comp }, memoryElements{ std::max<std::size_t>(memoryElements, 1) },
+        blockElements{ blockElements != 0 ? blockElements : std::max<std::size_t>(DEFAULT_BLOCK_BYTES / sizeof(TYPE), 1) },
+        directory{ std::move(directory) } {
+    } // ExternalPQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor and the default buffer and blocks.
+    // Runtime: O(n log(n)) where n is number of elements in range.
+    template<typename InputIterator>
+    ExternalPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        ExternalPQ{ comp } {
+        for (; start != end; ++start)
+            push(*start);
+    } // ExternalPQ()
+
+
+    // Description: Copy constructor. The runs that other has not used up
+    //              are copied into a spill file of this PQ's own.
+    // Runtime: O(n), plus reading and writing every spilled element once
+    ExternalPQ(const ExternalPQ &other) :
+        BaseClass{ other.compare }, buffer{ other.buffer }, memoryElements{ other.memoryElements },
+        blockElements{ other.blockElements }, directory{ other.directory } {
+        for (const Run &run : other.runs) {
+            std::size_t first = run.blockStart + run.pos;
+            if (first == run.end)
+                continue;
+            std::vector<TYPE> head;
+            const std::size_t start = fileEnd;
+            std::vector<TYPE> block;
+            while (first < run.end) {
+                block.resize(std::min(blockElements, run.end - first));
+                readBlock(other.fd, block, first);
+                writeBlock(block, fileEnd);
+                fileEnd += block.size();
+                first += block.size();
+                if (head.empty())
+                    head.swap(block);
+            }
+            addRun(std::move(head), start);
+        }
+    } // ExternalPQ()
+
+
+    // The spill file and the reads in flight cannot be handed over, so
+    // there is no assignment.
+    ExternalPQ &operator=(const ExternalPQ &) = delete;
+
+
+    // Description: Waits for the reads in flight, then closes the spill
+    //              file, which the system deletes.
+    virtual ~ExternalPQ() {
+        for (Run &run : runs) {
+            if (run.reading.valid())
+                run.reading.wait();
+        }
+        if (fd >= 0)
+            ::close(fd);
+    } // ~ExternalPQ()
+
+
+    // Description: Assumes that all elements are out of order. The buffer
+    //              is rebuilt, and every spilled element is read back and
+    //              pushed again, so the runs are sorted anew.
+    // Runtime: O(n log(n)), plus reading and writing every spilled element
+    //          once
+    virtual void updatePriorities() {
+        std::make_heap(buffer.begin(), buffer.end(), this->compare);
+        if (runs.empty())
+            return;
+
+        std::vector<Run> old;
+        old.swap(runs);
+        order.clear();
+        spilled = 0;
+        const int oldFd = fd;
+        fd = -1;
+        fileEnd = 0;
+        try {
+            std::vector<TYPE> block;
+            for (Run &run : old) {
+                if (run.reading.valid())
+                    run.reading.wait();
+                for (std::size_t i = run.blockStart + run.pos; i < run.end; i += block.size()) {
+                    block.resize(std::min(blockElements, run.end - i));
+                    readBlock(oldFd, block, i);
+                    for (const TYPE &val : block)
+                        push(val);
+                }
+            }
+        }
+        catch (...) {
+            ::close(oldFd);
+            throw;
+        }
+        ::close(oldFd);
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ, spilling the buffer first
+    //              if it is full.
+    // Runtime: O(log(memoryElements)), plus O(memoryElements
+    //          log(memoryElements)) and the writes of a spill once every
+    //          memoryElements pushes
+    virtual void push(const TYPE &val) {
+        if (buffer.size() >= memoryElements)
+            spill();
+        buffer.push_back(val);
+        std::push_heap(buffer.begin(), buffer.end(), this->compare);
+    } // push()
+
+
+    // Description: Add a new element to the PQ. TYPE is trivially copyable,
+    //              so this is the same as push(const TYPE &).
+    // Runtime: As push(const TYPE &).
+    virtual void push(TYPE &&val) {
+        push(static_cast<const TYPE &>(val));
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ: the top of the buffer or the front of a
+    //              run, whichever is more extreme.
+    // Note: We will not run tests on your code that would require it to pop
+    // an element when the PQ is empty. Though you are welcome to if you are
+    // familiar with them, you do not need to use exceptions in this project.
+    // Runtime: O(log(memoryElements) + log(runs)), plus waiting for a
+    //          block to be read once every blockElements pops from a run
+    virtual void pop() {
+        if (topInBuffer()) {
+            std::pop_heap(buffer.begin(), buffer.end(), this->compare);
+            buffer.pop_back();
+            return;
+        }
+
+        auto later = [this](std::size_t a, std::size_t b) { return this->compare(front(a), front(b)); };
+        std::pop_heap(order.begin(), order.end(), later);
+        Run &run = runs[order.back()];
+        --spilled;
+        if (++run.pos == run.block.size()) {
+            if (run.blockStart + run.pos == run.end) {
+                // Used up: let go of its blocks, and of the whole file once
+                // every run is used up.
+                run.block = std::vector<TYPE>();
+                run.next = std::vector<TYPE>();
+                order.pop_back();
+                if (order.empty())
+                    truncate();
+                return;
+            }
+            nextBlock(run);
+        }
+        std::push_heap(order.begin(), order.end(), later);
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value.
+    // Runtime: As pop().
+    virtual TYPE pop_top() {
+        TYPE result = top();
+        pop();
+        return result;
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ. This should be a reference for speed. It MUST
+    //              be const because we cannot allow it to be modified, as
+    //              that might make it no longer be the most extreme element.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return topInBuffer() ? buffer.front() : front(order.front());
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return buffer.size() + spilled;
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return size() == 0;
+    } // empty()
+
+
+    // Description: Bytes written to the spill file so far, and bytes read
+    //              back from it (including blocks being read ahead).
+    // Runtime: O(1)
+    std::uint64_t bytesSpilled() const {
+        return spilledBytes;
+    } // bytesSpilled()
+
+    std::uint64_t bytesReadBack() const {
+        return readBackBytes;
+    } // bytesReadBack()
+
+
+    // Description: Number of elements that are on disk rather than in the
+    //              insertion buffer, and the number of runs holding them.
+    // Runtime: O(1)
+    std::size_t spilledSize() const {
+        return spilled;
+    } // spilledSize()
+
+    std::size_t runCount() const {
+        return order.size();
+    } // runCount()
+
+
+private:
+    // A sorted run: elements [start, end) of the spill file, counted in
+    // elements, most extreme first. block holds elements blockStart and up,
+    // block[pos] being the front of the run; next is being filled with the
+    // block after it while reading is valid. reading is declared last, so
+    // it is destroyed (and waited for) before the blocks.
+    struct Run {
+        std::size_t end = 0;
+        std::size_t blockStart = 0;
+        std::size_t pos = 0;
+        std::vector<TYPE> block;
+        std::vector<TYPE> next;
+        std::future<void> reading;
+    };
+
+    // The insertion buffer, a binary heap by compare. A plain vector, so
+    // that spill() can sort it in place and still has every element if a
+    // write fails.
+    std::vector<TYPE> buffer;
+    std::size_t memoryElements;
+    std::size_t blockElements;
+    std::string directory;
+    // Runs, in the order they were written; used up runs stay until all are.
+    std::vector<Run> runs;
+    // Indices into runs of the runs not used up, a heap by their fronts.
+    std::vector<std::size_t> order;
+    // Elements in the runs, not yet popped.
+    std::size_t spilled = 0;
+    // The spill file, or -1 before the first spill, and its size in
+    // elements.
+    int fd = -1;
+    std::size_t fileEnd = 0;
+    std::uint64_t spilledBytes = 0;
+    std::uint64_t readBackBytes = 0;
+
+
+    // Description: The front of runs[i].
+    // Runtime: O(1)
+    const TYPE &front(std::size_t i) const {
+        const Run &run = runs[i];
+        return run.block[run.pos];
+    } // front()
+
+    // Description: True if the most extreme element is in the buffer.
+    //              Ties go to the buffer, which is cheaper to pop.
+    // Runtime: O(1)
+    bool topInBuffer() const {
+        return order.empty() || (!buffer.empty() && !this->compare(buffer.front(), front(order.front())));
+    } // topInBuffer()
+
+    // Description: Empties the buffer into a new run at the end of the
+    //              spill file. The buffer is sorted in place, most extreme
+    //              element last, and copied out from the back a block at a
+    //              time. Each block is written by a task while the next one
+    //              is filled; the first block stays in memory as the run's
+    //              current block. The buffer is only cleared once every
+    //              write has succeeded; if one fails, it is made a heap
+    //              again and nothing is lost.
+    // Runtime: O(memoryElements log(memoryElements)), plus the writes
+    void spill() {
+        if (fd < 0)
+            open();
+        const std::size_t start = fileEnd;
+        std::vector<TYPE> head;
+        std::vector<TYPE> filling;
+        std::vector<TYPE> flushing;
+        std::future<void> writing;
+        try {
+            std::sort_heap(buffer.begin(), buffer.end(), this->compare);
+            for (std::size_t left = buffer.size(); left > 0;) {
+                filling.clear();
+                while (filling.size() < blockElements && left > 0)
+                    filling.push_back(buffer[--left]);
+                if (writing.valid())
+                    writing.get();
+                if (head.empty())
+                    head = filling;
+                flushing.swap(filling);
+                writing = std::async(std::launch::async, writeBytes, fd, flushing.data(),
+                                     flushing.size() * sizeof(TYPE), fileEnd * sizeof(TYPE));
+                spilledBytes += flushing.size() * sizeof(TYPE);
+                fileEnd += flushing.size();
+            }
+            if (writing.valid())
+                writing.get();
+        }
+        catch (...) {
+            if (writing.valid())
+                writing.wait();
+            fileEnd = start;
+            std::make_heap(buffer.begin(), buffer.end(), this->compare);
+            throw;
+        }
+        buffer.clear();
+        addRun(std::move(head), start);
+    } // spill()
+
+    // Description: Adds a run of the elements from start to fileEnd in the
+    //              spill file, whose first block is head, and starts reading
+    //              its second block.
+    // Runtime: O(log(runs))
+    void addRun(std::vector<TYPE> &&head, std::size_t start) {
+        Run run;
+        run.end = fileEnd;
+        run.blockStart = start;
+        run.block = std::move(head);
+        runs.push_back(std::move(run));
+        spilled += fileEnd - start;
+        readAhead(runs.back());
+        order.push_back(runs.size() - 1);
+        std::push_heap(order.begin(), order.end(),
+                       [this](std::size_t a, std::size_t b) { return this->compare(front(a), front(b)); });
+    } // addRun()
+
+    // Description: Starts reading the block after run.block into run.next,
+    //              if there is one.
+    // Runtime: O(1)
+    void readAhead(Run &run) {
+        const std::size_t first = run.blockStart + run.block.size();
+        if (first == run.end)
+            return;
+        run.next.resize(std::min(blockElements, run.end - first));
+        run.reading = std::async(std::launch::async, readBytes, fd, run.next.data(),
+                                 run.next.size() * sizeof(TYPE), first * sizeof(TYPE));
+        readBackBytes += run.next.size() * sizeof(TYPE);
+    } // readAhead()
+
+    // Description: Moves on to the block that has been read ahead for run,
+    //              waiting for it if need be, and reads ahead the one after.
+    // Runtime: O(1), plus the wait
+    void nextBlock(Run &run) {
+        run.reading.get();
+        run.blockStart += run.block.size();
+        run.pos = 0;
+        run.block.swap(run.next);
+        readAhead(run);
+    } // nextBlock()
+
+    // Description: Reads the elements of block from the spill file fd,
+    //              starting at element first, without a task.
+    // Runtime: O(block.size())
+    void readBlock(int from, std::vector<TYPE> &block, std::size_t first) {
+        readBytes(from, block.data(), block.size() * sizeof(TYPE), first * sizeof(TYPE));
+        readBackBytes += block.size() * sizeof(TYPE);
+    } // readBlock()
+
+    // Description: Writes block to the spill file at element first,
+    //              without a task.
+    // Runtime: O(block.size())
+    void writeBlock(const std::vector<TYPE> &block, std::size_t first) {
+        if (fd < 0)
+            open();
+        writeBytes(fd, block.data(), block.size() * sizeof(TYPE), first * sizeof(TYPE));
+        spilledBytes += block.size() * sizeof(TYPE);
+    } // writeBlock()
+
+    // Description: Creates the spill file and unlinks it, so that it is
+    //              deleted when it is closed, even if the program crashes.
+    // Runtime: O(1)
+    void open() {
+        std::string dir = directory;
+        if (dir.empty()) {
+            const char *tmp = std::getenv("TMPDIR");
+            dir = tmp != nullptr && *tmp != '\0' ? tmp : "/tmp";
+        }
+        std::string path = dir + "/ExternalPQ-XXXXXX";
+        fd = ::mkstemp(&path[0]);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "ExternalPQ: cannot create a spill file in " + dir);
+        ::unlink(path.c_str());
+    } // open()
+
+    // Description: Forgets the runs, which are all used up, and gives the
+    //              disk space of the spill file back.
+    // Runtime: O(runs)
+    void truncate() {
+        runs.clear();
+        fileEnd = 0;
+        if (::ftruncate(fd, 0) != 0)
+            throw std::system_error(errno, std::generic_category(), "ExternalPQ: cannot truncate the spill file");
+    } // truncate()
+
+    // Description: pread()/pwrite() of exactly 'bytes' bytes at 'offset'.
+    //              These run in the I/O tasks, so they only touch their
+    //              arguments.
+    // Runtime: O(bytes)
+    static void readBytes(int from, void *data, std::size_t bytes, std::size_t offset) {
+        char *out = static_cast<char *>(data);
+        while (bytes > 0) {
+            ssize_t got = ::pread(from, out, bytes, static_cast<off_t>(offset));
+            if (got <= 0) {
+                if (got < 0 && errno == EINTR)
+                    continue;
+                throw std::system_error(got < 0 ? errno : EIO, std::generic_category(),
+                                        "ExternalPQ: cannot read the spill file");
+            }
+            out += got;
+            bytes -= static_cast<std::size_t>(got);
+            offset += static_cast<std::size_t>(got);
+        }
+    } // readBytes()
+
+    static void writeBytes(int to, const void *data, std::size_t bytes, std::size_t offset) {
+        const char *in = static_cast<const char *>(data);
+        while (bytes > 0) {
+            ssize_t put = ::pwrite(to, in, bytes, static_cast<off_t>(offset));
+            if (put < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "ExternalPQ: cannot write the spill file");
+            }
+            in += put;
+            bytes -= static_cast<std::size_t>(put);
+            offset += static_cast<std::size_t>(put);
+        }
+    } // writeBytes()
+}; // ExternalPQ
+
+
+#endif // EXTERNALPQ_H
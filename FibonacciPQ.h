@@ -0,0 +1,605 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef FIBONACCIPQ_H
+#define FIBONACCIPQ_H
+
+#include "Eecs281PQ.h"
+#include "PoolAllocator.h"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A specialized version of the priority queue ADT implemented as a
+// Fibonacci heap (Fredman and Tarjan, 1987). It has the same handle API as
+// PairingPQ: addNode() returns a Node* that stays valid until its element
+// is popped or erased, and updateElt() changes the element in place.
+//
+// The roots form a circular doubly linked list, and so do the children of
+// every node. push() only adds a root; pop() is where the work happens:
+// the children of the top become roots, and roots of equal degree are
+// linked until all degrees differ. updateElt() to a more extreme value cuts
+// the node from its parent, and a parent that loses a second child is cut
+// as well (cascading cuts), which keeps a node of degree d at least
+// F(d + 2) nodes large. That gives amortized O(1) for a promotion, the
+// bound pairing heaps are not known to have, and O(log(n)) for pop().
+//
+// Nodes are obtained from ALLOCATOR (rebound to Node), as in PairingPQ.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename ALLOCATOR = PoolAllocator<TYPE>>
+class FibonacciPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Each node within the Fibonacci heap
+    class Node {
+        public:
+            explicit Node(const TYPE &val)
+                : elt{ val }
+            {}
+
+            explicit Node(TYPE &&val)
+                : elt{ std::move(val) }
+            {}
+
+            // Constructs the element in place from args (used by emplace()).
+            template<typename... Args>
+            explicit Node(std::in_place_t, Args &&...args)
+                : elt(std::forward<Args>(args)...)
+            {}
+
+            // Description: Allows access to the element at that Node's
+            // position.
+            // Runtime: O(1)
+            const TYPE &getElt() const { return elt; }
+            const TYPE &operator*() const { return elt; }
+
+            friend FibonacciPQ;
+
+        private:
+            TYPE elt;
+            Node *parent = nullptr;
+            // Any one of the children; they form a ring through left/right.
+            Node *child = nullptr;
+            Node *left = this;
+            Node *right = this;
+            unsigned degree = 0;
+            // Set when the node has lost a child since it became a child
+            // itself; the next loss cuts it too.
+            bool marked = false;
+    }; // Node
+
+
+    using allocator_type = ALLOCATOR;
+
+
+    // Description: Construct an empty Fibonacci heap with an optional
+    //              comparison functor and allocator.
+    // Runtime: O(1)
+    explicit FibonacciPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const ALLOCATOR &allocator = ALLOCATOR()) :
+        BaseClass{ comp }, alloc{ allocator } {
+    } // FibonacciPQ()
+
+
+    // Description: Construct a Fibonacci heap out of an iterator range with
+    //              an optional comparison functor and allocator. Every
+    //              element becomes a root; the first pop() links them.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    FibonacciPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                const ALLOCATOR &allocator = ALLOCATOR()) :
+        BaseClass{ comp }, alloc{ allocator } {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+            reserveNodes(static_cast<std::size_t>(std::distance(start, end)));
+        }
+        try {
+            for (; start != end; ++start) {
+                addNode(*start);
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    } // FibonacciPQ()
+
+
+    // Description: Copy constructor. The copy holds the same elements, each
+    //              as a root of its own; the first pop() links them.
+    // Runtime: O(n)
+    FibonacciPQ(const FibonacciPQ &other) :
+        BaseClass{ other.compare },
+        alloc{ NodeTraits::select_on_container_copy_construction(other.alloc) } {
+        reserveNodes(other.numN);
+        try {
+            other.forEachNode([this](const Node *node) {
+                addNode(node->elt);
+            });
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    } // FibonacciPQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    FibonacciPQ &operator=(const FibonacciPQ &rhs) {
+        FibonacciPQ temp(rhs);
+        std::swap(numN, temp.numN);
+        std::swap(root, temp.root);
+        std::swap(alloc, temp.alloc);
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor
+    // Runtime: O(n)
+    ~FibonacciPQ() {
+        clear();
+    } // ~FibonacciPQ()
+
+
+    // Description: Removes every element from the Fibonacci heap. With the
+    //              default PoolAllocator and a trivially destructible TYPE
+    //              the nodes are not visited, as in PairingPQ.
+    // Runtime: O(n), O(log(n)) with PoolAllocator and trivial TYPE
+    void clear() {
+        if (root != nullptr && !releaseAll()) {
+            // The roots, opened into a list through right. Each node's
+            // children are spliced in after it before it is destroyed.
+            Node *node = root;
+            root->left->right = nullptr;
+            while (node != nullptr) {
+                spliceChildren(node);
+                Node *next = node->right;
+                destroyNode(node);
+                node = next;
+            }
+        }
+        root = nullptr;
+        numN = 0;
+    } // clear()
+
+
+    // Description: Assumes that all elements inside the Fibonacci heap are
+    //              out of order and 'rebuilds' it: every node becomes a
+    //              root of its own, and the most extreme one the top. The
+    //              nodes are kept, so handles stay valid.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        if (root == nullptr) {
+            return;
+        }
+        Node *node = root;
+        root->left->right = nullptr;
+        root = nullptr;
+        while (node != nullptr) {
+            spliceChildren(node);
+            Node *next = node->right;
+            node->parent = nullptr;
+            node->degree = 0;
+            node->marked = false;
+            node->left = node->right = node;
+            addRoot(node);
+            node = next;
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the Fibonacci heap.
+    // Runtime: O(1)
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Add a new element to the Fibonacci heap, moving from val.
+    // Runtime: O(1)
+    virtual void push(TYPE &&val) {
+        addNode(std::move(val));
+    } // push()
+
+
+    // Description: Add a new element to the Fibonacci heap, constructed in
+    //              place inside its Node from args.
+    // Runtime: O(1)
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        linkNode(createNode(std::in_place, std::forward<Args>(args)...));
+    } // emplace()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the Fibonacci heap.
+    // Note: We will not run tests on your code that would require it to pop
+    // an element when the Fibonacci heap is empty. Though you are welcome
+    // to if you are familiar with them, you do not need to use exceptions in
+    // this project.
+    // Runtime: Amortized O(log(n))
+    virtual void pop() {
+        removeRoot(root);
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the Fibonacci heap and return it by value (moved,
+    //              not copied).
+    // Runtime: Amortized O(log(n))
+    virtual TYPE pop_top() {
+        TYPE result = std::move(root->elt);
+        pop();
+        return result;
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the Fibonacci heap. This should be a reference for
+    //              speed. It MUST be const because we cannot allow it to be
+    //              modified, as that might make it no longer be the most
+    //              extreme element.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return root->elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the Fibonacci heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return numN;
+    } // size()
+
+
+    // Description: Return true if the Fibonacci heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return numN == 0;
+    } // empty()
+
+
+    // Description: Updates the priority of an element already in the
+    //              Fibonacci heap by replacing the element refered to by
+    //              the Node with new_value.
+    //
+    //              new_value may be more or less extreme than the old value.
+    //              A more extreme node that now beats its parent is cut out
+    //              with its subtree (followed by cascading cuts) and becomes
+    //              a root. Otherwise the node is cut out alone: its
+    //              children become roots, and so does the node. If it was
+    //              the top, the roots are linked as in pop() to find the
+    //              new one. That also covers elements that compare equal
+    //              before and after, such as pointers whose pointees
+    //              changed.
+    //
+    // Runtime: Amortized O(1) when the value becomes more extreme;
+    //          amortized O(log(n)) otherwise.
+    void updateElt(Node *node, const TYPE &new_value) {
+        updateElt(node, TYPE(new_value));
+    } // updateElt()
+
+
+    // Description: Same as above, but moves new_value into the Node.
+    // Runtime: As above.
+    void updateElt(Node *node, TYPE &&new_value) {
+        const bool promoted = this->compare(node->elt, new_value);
+        node->elt = std::move(new_value);
+
+        if (promoted) {
+            if (node->parent != nullptr && this->compare(node->parent->elt, node->elt)) {
+                cutCascading(node);
+            }
+            if (node != root && this->compare(root->elt, node->elt)) {
+                root = node;
+            }
+            return;
+        }
+
+        if (node->parent != nullptr) {
+            cutCascading(node);
+        }
+        spliceChildren(node);
+        node->degree = 0;
+        if (node == root) {
+            consolidate();
+        }
+        else if (this->compare(root->elt, node->elt)) {
+            root = node;
+        }
+    } // updateElt()
+
+
+    // Description: Removes the element refered to by node from the
+    //              Fibonacci heap, wherever it is. The node is destroyed, so
+    //              node must not be used afterwards.
+    // Runtime: Amortized O(log(n)) for the top, amortized O(1) otherwise
+    void erase(Node *node) {
+        if (node == root) {
+            pop();
+            return;
+        }
+        if (node->parent != nullptr) {
+            cutCascading(node);
+        }
+        // node is a root that is not the top, so neither it nor its
+        // children can be the new top.
+        spliceChildren(node);
+        unlinkFromRing(node);
+        destroyNode(node);
+        --numN;
+    } // erase()
+
+
+    // Description: Add a new element to the Fibonacci heap. Returns a Node*
+    //              corresponding to the newly added element, which stays
+    //              valid until the element is popped or erased.
+    // Runtime: O(1)
+    Node *addNode(const TYPE &val) {
+        return linkNode(createNode(val));
+    } // addNode()
+
+
+    // Description: Same as above, but moves val into the new Node.
+    // Runtime: O(1)
+    Node *addNode(TYPE &&val) {
+        return linkNode(createNode(std::move(val)));
+    } // addNode()
+
+
+private:
+    using NodeAllocator = typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    // More than the largest possible degree: a root of degree d has at
+    // least F(d + 2) >= phi^d nodes, and phi^93 exceeds 2^64.
+    static constexpr std::size_t MAX_DEGREE = 96;
+
+    // The most extreme root, nullptr when empty.
+    Node *root = nullptr;
+    std::size_t numN = 0;
+    NodeAllocator alloc;
+
+
+    // Description: Allocates a node from alloc and constructs it from args.
+    // Runtime: O(1)
+    template<typename... Args>
+    Node *createNode(Args &&...args) {
+        Node *node = NodeTraits::allocate(alloc, 1);
+        try {
+            ::new (static_cast<void *>(node)) Node(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    } // createNode()
+
+    // Description: Destroys a node and gives it back to alloc.
+    // Runtime: O(1)
+    void destroyNode(Node *node) {
+        node->~Node();
+        NodeTraits::deallocate(alloc, node, 1);
+    } // destroyNode()
+
+    // Description: Frees every node without visiting them, when elements
+    //              need no destructor and the allocator is a PoolAllocator
+    //              nobody else shares. Returns false otherwise.
+    // Runtime: O(log(n))
+    bool releaseAll() {
+        if constexpr (std::is_trivially_destructible<TYPE>::value
+                      && std::is_same<NodeAllocator, PoolAllocator<Node>>::value) {
+            return alloc.release();
+        }
+        else {
+            return false;
+        }
+    } // releaseAll()
+
+    // Description: With a PoolAllocator, asks the pool for n nodes in one
+    //              slab. Other allocators allocate node by node anyway.
+    // Runtime: O(1) amortized
+    void reserveNodes(std::size_t n) {
+        if constexpr (std::is_same<NodeAllocator, PoolAllocator<Node>>::value) {
+            alloc.reserve(n);
+        }
+    } // reserveNodes()
+
+    // Description: Calls fn on every node, parents before children. Used by
+    //              the copy constructor, which must not change other.
+    // Runtime: O(n)
+    template<typename Fn>
+    void forEachNode(Fn fn) const {
+        if (root == nullptr) {
+            return;
+        }
+        std::vector<const Node *> rings{ root };
+        while (!rings.empty()) {
+            const Node *first = rings.back();
+            rings.pop_back();
+            const Node *node = first;
+            do {
+                fn(node);
+                if (node->child != nullptr) {
+                    rings.push_back(node->child);
+                }
+                node = node->right;
+            } while (node != first);
+        }
+    } // forEachNode()
+
+    // Description: Inserts a single node into the ring after pos.
+    // Runtime: O(1)
+    static void insertAfter(Node *pos, Node *node) {
+        node->left = pos;
+        node->right = pos->right;
+        pos->right->left = node;
+        pos->right = node;
+    } // insertAfter()
+
+    // Description: Removes node from its ring, leaving it a ring of one.
+    // Runtime: O(1)
+    static void unlinkFromRing(Node *node) {
+        node->left->right = node->right;
+        node->right->left = node->left;
+        node->left = node->right = node;
+    } // unlinkFromRing()
+
+    // Description: Moves the children of node, unmarked, into the list
+    //              node is in, right after node. node keeps its degree.
+    // Runtime: O(degree of node)
+    static void spliceChildren(Node *node) {
+        Node *first = node->child;
+        if (first == nullptr) {
+            return;
+        }
+        Node *child = first;
+        do {
+            child->parent = nullptr;
+            child->marked = false;
+            child = child->right;
+        } while (child != first);
+        // The child ring, opened before first, goes between node and the
+        // node after it. node->right may be nullptr when clear() has opened
+        // the list.
+        Node *last = first->left;
+        Node *after = node->right;
+        node->right = first;
+        first->left = node;
+        last->right = after;
+        if (after != nullptr) {
+            after->left = last;
+        }
+        node->child = nullptr;
+    } // spliceChildren()
+
+    // Description: Adds a node that is a ring of one to the roots and makes
+    //              it the top if it is more extreme.
+    // Runtime: O(1)
+    void addRoot(Node *node) {
+        if (root == nullptr) {
+            root = node;
+            return;
+        }
+        insertAfter(root, node);
+        if (this->compare(root->elt, node->elt)) {
+            root = node;
+        }
+    } // addRoot()
+
+    // Description: Adds a freshly allocated node to the roots.
+    // Runtime: O(1)
+    Node *linkNode(Node *node) {
+        addRoot(node);
+        numN++;
+        return node;
+    } // linkNode()
+
+    // Description: Cuts node from its parent and makes it an unmarked root;
+    //              each ancestor that had already lost a child is cut as
+    //              well, and the first one that had not is marked. Does not
+    //              update the top.
+    // Runtime: Amortized O(1)
+    void cutCascading(Node *node) {
+        Node *parent = node->parent;
+        cut(node);
+        while (parent->parent != nullptr) {
+            if (!parent->marked) {
+                parent->marked = true;
+                return;
+            }
+            Node *next = parent->parent;
+            cut(parent);
+            parent = next;
+        }
+    } // cutCascading()
+
+    // Description: Cuts node, with its subtree, from its parent's children
+    //              and adds it to the roots, unmarked.
+    // Runtime: O(1)
+    void cut(Node *node) {
+        Node *parent = node->parent;
+        if (parent->child == node) {
+            parent->child = (node->right != node) ? node->right : nullptr;
+        }
+        unlinkFromRing(node);
+        --parent->degree;
+        node->parent = nullptr;
+        node->marked = false;
+        insertAfter(root, node);
+    } // cut()
+
+    // Description: Makes the less extreme of two roots, which must have
+    //              equal degrees and be rings of one, a child of the other.
+    //              Returns the new root.
+    // Runtime: O(1)
+    Node *link(Node *a, Node *b) {
+        if (this->compare(a->elt, b->elt)) {
+            std::swap(a, b);
+        }
+        b->parent = a;
+        if (a->child == nullptr) {
+            a->child = b;
+        }
+        else {
+            insertAfter(a->child, b);
+        }
+        ++a->degree;
+        return a;
+    } // link()
+
+    // Description: Removes the root node (the top or another root) and
+    //              destroys it. Its children become roots, and then all
+    //              roots are linked until their degrees differ.
+    // Runtime: Amortized O(log(n))
+    void removeRoot(Node *node) {
+        spliceChildren(node);
+        if (node->right == node) {
+            root = nullptr;
+        }
+        else {
+            root = node->right;
+            unlinkFromRing(node);
+            consolidate();
+        }
+        destroyNode(node);
+        --numN;
+    } // removeRoot()
+
+    // Description: Links roots of equal degree until all degrees differ,
+    //              and finds the new top. root may be any root on entry.
+    // Runtime: O(number of roots + log(n))
+    void consolidate() {
+        std::array<Node *, MAX_DEGREE> byDegree{};
+        std::size_t maxDegree = 0;
+        Node *node = root;
+        root->left->right = nullptr;
+        while (node != nullptr) {
+            Node *next = node->right;
+            node->left = node->right = node;
+            std::size_t degree = node->degree;
+            while (byDegree[degree] != nullptr) {
+                node = link(byDegree[degree], node);
+                byDegree[degree++] = nullptr;
+            }
+            byDegree[degree] = node;
+            maxDegree = std::max(maxDegree, degree);
+            node = next;
+        }
+
+        root = nullptr;
+        for (std::size_t degree = 0; degree <= maxDegree; ++degree) {
+            if (byDegree[degree] != nullptr) {
+                addRoot(byDegree[degree]);
+            }
+        }
+    } // consolidate()
+};
+
+
+#endif // FIBONACCIPQ_H
@@ -0,0 +1,231 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef FINDEXTREME_H
+#define FINDEXTREME_H
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+
+// Linear search for the most extreme element of an unsorted array, shared
+// by UnorderedPQ and UnorderedFastPQ.
+//
+// For arithmetic element types ordered by std::less or std::greater the
+// search is vectorized: one pass computes the extreme value with SIMD
+// max/min, a second pass returns the first index holding that value. On
+// x86 the AVX2 kernel is used when the CPU supports it (checked once at
+// runtime), otherwise the SSE2 baseline; other compilers and targets, and
+// arrays containing a NaN, use the scalar loop. All paths return the same
+// index as the scalar loop, which keeps the first of several equally
+// extreme elements.
+
+
+// Description: Tells whether findExtremeIndex() can use the vectorized
+//              kernels for TYPE ordered by COMP, and which way: MAX is
+//              true when the most extreme element is the largest one.
+template<typename TYPE, typename COMP>
+struct SimdExtreme {
+    static constexpr bool SUPPORTED = false;
+    static constexpr bool MAX = false;
+};
+
+template<typename TYPE>
+struct SimdExtremeType {
+    static constexpr bool SUPPORTED =
+        std::is_arithmetic<TYPE>::value && !std::is_same<TYPE, bool>::value && sizeof(TYPE) <= 8;
+};
+
+template<typename TYPE>
+struct SimdExtreme<TYPE, std::less<TYPE>> {
+    static constexpr bool SUPPORTED = SimdExtremeType<TYPE>::SUPPORTED;
+    static constexpr bool MAX = true;
+};
+
+template<typename TYPE>
+struct SimdExtreme<TYPE, std::less<>> {
+    static constexpr bool SUPPORTED = SimdExtremeType<TYPE>::SUPPORTED;
+    static constexpr bool MAX = true;
+};
+
+template<typename TYPE>
+struct SimdExtreme<TYPE, std::greater<TYPE>> {
+    static constexpr bool SUPPORTED = SimdExtremeType<TYPE>::SUPPORTED;
+    static constexpr bool MAX = false;
+};
+
+template<typename TYPE>
+struct SimdExtreme<TYPE, std::greater<>> {
+    static constexpr bool SUPPORTED = SimdExtremeType<TYPE>::SUPPORTED;
+    static constexpr bool MAX = false;
+};
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIND_EXTREME_SIMD 1
+
+// The kernels below are written with GCC vector extensions, so the same
+// body compiles to SSE2 or AVX2 depending on the target of the function it
+// is inlined into.
+template<typename TYPE, bool MAX>
+struct SimdExtremeKernel {
+    typedef TYPE Vec __attribute__((vector_size(32)));
+    // Same vector, for loads from arrays that are only TYPE-aligned.
+    typedef TYPE UnalignedVec __attribute__((vector_size(32), aligned(alignof(TYPE)), may_alias));
+    static constexpr std::size_t LANES = sizeof(Vec) / sizeof(TYPE);
+
+    // Smallest array worth vectorizing.
+    static constexpr std::size_t MIN_SIZE = 4 * LANES;
+
+    // Vectors are passed by reference so that these helpers have the same
+    // ABI in the AVX2 and the baseline kernels.
+    __attribute__((always_inline)) static inline void load(Vec &v, const TYPE *p) {
+        v = *reinterpret_cast<const UnalignedVec *>(p);
+    } // load()
+
+    __attribute__((always_inline)) static inline void update(Vec &acc, const Vec &v) {
+        if constexpr (MAX)
+            acc = v > acc ? v : acc;
+        else
+            acc = v < acc ? v : acc;
+    } // update()
+
+    // Description: Computes the extreme value of data[0, n), n >= MIN_SIZE,
+    //              into 'result'. Returns false if a NaN was seen, in which
+    //              case the caller must fall back to the scalar loop.
+    __attribute__((always_inline)) static inline bool
+    reduce(const TYPE *data, std::size_t n, TYPE &result) {
+        // Four independent accumulators hide the latency of the max/min.
+        Vec acc[4], v[4];
+        for (std::size_t j = 0; j < 4; ++j)
+            load(acc[j], data + j * LANES);
+        decltype(acc[0] != acc[0]) nan = acc[0] != acc[0];
+        for (std::size_t j = 1; j < 4; ++j)
+            nan |= acc[j] != acc[j];
+
+        std::size_t i = 4 * LANES;
+        for (; i + 4 * LANES <= n; i += 4 * LANES) {
+            for (std::size_t j = 0; j < 4; ++j) {
+                load(v[j], data + i + j * LANES);
+                update(acc[j], v[j]);
+                if constexpr (std::is_floating_point<TYPE>::value)
+                    nan |= v[j] != v[j];
+            }
+        }
+        update(acc[0], acc[1]);
+        update(acc[2], acc[3]);
+        update(acc[0], acc[2]);
+
+        if constexpr (std::is_floating_point<TYPE>::value) {
+            for (std::size_t k = 0; k < LANES; ++k)
+                if (nan[k])
+                    return false;
+        }
+
+        TYPE best = acc[0][0];
+        for (std::size_t k = 1; k < LANES; ++k)
+            if (MAX ? best < acc[0][k] : acc[0][k] < best)
+                best = acc[0][k];
+        for (; i < n; ++i) {
+            if (data[i] != data[i])
+                return false;
+            if (MAX ? best < data[i] : data[i] < best)
+                best = data[i];
+        }
+
+        result = best;
+        return true;
+    } // reduce()
+
+    // Description: Returns the first index of data[0, n) holding value,
+    //              which must be present.
+    __attribute__((always_inline)) static inline std::size_t
+    find(const TYPE *data, std::size_t n, TYPE value) {
+        Vec target = value - Vec{}, v;
+        std::size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            load(v, data + i);
+            auto match = v == target;
+            // Any lane set makes the whole vector nonzero.
+            unsigned long long word[sizeof(match) / 8];
+            std::memcpy(word, &match, sizeof(match));
+            unsigned long long any = 0;
+            for (std::size_t k = 0; k < sizeof(match) / 8; ++k)
+                any |= word[k];
+            if (any)
+                break;
+        }
+        while (data[i] != value)
+            ++i;
+        return i;
+    } // find()
+
+    // Description: Index of the extreme element of data[0, n), or n if the
+    //              array holds a NaN.
+    __attribute__((always_inline)) static inline std::size_t
+    extremeIndex(const TYPE *data, std::size_t n) {
+        TYPE best;
+        if (!reduce(data, n, best))
+            return n;
+        // The first element equal to the extreme value is the one the
+        // scalar loop would have stopped moving from.
+        return find(data, n, best);
+    } // extremeIndex()
+
+    __attribute__((target("avx2"))) static std::size_t
+    extremeIndexAvx2(const TYPE *data, std::size_t n) {
+        return extremeIndex(data, n);
+    } // extremeIndexAvx2()
+
+    static std::size_t extremeIndexBaseline(const TYPE *data, std::size_t n) {
+        return extremeIndex(data, n);
+    } // extremeIndexBaseline()
+}; // SimdExtremeKernel
+
+
+// Description: True if the CPU running the program supports AVX2.
+inline bool cpuHasAvx2() {
+    static const bool avx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return avx2;
+} // cpuHasAvx2()
+
+#endif
+
+
+// Description: Returns the index of the most extreme element of data[0, n)
+//              according to comp, n > 0. The result is always the same as
+//              the scalar loop's:
+//                  index = 0;
+//                  for (i = 1; i < n; ++i)
+//                      if (comp(data[index], data[i]))
+//                          index = i;
+// Runtime: O(n)
+template<typename TYPE, typename COMP>
+std::size_t findExtremeIndex(const TYPE *data, std::size_t n, const COMP &comp) {
+#ifdef FIND_EXTREME_SIMD
+    if constexpr (SimdExtreme<TYPE, COMP>::SUPPORTED) {
+        using Kernel = SimdExtremeKernel<TYPE, SimdExtreme<TYPE, COMP>::MAX>;
+        if (n >= Kernel::MIN_SIZE) {
+            std::size_t index =
+                cpuHasAvx2() ? Kernel::extremeIndexAvx2(data, n) : Kernel::extremeIndexBaseline(data, n);
+            if (index < n)
+                return index;
+        }
+    }
+#endif
+
+    std::size_t index = 0;
+
+    for (std::size_t i = 1; i < n; ++i)
+        if (comp(data[index], data[i]))
+            index = i;
+
+    return index;
+} // findExtremeIndex()
+
+
+#endif // FINDEXTREME_H
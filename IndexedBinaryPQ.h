@@ -0,0 +1,369 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef INDEXEDBINARYPQ_H
+#define INDEXEDBINARYPQ_H
+
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "Eecs281PQ.h"
+
+
+// A binary heap whose elements can be reached through handles, for
+// decrease-key/increase-key style algorithms (Dijkstra, A*, timers).
+// addNode() returns a handle; a position map from handles to heap indices
+// lets updateElt() re-sift one element in either direction and erase()
+// remove it, both in O(log(n)), instead of rebuilding the whole heap with
+// updatePriorities().
+//
+// Each heap slot stores the element together with its handle, so sifting
+// compares elements that sit next to each other, just like BinaryPQ. A
+// handle stays valid until its element is popped or erased; after that it
+// may be handed out again. The heap holds at most 2^32 - 1 elements.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class IndexedBinaryPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Stable ID of an element, returned by addNode().
+    using Handle = std::uint32_t;
+
+
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit IndexedBinaryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+    } // IndexedBinaryPQ
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor. The elements get handles 0, 1, ...
+    //              in range order.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    IndexedBinaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+        for (; start != end; ++start) {
+            Handle handle = static_cast<Handle>(data.size());
+            data.push_back(Slot{ *start, handle });
+            position.push_back(handle);
+        }
+        updatePriorities();
+    } // IndexedBinaryPQ
+
+
+    // Description: Destructor doesn't need any code, the vectors will be
+    //              destroyed automatically.
+    virtual ~IndexedBinaryPQ() {
+    } // ~IndexedBinaryPQ()
+
+
+    // Description: Assumes that all elements inside the heap are out of order
+    //              and 'rebuilds' the heap. Handles stay valid.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        for (std::size_t i = data.size() / 2; i > 0; i--) {
+            fixDown(i - 1);
+        }
+    } // updatePriorities()
+
+
+    // Description: Repairs the heap after the elements in 'changed' were
+    //              modified in place, sifting only their positions and
+    //              ancestors (see BinaryPQ::notifyChanged()). Rebuilds the
+    //              whole heap when many elements changed or TYPE cannot be
+    //              searched. With handles at hand, notifyChangedHandles()
+    //              skips the search.
+    // Runtime: O(n log(k) + k log^2(n)) for k changed elements
+    virtual void notifyChanged(const std::vector<TYPE> &changed) {
+        if constexpr (ChangedSet<TYPE>::SEARCHABLE) {
+            if (!BaseClass::rebuildCheaper(changed.size(), data.size())) {
+                ChangedSet<TYPE> dirty{ changed };
+                std::vector<std::size_t> positions;
+                for (std::size_t i = 0; i < data.size(); ++i) {
+                    if (dirty.contains(data[i].elt))
+                        positions.push_back(i);
+                }
+                repair(positions);
+                return;
+            }
+        }
+        BaseClass::notifyChanged(changed);
+    } // notifyChanged()
+
+
+    // Description: Same as above for elements given by handle, e.g. after
+    //              the pointees of several pointer elements changed.
+    // Runtime: O(k log^2(n)) for k handles
+    void notifyChangedHandles(const std::vector<Handle> &changed) {
+        if (BaseClass::rebuildCheaper(changed.size(), data.size())) {
+            updatePriorities();
+            return;
+        }
+        std::vector<std::size_t> positions;
+        for (Handle handle : changed)
+            positions.push_back(position[handle]);
+        repair(positions);
+    } // notifyChangedHandles()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Add a new element to the PQ, moving from val.
+    // Runtime: O(log(n))
+    virtual void push(TYPE &&val) {
+        addNode(std::move(val));
+    } // push()
+
+
+    // Description: Construct a new element in place at the end of the heap
+    //              and sift it up.
+    // Runtime: O(log(n))
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        Handle handle = newHandle();
+        data.push_back(Slot{ TYPE(std::forward<Args>(args)...), handle });
+        fixUp(data.size() - 1);
+    } // emplace()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ. Its handle becomes free.
+    // Runtime: O(log(n))
+    virtual void pop() {
+        removeAt(0);
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value (moved, not copied).
+    // Runtime: O(log(n))
+    virtual TYPE pop_top() {
+        TYPE result = std::move(data.front().elt);
+        removeAt(0);
+        return result;
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return data.front().elt;
+    } // top()
+
+
+    // Description: Return the handle of the most extreme element.
+    // Runtime: O(1)
+    Handle topHandle() const {
+        return data.front().handle;
+    } // topHandle()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return data.size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return data.empty();
+    } // empty()
+
+
+    // Description: Add a new element to the PQ and return its handle.
+    // Runtime: O(log(n))
+    Handle addNode(const TYPE &val) {
+        Handle handle = newHandle();
+        data.push_back(Slot{ val, handle });
+        fixUp(data.size() - 1);
+        return handle;
+    } // addNode()
+
+
+    // Description: Same as above, but moves val into the heap.
+    // Runtime: O(log(n))
+    Handle addNode(TYPE &&val) {
+        Handle handle = newHandle();
+        data.push_back(Slot{ std::move(val), handle });
+        fixUp(data.size() - 1);
+        return handle;
+    } // addNode()
+
+
+    // Description: Return the element with the given handle.
+    // Runtime: O(1)
+    const TYPE &getElt(Handle handle) const {
+        return data[position[handle]].elt;
+    } // getElt()
+
+
+    // Description: True if handle refers to an element still in the PQ.
+    // Runtime: O(1)
+    bool contains(Handle handle) const {
+        return handle < position.size() && position[handle] != NIL;
+    } // contains()
+
+
+    // Description: Replaces the element with the given handle by new_value,
+    //              which may be more or less extreme than the old one.
+    // Runtime: O(log(n))
+    void updateElt(Handle handle, const TYPE &new_value) {
+        updateElt(handle, TYPE(new_value));
+    } // updateElt()
+
+
+    // Description: Same as above, but moves new_value into the heap.
+    // Runtime: O(log(n))
+    void updateElt(Handle handle, TYPE &&new_value) {
+        std::size_t i = position[handle];
+        data[i].elt = std::move(new_value);
+        resift(i);
+    } // updateElt()
+
+
+    // Description: Removes the element with the given handle from the PQ.
+    // Runtime: O(log(n))
+    void erase(Handle handle) {
+        removeAt(position[handle]);
+    } // erase()
+
+
+private:
+    static constexpr Handle NIL = UINT32_MAX;
+
+    struct Slot {
+        TYPE elt;
+        Handle handle;
+    };
+
+    // The heap is stored 0-based: the children of index i are 2i+1, 2i+2.
+    std::vector<Slot> data;
+    // Heap index of every handle, NIL for free handles.
+    std::vector<Handle> position;
+    // Handles of popped and erased elements, reused by newHandle().
+    std::vector<Handle> freeHandles;
+
+    Handle newHandle() {
+        if (freeHandles.empty()) {
+            position.push_back(static_cast<Handle>(data.size()));
+            return static_cast<Handle>(position.size() - 1);
+        }
+        Handle handle = freeHandles.back();
+        freeHandles.pop_back();
+        position[handle] = static_cast<Handle>(data.size());
+        return handle;
+    } // newHandle()
+
+    // Description: Moves slot into index i and records its new position.
+    // Runtime: O(1)
+    void place(std::size_t i, Slot &&slot) {
+        position[slot.handle] = static_cast<Handle>(i);
+        data[i] = std::move(slot);
+    } // place()
+
+    // Description: Removes the element at heap index i, frees its handle and
+    //              fills the hole with the last element.
+    // Runtime: O(log(n))
+    void removeAt(std::size_t i) {
+        position[data[i].handle] = NIL;
+        freeHandles.push_back(data[i].handle);
+        if (i + 1 != data.size()) {
+            place(i, std::move(data.back()));
+            data.pop_back();
+            resift(i);
+        }
+        else {
+            data.pop_back();
+        }
+    } // removeAt()
+
+    // Description: Restores the heap after the element at index i changed,
+    //              moving it whichever way it needs to go.
+    // Runtime: O(log(n))
+    void resift(std::size_t i) {
+        if (i > 0 && this->compare(data[(i - 1) / 2].elt, data[i].elt))
+            fixUp(i);
+        else
+            fixDown(i);
+    } // resift()
+
+    // Description: Restores the heap when only the elements at the given
+    //              positions may be out of order, by running fixDown() on
+    //              them and their ancestors, deepest first (see
+    //              BinaryPQ::repair()).
+    // Runtime: O(k log^2(n)) for k positions
+    void repair(const std::vector<std::size_t> &positions) {
+        std::vector<std::size_t> nodes;
+        for (std::size_t i : positions) {
+            nodes.push_back(i);
+            while (i > 0) {
+                i = (i - 1) / 2;
+                nodes.push_back(i);
+            }
+        }
+        std::sort(nodes.begin(), nodes.end(), std::greater<std::size_t>());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+        for (std::size_t i : nodes)
+            fixDown(i);
+    } // repair()
+
+    // Like BinaryPQ, the sift routines move a hole through the heap instead
+    // of swapping; every slot that moves updates its handle's position.
+
+    // Description: Moves the element at index i up until its parent is
+    //              not less extreme.
+    // Runtime: O(log(n))
+    void fixUp(std::size_t i) {
+        if (i == 0 || !this->compare(data[(i - 1) / 2].elt, data[i].elt)) {
+            position[data[i].handle] = static_cast<Handle>(i);
+            return;
+        }
+
+        Slot value = std::move(data[i]);
+        do {
+            place(i, std::move(data[(i - 1) / 2]));
+            i = (i - 1) / 2;
+        } while (i > 0 && this->compare(data[(i - 1) / 2].elt, value.elt));
+        place(i, std::move(value));
+    } // fixUp()
+
+    // Description: Moves the element at index i down until neither child
+    //              is more extreme.
+    // Runtime: O(log(n))
+    void fixDown(std::size_t i) {
+        const std::size_t n = data.size();
+        if (2 * i + 1 >= n)
+            return;
+
+        Slot value = std::move(data[i]);
+        while (2 * i + 1 < n) {
+            std::size_t j = 2 * i + 1;
+            if (j + 1 < n && this->compare(data[j].elt, data[j + 1].elt)) {
+                ++j;
+            }
+
+            if (!this->compare(value.elt, data[j].elt)) {
+                break;
+            }
+            place(i, std::move(data[j]));
+            i = j;
+        }
+        place(i, std::move(value));
+    } // fixDown()
+}; // IndexedBinaryPQ
+
+
+#endif // INDEXEDBINARYPQ_H
@@ -0,0 +1,412 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef LOCKEDHEAPPQ_H
+#define LOCKEDHEAPPQ_H
+
+#include "Eecs281PQ.h"
+#include "SpinLock.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <utility>
+
+
+// A binary heap that many threads can push to and pop from at once, after
+// Hunt, Michael, Parthasarathy and Scott, "An efficient algorithm for
+// concurrent priority queue heaps" (1996). Every node has its own lock; a
+// heap-wide lock is held only long enough to claim or release the last
+// slot. Insertions then sift up bottom-up and deletions sift down top-down,
+// both locking a parent before its children, so they never deadlock and
+// many of them overlap in different parts of the tree.
+//
+// An element that is still sifting up is tagged with the inserting
+// thread's ID. A deletion that moves it (it may take the last slot, or swap
+// it on its way down) carries the tag along, and the inserting thread
+// follows its element up until it finds it again or sees it was taken.
+// Slots are claimed in bit-reversed order within each level, so
+// consecutive insertions start in different subtrees and rarely meet.
+//
+// push(), pop(), pop_top(), try_pop(), size() and empty() may be called
+// from any number of threads at once. top() returns a reference into the
+// heap, and the copy constructor, updatePriorities() and notifyChanged()
+// rebuild it without locks, so they may only be used while no other thread
+// touches the queue. The comparator is called concurrently and must be
+// safe for that; moving a TYPE must not throw.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class LockedHeapPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit LockedHeapPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+    } // LockedHeapPQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    LockedHeapPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+        std::size_t n = 0;
+        for (; start != end; ++start)
+            place(++n, *start);
+        count.store(n, std::memory_order_relaxed);
+        updatePriorities();
+    } // LockedHeapPQ()
+
+
+    // Description: Copy constructor. other must not be modified meanwhile.
+    // Runtime: O(n)
+    LockedHeapPQ(const LockedHeapPQ &other) :
+        BaseClass{ other.compare } {
+        const std::size_t n = other.size();
+        for (std::size_t c = 1; c <= n; ++c)
+            place(c, *other.slot(slotIndex(c)).item);
+        count.store(n, std::memory_order_relaxed);
+    } // LockedHeapPQ()
+
+
+    // The node locks cannot be handed over, so there is no assignment.
+    LockedHeapPQ &operator=(const LockedHeapPQ &) = delete;
+
+
+    // Description: Destructor. Frees every level of slots.
+    // Runtime: O(n)
+    virtual ~LockedHeapPQ() {
+        for (std::atomic<Slot *> &level : levels)
+            delete[] level.load(std::memory_order_relaxed);
+    } // ~LockedHeapPQ()
+
+
+    // Description: Rebuilds the heap after the elements changed priority.
+    //              Not thread safe.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        // Deeper levels come first when counting down, which is all the
+        // bottom-up heap construction needs.
+        for (std::size_t c = size(); c > 0; --c)
+            fixDown(slotIndex(c));
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ. Thread safe.
+    // Runtime: O(log(n)) without contention
+    virtual void push(const TYPE &val) {
+        insert(TYPE(val));
+    } // push()
+
+
+    // Description: Add a new element to the PQ, moving from val. Thread safe.
+    // Runtime: O(log(n)) without contention
+    virtual void push(TYPE &&val) {
+        insert(std::move(val));
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ. Thread safe; the PQ must not be empty.
+    // Runtime: O(log(n)) without contention
+    virtual void pop() {
+        remove();
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value. Thread safe; the PQ
+    //              must not be empty.
+    // Runtime: O(log(n)) without contention
+    virtual TYPE pop_top() {
+        return std::move(*remove());
+    } // pop_top()
+
+
+    // Description: Remove the most extreme element from the PQ into out.
+    //              Returns false, leaving out alone, if the PQ was empty.
+    //              Thread safe.
+    // Runtime: O(log(n)) without contention
+    bool try_pop(TYPE &out) {
+        std::optional<TYPE> result = remove();
+        if (!result)
+            return false;
+        out = std::move(*result);
+        return true;
+    } // try_pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ. Not thread safe.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return *slot(1).item;
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ. Under concurrent
+    //              use, the number at some recent moment.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count.load(std::memory_order_relaxed);
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return size() == 0;
+    } // empty()
+
+
+private:
+    using Tag = std::uint64_t;
+
+    // Tags of a slot that holds no element, and of one whose element is
+    // settled. Any other tag is the ID of the thread inserting the element.
+    static constexpr Tag EMPTY = 0;
+    static constexpr Tag AVAILABLE = 1;
+
+    struct Slot {
+        SpinLock lock;
+        Tag tag = EMPTY;
+        std::optional<TYPE> item;
+    };
+
+    // Slots are 1-based heap indices; level L holds 2^L of them in one
+    // array that never moves once allocated, so threads can keep working
+    // on slots while the heap grows.
+    static constexpr std::size_t MAX_LEVELS = 64;
+
+    std::atomic<Slot *> levels[MAX_LEVELS] = {};
+    // Guards count and the claiming of the last slot.
+    SpinLock heapLock;
+    std::atomic<std::size_t> count{ 0 };
+
+    // Description: Returns the tag of the calling thread, unique for the
+    //              lifetime of the program.
+    // Runtime: O(1)
+    static Tag threadTag() {
+        static std::atomic<Tag> next{ AVAILABLE + 1 };
+        thread_local Tag tag = next.fetch_add(1, std::memory_order_relaxed);
+        return tag;
+    } // threadTag()
+
+    static std::size_t levelOf(std::size_t i) {
+        std::size_t level = 0;
+        while ((i >> level) > 1)
+            ++level;
+        return level;
+    } // levelOf()
+
+    // Description: Heap index of the c-th element: within its level, the
+    //              position is c's offset with its bits reversed.
+    // Runtime: O(log(c))
+    static std::size_t slotIndex(std::size_t c) {
+        const std::size_t level = levelOf(c);
+        std::size_t offset = c - (std::size_t{ 1 } << level);
+        std::size_t reversed = 0;
+        for (std::size_t bit = 0; bit < level; ++bit) {
+            reversed = (reversed << 1) | (offset & 1);
+            offset >>= 1;
+        }
+        return (std::size_t{ 1 } << level) | reversed;
+    } // slotIndex()
+
+    // Description: Returns the slot at heap index i, whose level must exist.
+    // Runtime: O(log(i))
+    Slot &slot(std::size_t i) const {
+        const std::size_t level = levelOf(i);
+        return levels[level].load(std::memory_order_acquire)[i - (std::size_t{ 1 } << level)];
+    } // slot()
+
+    // Description: True if the level holding heap index i was allocated.
+    // Runtime: O(log(i))
+    bool exists(std::size_t i) const {
+        return levels[levelOf(i)].load(std::memory_order_acquire) != nullptr;
+    } // exists()
+
+    // Description: Allocates the level of the c-th element if needed.
+    //              Called with heapLock held, or before the PQ is shared.
+    // Runtime: O(size of the level) when it is allocated
+    void ensureLevel(std::size_t c) {
+        std::atomic<Slot *> &level = levels[levelOf(c)];
+        if (level.load(std::memory_order_relaxed) == nullptr)
+            level.store(new Slot[std::size_t{ 1 } << levelOf(c)], std::memory_order_release);
+    } // ensureLevel()
+
+    // Description: Stores val as the c-th element, without sifting. Only
+    //              for building a PQ that is not shared yet.
+    // Runtime: O(log(c))
+    template<typename T>
+    void place(std::size_t c, T &&val) {
+        ensureLevel(c);
+        Slot &s = slot(slotIndex(c));
+        s.item.emplace(std::forward<T>(val));
+        s.tag = AVAILABLE;
+    } // place()
+
+    static void swapSlots(Slot &a, Slot &b) {
+        std::swap(a.item, b.item);
+        std::swap(a.tag, b.tag);
+    } // swapSlots()
+
+    // Description: Claims the next slot for val and sifts it up, following
+    //              it if a concurrent deletion moves it.
+    // Runtime: O(log(n)) without contention
+    void insert(TYPE &&val) {
+        const Tag me = threadTag();
+        heapLock.lock();
+        const std::size_t c = count.load(std::memory_order_relaxed) + 1;
+        try {
+            ensureLevel(c);
+        }
+        catch (...) {
+            heapLock.unlock();
+            throw;
+        }
+        std::size_t i = slotIndex(c);
+        Slot &claimed = slot(i);
+        claimed.lock.lock();
+        count.store(c, std::memory_order_relaxed);
+        heapLock.unlock();
+        claimed.item.emplace(std::move(val));
+        claimed.tag = me;
+        claimed.lock.unlock();
+
+        while (i > 1) {
+            Slot &parent = slot(i / 2);
+            Slot &child = slot(i);
+            bool parentBusy = false;
+            parent.lock.lock();
+            child.lock.lock();
+            if (parent.tag == AVAILABLE && child.tag == me) {
+                if (this->compare(*parent.item, *child.item)) {
+                    swapSlots(parent, child);
+                    i /= 2;
+                }
+                else {
+                    child.tag = AVAILABLE;
+                    i = 0;
+                }
+            }
+            else if (parent.tag == EMPTY) {
+                // A deletion took the element out from under us.
+                i = 0;
+            }
+            else if (child.tag != me) {
+                // A deletion moved the element up; follow it.
+                i /= 2;
+            }
+            else {
+                // The parent is still sifting up itself: retry.
+                parentBusy = true;
+            }
+            child.lock.unlock();
+            parent.lock.unlock();
+            // Give the parent's thread a chance to take the locks; without
+            // this, inserters below it could keep them busy enough that it
+            // never gets them.
+            if (parentBusy)
+                std::this_thread::yield();
+        }
+        if (i == 1) {
+            Slot &root = slot(1);
+            root.lock.lock();
+            if (root.tag == me)
+                root.tag = AVAILABLE;
+            root.lock.unlock();
+        }
+    } // insert()
+
+    // Description: Takes the element of the last slot, swaps it with the
+    //              root's and sifts it down. Returns the old root, or
+    //              nothing if the PQ was empty.
+    // Runtime: O(log(n)) without contention
+    std::optional<TYPE> remove() {
+        heapLock.lock();
+        const std::size_t c = count.load(std::memory_order_relaxed);
+        if (c == 0) {
+            heapLock.unlock();
+            return std::nullopt;
+        }
+        const std::size_t last = slotIndex(c);
+        Slot &bottom = slot(last);
+        bottom.lock.lock();
+        count.store(c - 1, std::memory_order_relaxed);
+        heapLock.unlock();
+        std::optional<TYPE> result = std::move(bottom.item);
+        bottom.item.reset();
+        bottom.tag = EMPTY;
+        bottom.lock.unlock();
+        // The last slot was the root. Checking the index, not the root's
+        // tag, matters: an insertion may already have refilled the root.
+        if (last == 1)
+            return result;
+
+        Slot &root = slot(1);
+        root.lock.lock();
+        if (root.tag == EMPTY) {
+            // A concurrent deletion took the root as its last slot.
+            root.lock.unlock();
+            return result;
+        }
+        std::swap(result, root.item);
+        root.tag = AVAILABLE;
+
+        // Sift down, holding the lock of the current node throughout.
+        std::size_t i = 1;
+        while (exists(2 * i)) {
+            Slot &current = slot(i);
+            Slot &left = slot(2 * i);
+            Slot &right = slot(2 * i + 1);
+            left.lock.lock();
+            right.lock.lock();
+            // Left slots of a level fill up first, so an empty left child
+            // means no children at all.
+            if (left.tag == EMPTY) {
+                right.lock.unlock();
+                left.lock.unlock();
+                break;
+            }
+            std::size_t j = 2 * i;
+            if (right.tag == EMPTY || !this->compare(*left.item, *right.item)) {
+                right.lock.unlock();
+            }
+            else {
+                left.lock.unlock();
+                ++j;
+            }
+            Slot &child = slot(j);
+            if (!this->compare(*current.item, *child.item)) {
+                child.lock.unlock();
+                break;
+            }
+            swapSlots(current, child);
+            current.lock.unlock();
+            i = j;
+        }
+        slot(i).lock.unlock();
+        return result;
+    } // remove()
+
+    // Description: Serial sift down for rebuilding, without locks.
+    // Runtime: O(log(n))
+    void fixDown(std::size_t i) {
+        while (exists(2 * i) && slot(2 * i).tag != EMPTY) {
+            std::size_t j = 2 * i;
+            if (slot(j + 1).tag != EMPTY && this->compare(*slot(j).item, *slot(j + 1).item))
+                ++j;
+            if (!this->compare(*slot(i).item, *slot(j).item))
+                break;
+            swapSlots(slot(i), slot(j));
+            i = j;
+        }
+    } // fixDown()
+}; // LockedHeapPQ
+
+
+#endif // LOCKEDHEAPPQ_H
@@ -0,0 +1,305 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef MULTIQUEUEPQ_H
+#define MULTIQUEUEPQ_H
+
+#include "BinaryPQ.h"
+#include "Eecs281PQ.h"
+#include "SpinLock.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+// A relaxed concurrent priority queue (Rihani, Sanders and Dementiev,
+// "MultiQueues: Simple Relaxed Concurrent Priority Queues", 2015). The
+// elements are spread over several BinaryPQ lanes, each behind its own
+// lock. push() adds to a random lane. try_pop() looks at the tops of
+// 'choices' random lanes and pops the best of them, so it returns an
+// element close to, but not necessarily at, the top. With more lanes than
+// threads, a thread almost never waits for a lock.
+//
+// The rank error of try_pop() (how many elements were more extreme than
+// the one it returned) is tuned by the constructor arguments: it grows
+// linearly with the number of lanes, and shrinks as 'choices' grows. With
+// two choices its expected value is O(lanes). pop(), pop_top() and top()
+// are exact instead: they lock every lane, so they serialize with
+// everything else.
+//
+// push(), pop(), pop_top(), try_pop(), size() and empty() may be called
+// from any number of threads at once. top() returns a reference into a
+// lane, and the copy constructor and updatePriorities() may only be used
+// while no other thread touches the queue. The comparator is called
+// concurrently and must be safe for that.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class MultiQueuePQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Description: Construct an empty PQ with an optional comparison
+    //              functor, number of lanes (0 means two per hardware
+    //              thread) and number of lanes try_pop() compares.
+    // Runtime: O(lanes)
+    explicit MultiQueuePQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), std::size_t lanes = 0, std::size_t choices = 2) :
+        BaseClass{ comp } {
+        if (lanes == 0)
+            lanes = 2 * std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        for (std::size_t i = 0; i < lanes; ++i)
+            queues.push_back(std::make_unique<Lane>(comp));
+        numChoices = std::min(std::max<std::size_t>(choices, 1), lanes);
+    } // MultiQueuePQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor, number of lanes and number of lanes
+    //              try_pop() compares, as above, dealing the elements out
+    //              to the lanes in turn.
+    // Runtime: O(n log(n / lanes)) where n is number of elements in range.
+    template<typename InputIterator>
+    MultiQueuePQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(), std::size_t lanes = 0,
+                 std::size_t choices = 2) :
+        MultiQueuePQ{ comp, lanes, choices } {
+        std::size_t n = 0;
+        for (; start != end; ++start)
+            queues[n++ % queues.size()]->heap.push(*start);
+        count.store(n, std::memory_order_relaxed);
+    } // MultiQueuePQ()
+
+
+    // Description: Copy constructor. other must not be modified meanwhile.
+    // Runtime: O(n)
+    MultiQueuePQ(const MultiQueuePQ &other) :
+        BaseClass{ other.compare }, numChoices{ other.numChoices } {
+        for (const std::unique_ptr<Lane> &lane : other.queues)
+            queues.push_back(std::make_unique<Lane>(*lane));
+        count.store(other.size(), std::memory_order_relaxed);
+    } // MultiQueuePQ()
+
+
+    // The lane locks cannot be handed over, so there is no assignment.
+    MultiQueuePQ &operator=(const MultiQueuePQ &) = delete;
+
+
+    // Description: Destructor doesn't need any code, the lanes are freed
+    //              automatically.
+    virtual ~MultiQueuePQ() {
+    } // ~MultiQueuePQ()
+
+
+    // Description: Rebuilds every lane after the elements changed priority.
+    //              Not thread safe.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        for (std::unique_ptr<Lane> &lane : queues)
+            lane->heap.updatePriorities();
+    } // updatePriorities()
+
+
+    // Description: Add a new element to a random lane. Thread safe.
+    // Runtime: O(log(n / lanes)) without contention
+    virtual void push(const TYPE &val) {
+        Lane &lane = lockRandomLane();
+        std::lock_guard<SpinLock> guard{ lane.lock, std::adopt_lock };
+        lane.heap.push(val);
+        // Counted while the lane lock still hides the element, so that a
+        // pop can never make the count wrap; a push that throws is not
+        // counted at all.
+        count.fetch_add(1, std::memory_order_relaxed);
+    } // push()
+
+
+    // Description: Add a new element to a random lane, moving from val.
+    //              Thread safe.
+    // Runtime: O(log(n / lanes)) without contention
+    virtual void push(TYPE &&val) {
+        Lane &lane = lockRandomLane();
+        std::lock_guard<SpinLock> guard{ lane.lock, std::adopt_lock };
+        lane.heap.push(std::move(val));
+        // Counted while the lane lock still hides the element, so that a
+        // pop can never make the count wrap; a push that throws is not
+        // counted at all.
+        count.fetch_add(1, std::memory_order_relaxed);
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ, exactly. Thread safe; the PQ must not be
+    //              empty.
+    // Runtime: O(lanes + log(n / lanes))
+    virtual void pop() {
+        pop_top();
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ, exactly, and return it by value. Thread
+    //              safe; the PQ must not be empty.
+    // Runtime: O(lanes + log(n / lanes))
+    virtual TYPE pop_top() {
+        AllLanes guard{ *this };
+        TYPE result = queues[bestLane()]->heap.pop_top();
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return result;
+    } // pop_top()
+
+
+    // Description: Remove an element close to the top into out: the best of
+    //              the tops of 'choices' random lanes. Returns false,
+    //              leaving out alone, if the PQ was empty. Thread safe.
+    // Runtime: O(choices + log(n / lanes)) expected, without contention
+    bool try_pop(TYPE &out) {
+        while (count.load(std::memory_order_relaxed) > 0) {
+            // Sampling keeps finding busy or empty lanes only when the PQ
+            // is nearly empty; then every lane is tried in turn.
+            for (std::size_t attempt = 0; attempt < queues.size(); ++attempt) {
+                if (popSampled(out))
+                    return true;
+            }
+            for (std::unique_ptr<Lane> &lane : queues) {
+                std::lock_guard<SpinLock> guard{ lane->lock };
+                if (!lane->heap.empty()) {
+                    out = lane->heap.pop_top();
+                    count.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    } // try_pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ. Not thread safe.
+    // Runtime: O(lanes)
+    virtual const TYPE &top() const {
+        return queues[bestLane()]->heap.top();
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ. Under concurrent
+    //              use, the number at some recent moment.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count.load(std::memory_order_relaxed);
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return size() == 0;
+    } // empty()
+
+
+    // Description: Number of lanes.
+    // Runtime: O(1)
+    std::size_t lanes() const {
+        return queues.size();
+    } // lanes()
+
+
+private:
+    // Each lane sits on its own cache lines, so that threads working on
+    // different lanes do not invalidate each other's.
+    struct alignas(64) Lane {
+        SpinLock lock;
+        BinaryPQ<TYPE, COMP_FUNCTOR> heap;
+
+        explicit Lane(const COMP_FUNCTOR &comp) : heap{ comp } {}
+        Lane(const Lane &other) : heap{ other.heap } {}
+    };
+
+    std::vector<std::unique_ptr<Lane>> queues;
+    std::size_t numChoices = 2;
+    std::atomic<std::size_t> count{ 0 };
+
+    // Description: A random lane index, from a generator per thread.
+    // Runtime: O(1)
+    std::size_t randomLane() const {
+        thread_local std::minstd_rand rng{ static_cast<std::minstd_rand::result_type>(
+            std::hash<std::thread::id>{}(std::this_thread::get_id())) };
+        return rng() % queues.size();
+    } // randomLane()
+
+    // Description: Locks some lane, trying random ones until one is free.
+    // Runtime: O(1) expected
+    Lane &lockRandomLane() {
+        while (true) {
+            Lane &lane = *queues[randomLane()];
+            if (lane.lock.try_lock())
+                return lane;
+        }
+    } // lockRandomLane()
+
+    // Description: Pops the best top among 'choices' random lanes that are
+    //              free and not empty. Lanes are only ever try-locked, so
+    //              holding two at once cannot deadlock. Returns false if
+    //              none qualified.
+    // Runtime: O(choices + log(n / lanes))
+    bool popSampled(TYPE &out) {
+        Lane *best = nullptr;
+        std::unique_lock<SpinLock> bestGuard;
+        for (std::size_t k = 0; k < numChoices; ++k) {
+            Lane &lane = *queues[randomLane()];
+            // A lane drawn twice fails here, as we already hold it.
+            std::unique_lock<SpinLock> guard{ lane.lock, std::try_to_lock };
+            if (!guard.owns_lock() || lane.heap.empty()
+                || (best != nullptr && !this->compare(best->heap.top(), lane.heap.top())))
+                continue;
+            // Releases the lane that was best so far.
+            bestGuard = std::move(guard);
+            best = &lane;
+        }
+        if (best == nullptr)
+            return false;
+        out = best->heap.pop_top();
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    } // popSampled()
+
+    // Description: Index of the lane with the most extreme top. At least
+    //              one lane must not be empty.
+    // Runtime: O(lanes)
+    std::size_t bestLane() const {
+        std::size_t best = queues.size();
+        for (std::size_t i = 0; i < queues.size(); ++i) {
+            if (queues[i]->heap.empty())
+                continue;
+            if (best == queues.size() || this->compare(queues[best]->heap.top(), queues[i]->heap.top()))
+                best = i;
+        }
+        return best;
+    } // bestLane()
+
+    // Holds every lane lock for its lifetime. Locks are always taken in lane
+    // order, so two of these cannot deadlock, and the other operations only
+    // try-lock or hold one lane at a time.
+    class AllLanes {
+    public:
+        explicit AllLanes(MultiQueuePQ &pq) : queues{ pq.queues } {
+            for (std::unique_ptr<Lane> &lane : queues)
+                lane->lock.lock();
+        } // AllLanes()
+
+        AllLanes(const AllLanes &) = delete;
+        AllLanes &operator=(const AllLanes &) = delete;
+
+        ~AllLanes() {
+            for (std::unique_ptr<Lane> &lane : queues)
+                lane->lock.unlock();
+        } // ~AllLanes()
+
+    private:
+        std::vector<std::unique_ptr<Lane>> &queues;
+    }; // AllLanes
+}; // MultiQueuePQ
+
+
+#endif // MULTIQUEUEPQ_H
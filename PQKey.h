@@ -0,0 +1,153 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PQKEY_H
+#define PQKEY_H
+
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+
+// Integer keys for the queues that look at the bits of the priorities
+// instead of comparing them (RadixPQ, TimerWheelPQ). PQKey<TYPE,
+// COMP_FUNCTOR> provides key_type, an unsigned integer type, and a static
+// key(val) that maps an element to a key_type so that the most extreme
+// element by COMP_FUNCTOR has the smallest key, and elements that
+// COMP_FUNCTOR considers equivalent have equal keys.
+//
+// Specializations are given for integers ordered by std::less or
+// std::greater, and for std::pair with an integer first member ordered by
+// FirstLess or FirstGreater below. Other element types can be used by
+// specializing PQKey for them.
+template<typename TYPE, typename COMP_FUNCTOR, typename = void>
+struct PQKey {};
+
+
+// Orders pairs by their first member alone, largest first (like
+// std::less, the top is the largest). Used for key-value pairs, whose
+// values need not be comparable.
+struct FirstLess {
+    template<typename PAIR>
+    bool operator()(const PAIR &a, const PAIR &b) const {
+        return a.first < b.first;
+    }
+};
+
+// Orders pairs by their first member alone, smallest first.
+struct FirstGreater {
+    template<typename PAIR>
+    bool operator()(const PAIR &a, const PAIR &b) const {
+        return a.first > b.first;
+    }
+};
+
+
+// Description: Maps an integer to an unsigned integer of the same width
+//              while keeping the order: signed values are offset by
+//              flipping their sign bit.
+// Runtime: O(1)
+template<typename INT>
+constexpr std::make_unsigned_t<INT> orderedBits(INT val) {
+    using Unsigned = std::make_unsigned_t<INT>;
+    if constexpr (std::is_signed<INT>::value)
+        return static_cast<Unsigned>(static_cast<Unsigned>(val) ^ (Unsigned{ 1 } << (std::numeric_limits<Unsigned>::digits - 1)));
+    else
+        return val;
+} // orderedBits()
+
+
+// Smallest integer first: the key is the integer itself.
+template<typename INT>
+struct PQKey<INT, std::greater<INT>, std::enable_if_t<std::is_integral<INT>::value && !std::is_same<INT, bool>::value>> {
+    using key_type = std::make_unsigned_t<INT>;
+
+    static constexpr key_type key(INT val) {
+        return orderedBits(val);
+    } // key()
+};
+
+// Largest integer first: the key counts down from the largest integer.
+template<typename INT>
+struct PQKey<INT, std::less<INT>, std::enable_if_t<std::is_integral<INT>::value && !std::is_same<INT, bool>::value>> {
+    using key_type = std::make_unsigned_t<INT>;
+
+    static constexpr key_type key(INT val) {
+        return static_cast<key_type>(~orderedBits(val));
+    } // key()
+};
+
+// Key-value pairs, smallest key first.
+template<typename KEY, typename VALUE>
+struct PQKey<std::pair<KEY, VALUE>, FirstGreater, std::enable_if_t<std::is_integral<KEY>::value>> {
+    using key_type = typename PQKey<KEY, std::greater<KEY>>::key_type;
+
+    static constexpr key_type key(const std::pair<KEY, VALUE> &val) {
+        return PQKey<KEY, std::greater<KEY>>::key(val.first);
+    } // key()
+};
+
+// Key-value pairs, largest key first.
+template<typename KEY, typename VALUE>
+struct PQKey<std::pair<KEY, VALUE>, FirstLess, std::enable_if_t<std::is_integral<KEY>::value>> {
+    using key_type = typename PQKey<KEY, std::less<KEY>>::key_type;
+
+    static constexpr key_type key(const std::pair<KEY, VALUE> &val) {
+        return PQKey<KEY, std::less<KEY>>::key(val.first);
+    } // key()
+};
+
+
+// Integer priorities for the queues that keep one bucket per priority
+// (BucketPQ). PriorityOf is the default key extractor: an integer is its own
+// priority, a pair's priority is its first member.
+struct PriorityOf {
+    template<typename INT, typename = std::enable_if_t<std::is_integral<INT>::value>>
+    INT operator()(INT val) const {
+        return val;
+    } // operator()()
+
+    template<typename KEY, typename VALUE>
+    KEY operator()(const std::pair<KEY, VALUE> &val) const {
+        return val.first;
+    } // operator()()
+};
+
+
+// Which end of the priorities COMP_FUNCTOR puts on top: HighestFirst<COMP>
+// provides value, true when the element with the highest priority is the
+// most extreme one. Given for std::less, std::greater, FirstLess and
+// FirstGreater; other comparators can specialize it.
+template<typename COMP_FUNCTOR>
+struct HighestFirst {};
+
+template<typename TYPE>
+struct HighestFirst<std::less<TYPE>> : std::true_type {};
+
+template<typename TYPE>
+struct HighestFirst<std::greater<TYPE>> : std::false_type {};
+
+template<>
+struct HighestFirst<FirstLess> : std::true_type {};
+
+template<>
+struct HighestFirst<FirstGreater> : std::false_type {};
+
+
+// True when HighestFirst<COMP_FUNCTOR> has been specialized.
+template<typename COMP_FUNCTOR, typename = void>
+struct HasHighestFirst : std::false_type {};
+
+template<typename COMP_FUNCTOR>
+struct HasHighestFirst<COMP_FUNCTOR, std::void_t<decltype(HighestFirst<COMP_FUNCTOR>::value)>> : std::true_type {};
+
+
+// True when PQKey<TYPE, COMP_FUNCTOR> has been specialized.
+template<typename TYPE, typename COMP_FUNCTOR, typename = void>
+struct HasPQKey : std::false_type {};
+
+template<typename TYPE, typename COMP_FUNCTOR>
+struct HasPQKey<TYPE, COMP_FUNCTOR, std::void_t<typename PQKey<TYPE, COMP_FUNCTOR>::key_type>> : std::true_type {};
+
+
+#endif // PQKEY_H
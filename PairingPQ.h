@@ -4,93 +4,185 @@
 #define PAIRINGPQ_H
 
 #include "Eecs281PQ.h"
-#include <deque>
+#include "PoolAllocator.h"
+#include <iterator>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+// Each node within a PairingPQ, outside of it so that PairingPQ can name
+// its allocator in its list of base classes.
+template<typename TYPE>
+class PairingNode {
+    public:
+        // TODO: After you add add one extra pointer (see below), be sure
+        // to initialize it here.
+        explicit PairingNode(const TYPE &val)
+            : elt{ val }, child{ nullptr }, sibling{ nullptr }, prev{ nullptr }
+        {}
+
+        explicit PairingNode(TYPE &&val)
+            : elt{ std::move(val) }, child{ nullptr }, sibling{ nullptr }, prev{ nullptr }
+        {}
+
+        // Constructs the element in place from args (used by emplace()).
+        template<typename... Args>
+        explicit PairingNode(std::in_place_t, Args &&...args)
+            : elt(std::forward<Args>(args)...), child{ nullptr }, sibling{ nullptr }, prev{ nullptr }
+        {}
+
+        // Description: Allows access to the element at that Node's
+        // position.  There are two versions, getElt() and a dereference
+        // operator, use whichever one seems more natural to you.
+        // Runtime: O(1) - this has been provided for you.
+        const TYPE &getElt() const { return elt; }
+        const TYPE &operator*() const { return elt; }
+
+        // The following line allows you to access any private data
+        // members of this Node class from within the PairingPQ class.
+        // (ie: myNode.elt is a legal statement in PairingPQ's add_node()
+        // function).
+        template<typename, typename, typename>
+        friend class PairingPQ;
+
+    private:
+        TYPE elt;
+        PairingNode *child;
+        PairingNode *sibling;
+        // The parent for a leftmost child, the left sibling for any
+        // other child, nullptr for the root. A node can therefore be
+        // unlinked in O(1) however long its sibling list is.
+        PairingNode *prev;
+}; // PairingNode
+
+
+// Holds the node allocator of a PairingPQ as a base class rather than a
+// member variable, so that an empty allocator such as std::allocator takes
+// no space at all.
+template<typename NODE_ALLOCATOR>
+class PairingAllocatorBase : private NODE_ALLOCATOR {
+protected:
+    explicit PairingAllocatorBase(const NODE_ALLOCATOR &allocator) : NODE_ALLOCATOR{ allocator } {}
+
+    NODE_ALLOCATOR &nodeAllocator() { return *this; }
+    const NODE_ALLOCATOR &nodeAllocator() const { return *this; }
+}; // PairingAllocatorBase
 
 // A specialized version of the priority queue ADT implemented as a pairing
-// heap.
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class PairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+// heap. Nodes are obtained from ALLOCATOR (rebound to Node); the default
+// PoolAllocator recycles freed nodes instead of returning them to the
+// system allocator.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename ALLOCATOR = PoolAllocator<TYPE>>
+class PairingPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR>,
+                        private PairingAllocatorBase<
+                            typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<PairingNode<TYPE>>> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+    using NodeAllocator = typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<PairingNode<TYPE>>;
+    using AllocatorBase = PairingAllocatorBase<NodeAllocator>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
 
 public:
+    // The allocator base has a value_type of its own; this is the PQ's.
+    using typename BaseClass::value_type;
+
     // Each node within the pairing heap
-    class Node {
-        public:
-            // TODO: After you add add one extra pointer (see below), be sure
-            // to initialize it here.
-            explicit Node(const TYPE &val)
-                : elt{ val }, child{ nullptr }, sibling{ nullptr }, parent{ nullptr }
-            {}
-
-            // Description: Allows access to the element at that Node's
-            // position.  There are two versions, getElt() and a dereference
-            // operator, use whichever one seems more natural to you.
-            // Runtime: O(1) - this has been provided for you.
-            const TYPE &getElt() const { return elt; }
-            const TYPE &operator*() const { return elt; }
-
-            // The following line allows you to access any private data
-            // members of this Node class from within the PairingPQ class.
-            // (ie: myNode.elt is a legal statement in PairingPQ's add_node()
-            // function).
-            friend PairingPQ;
-
-        private:
-            TYPE elt;
-            Node *child;
-            Node *sibling;
-            Node *parent;
-            // TODO: Add one extra pointer (parent or previous) as desired.
-    }; // Node
+    using Node = PairingNode<TYPE>;
+
+
+    using allocator_type = ALLOCATOR;
 
 
     // Description: Construct an empty pairing heap with an optional
-    //              comparison functor.
+    //              comparison functor and allocator.
     // Runtime: O(1)
-    explicit PairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp } {
+    explicit PairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const ALLOCATOR &allocator = ALLOCATOR()) :
+        BaseClass{ comp }, AllocatorBase{ NodeAllocator(allocator) } {
         // TODO: Implement this function.
     } // PairingPQ()
 
 
     // Description: Construct a pairing heap out of an iterator range with an
-    //              optional comparison functor.
+    //              optional comparison functor and allocator. The nodes
+    //              come from one slab when the range size is known and the
+    //              allocator is a PoolAllocator, and are linked with a
+    //              single multipass pairing instead of n melds into the
+    //              root.
     // Runtime: O(n) where n is number of elements in range.
     template<typename InputIterator>
-    PairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp } {
+    PairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+              const ALLOCATOR &allocator = ALLOCATOR()) :
+        BaseClass{ comp }, AllocatorBase{ NodeAllocator(allocator) } {
         // TODO: Implement this function.
-        while (start != end) {
-            push(*start);
-            ++start;
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+            reserveNodes(static_cast<std::size_t>(std::distance(start, end)));
+        }
+
+        // Nodes are paired as they are created, while they are still in
+        // cache. Until the end, root is the pairing stack.
+        try {
+            for (; start != end; ++start) {
+                root = pushPaired(root, createNode(*start), ++numN);
+            }
         }
+        catch (...) {
+            clear();
+            throw;
+        }
+        root = finishPaired(root);
     } // PairingPQ()
 
 
-    // Description: Copy constructor.
+    // Description: Copy constructor. Clones the shape of other node for
+    //              node instead of melding the elements again.
     // Runtime: O(n)
     PairingPQ(const PairingPQ &other) :
-        BaseClass{ other.compare } {
+        BaseClass{ other.compare },
+        AllocatorBase{ NodeTraits::select_on_container_copy_construction(other.nodeAllocator()) } {
         // TODO: Implement this function.
-        std::deque<Node*> cont;
-        if (other.root != nullptr) {
-            cont.push_back(other.root);
-            while(!cont.empty()) {
-                Node* node = cont.front();
-                if (node->sibling != nullptr) {
-                    cont.push_back(node->sibling);
+        if (other.root == nullptr) {
+            return;
+        }
+        reserveNodes(other.numN);
+
+        // Preorder walk of other: down through child, across through
+        // sibling, and back up to the parent when a subtree is done. dst
+        // follows src in the copy, which is a valid (partial) pairing heap
+        // at every step, so clear() can free it if an element throws.
+        try {
+            root = createNode(other.root->elt);
+            numN = 1;
+            const Node* src = other.root;
+            Node* dst = root;
+            while (true) {
+                if (src->child != nullptr) {
+                    dst->child = createNode(src->child->elt);
+                    dst->child->prev = dst;
+                    src = src->child;
+                    dst = dst->child;
+                    numN++;
+                    continue;
                 }
-                if (node->child != nullptr) {
-                    cont.push_back(node->child);
+                while (src != nullptr && src->sibling == nullptr) {
+                    src = parentOf(src);
+                    dst = parentOf(dst);
                 }
-                push(node->getElt());
-                cont.pop_front();
+                if (src == nullptr) {
+                    break;
+                }
+                dst->sibling = createNode(src->sibling->elt);
+                dst->sibling->prev = dst;
+                src = src->sibling;
+                dst = dst->sibling;
+                numN++;
             }
         }
-        // NOTE: The structure does not have to be identical to the original,
-        //       but it must still be a valid pairing heap.
+        catch (...) {
+            clear();
+            throw;
+        }
     } // PairingPQ()
 
 
@@ -103,6 +195,7 @@ public:
         PairingPQ temp(rhs);
         std::swap(numN, temp.numN);
         std::swap(root, temp.root);
+        std::swap(this->nodeAllocator(), temp.nodeAllocator());
         return *this;
     } // operator=()
 
@@ -111,23 +204,26 @@ public:
     // Runtime: O(n)
     ~PairingPQ() {
         // TODO: Implement this function.
-        std::deque<Node*> cont;
-        if (root) {
-            cont.push_back(root);
-            while (!cont.empty()) {
-                Node* node = cont.front();
-                if (node->sibling != nullptr) {
-                    cont.push_back(node->sibling);
-                }
-                if (node->child != nullptr) {
-                    cont.push_back(node->child);
-                }
-                --numN;
-                delete node;
-                cont.pop_front();
+        clear();
+    } // ~PairingPQ()
+
+
+    // Description: Removes every element from the pairing heap. With the
+    //              default PoolAllocator and a trivially destructible TYPE
+    //              the nodes are not visited: the pool's slabs are freed
+    //              all at once.
+    // Runtime: O(n), O(log(n)) with PoolAllocator and trivial TYPE
+    void clear() {
+        if (!releaseAll()) {
+            Node* list = root;
+            while (list != nullptr) {
+                Node* node = unlinkNext(list);
+                destroyNode(node);
             }
         }
-    } // ~PairingPQ()
+        root = nullptr;
+        numN = 0;
+    } // clear()
 
 
     // Description: Assumes that all elements inside the pairing heap are out
@@ -137,28 +233,56 @@ public:
     // Runtime: O(n)
     virtual void updatePriorities() {
         // TODO: Implement this function.
-        std::deque<Node*> cont;
-        Node* node = root;
-        if (node->child) {
-            cont.push_back(node->child);
+        // Take the tree apart into one list of single nodes, then pair them
+        // up with multipass pairing, as the range constructor does.
+        Node* list = root;
+        Node* singles = nullptr;
+        while (list != nullptr) {
+            Node* node = unlinkNext(list);
+            node->prev = nullptr;
+            node->sibling = singles;
+            singles = node;
         }
-        node->child = nullptr;
-        
-        while (!cont.empty()) {
-            node = cont.front();
-            if (node->sibling != nullptr) {
-                cont.push_back(node->sibling);
-            }
-            if (node->child != nullptr) {
-                cont.push_back(node->child);
+        root = multipass(singles);
+    } // updatePriorities()
+
+
+    // Description: Repairs the pairing heap after the elements in 'changed'
+    //              were modified in place. One walk over the tree finds
+    //              their nodes without calling the comparator; each node is
+    //              then reinserted as updateElt() does for a value that is
+    //              not more extreme. Rebuilds the whole heap when many
+    //              elements changed or TYPE cannot be searched.
+    // Runtime: O(n log(k)) plus amortized O(log(n)) per changed element
+    virtual void notifyChanged(const std::vector<TYPE> &changed) {
+        if constexpr (ChangedSet<TYPE>::SEARCHABLE) {
+            if (!BaseClass::rebuildCheaper(changed.size(), numN)) {
+                ChangedSet<TYPE> dirty{ changed };
+                std::vector<Node*> nodes;
+                for (Node* node = root; node != nullptr; node = nextInPreorder(node)) {
+                    if (dirty.contains(node->elt))
+                        nodes.push_back(node);
+                }
+                for (Node* node : nodes)
+                    reinsert(node);
+                return;
             }
-            node->child = nullptr;
-            node->sibling = nullptr;
-            node->parent = nullptr;
-            root = meld(root, node);
-            cont.pop_front();
         }
-    } // updatePriorities()
+        BaseClass::notifyChanged(changed);
+    } // notifyChanged()
+
+
+    // Description: Same as above for elements given by Node*, which needs no
+    //              search.
+    // Runtime: Amortized O(log(n)) per changed element
+    void notifyChangedNodes(const std::vector<Node*> &changed) {
+        if (BaseClass::rebuildCheaper(changed.size(), numN)) {
+            updatePriorities();
+            return;
+        }
+        for (Node* node : changed)
+            reinsert(node);
+    } // notifyChangedNodes()
 
 
     // Description: Add a new element to the pairing heap. This is already
@@ -171,6 +295,22 @@ public:
     } // push()
 
 
+    // Description: Add a new element to the pairing heap, moving from val.
+    // Runtime: O(1)
+    virtual void push(TYPE &&val) {
+        addNode(std::move(val));
+    } // push()
+
+
+    // Description: Add a new element to the pairing heap, constructed in
+    //              place inside its Node from args.
+    // Runtime: O(1)
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        linkNode(createNode(std::in_place, std::forward<Args>(args)...));
+    } // emplace()
+
+
     // Description: Remove the most extreme (defined by 'compare') element
     //              from the pairing heap.
     // Note: We will not run tests on your code that would require it to pop
@@ -180,38 +320,24 @@ public:
     // Runtime: Amortized O(log(n))
     virtual void pop() {
         // TODO: Implement this function.
-        std::deque<Node*> cont;
-        Node* node = root->child;
-        if (node) {
-            while (node) {
-                cont.push_back(node);
-                node = node->sibling;
-            }
-            while (cont.size() > 1) {
-                node = cont.front();
-                node->sibling = nullptr;
-                node->parent = nullptr;
-                cont.pop_front();
-
-                cont.front()->sibling = nullptr;
-                cont.front()->parent = nullptr;
-
-                cont.push_back(meld(node, cont.front()));
-                cont.pop_front();
-            }
-            delete root;
-            root = cont.front();
-            cont.pop_front();
-        }
-        else {
-            delete root;
-            root = nullptr;
-        }
+        Node* old = root;
+        root = combine(old->child);
+        destroyNode(old);
         --numN;
-
     } // pop()
 
 
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the pairing heap and return it by value (moved, not
+    //              copied).
+    // Runtime: Amortized O(log(n))
+    virtual TYPE pop_top() {
+        TYPE result = std::move(root->elt);
+        pop();
+        return result;
+    } // pop_top()
+
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the pairing heap. This should be a reference for speed.
     //              It MUST be const because we cannot allow it to be
@@ -243,34 +369,92 @@ public:
     //              heap by replacing the element refered to by the Node with
     //              new_value.  Must maintain pairing heap invariants.
     //
-    // PRECONDITION: The new priority, given by 'new_value' must be more
-    //              extreme (as defined by comp) than the old priority.
+    //              new_value may be more or less extreme than the old value.
+    //              A more extreme node is cut out with its subtree and
+    //              melded with the root. Otherwise the node is cut out
+    //              alone: its children are paired into one tree as in pop(),
+    //              and both are melded back with the root. That also covers
+    //              elements that compare equal before and after, such as
+    //              pointers whose pointees changed.
     //
-    // Runtime: As discussed in reading material.
+    // Runtime: Amortized O(log(n)) when the value becomes less extreme;
+    //          O(1) when it becomes more extreme (amortized O(log(n)) in
+    //          the worst-case analysis of pairing heaps).
     void updateElt(Node* node, const TYPE &new_value) {
+        updateElt(node, TYPE(new_value));
+    } // updateElt()
+
+
+    // Description: Same as above, but moves new_value into the Node.
+    // Runtime: As above.
+    void updateElt(Node* node, TYPE &&new_value) {
         // TODO: Implement this function
-        node->elt = new_value;
-        if (node->parent != nullptr) {
-            if (this->compare(node->parent->elt, node->elt)) {
-                Node* traverse = node->parent->child;
-                if (traverse == node) {
-                    node->parent->child = node->sibling;
-                }
-                else {
-                    while (traverse->sibling != node) {
-                        traverse = traverse->sibling;
-                    }
-                    traverse->sibling = node->sibling;
-                }
+        const bool promoted = this->compare(node->elt, new_value);
+        node->elt = std::move(new_value);
 
-                node->parent = nullptr;
-                node->sibling = nullptr;
-                root = meld(root, node);
-            }
+        if (!promoted) {
+            reinsert(node);
+            return;
         }
+
+        // A leftmost child's prev is its parent; if that still wins, the
+        // heap is in order. Other children are cut without looking.
+        if (node == root || (node->prev->child == node && !this->compare(node->prev->elt, node->elt))) {
+            return;
+        }
+        cut(node);
+        root = meld(root, node);
     } // updateElt()
 
 
+    // Description: Removes the element refered to by node from the pairing
+    //              heap, wherever it is. The node is destroyed, so node must
+    //              not be used afterwards.
+    // Runtime: Amortized O(log(n))
+    void erase(Node* node) {
+        if (node == root) {
+            pop();
+            return;
+        }
+        cut(node);
+        Node* rest = combine(node->child);
+        if (rest != nullptr) {
+            root = meld(root, rest);
+        }
+        destroyNode(node);
+        --numN;
+    } // erase()
+
+
+    // Description: Moves every element of other into this pairing heap and
+    //              leaves other empty. other's root is melded with this
+    //              root, so the nodes themselves move over: Node* handles
+    //              into other stay valid, and now refer to this heap. That
+    //              needs this allocator to be able to free other's nodes:
+    //              equal allocators can, and a PoolAllocator takes over the
+    //              pool of the other heap. Otherwise the elements are
+    //              popped from other and pushed here one by one. other must
+    //              order elements the same way as this heap.
+    // Runtime: O(1) with equal allocators; O(log(m) + blocks freed by other)
+    //          with separate PoolAllocators; O(m log(m)) otherwise, for m
+    //          elements in other.
+    void merge(PairingPQ &&other) {
+        if (&other == this || other.root == nullptr) {
+            return;
+        }
+        if (!adoptNodes(other)) {
+            while (!other.empty()) {
+                push(other.pop_top());
+            }
+            return;
+        }
+        root = (root != nullptr) ? meld(root, other.root) : other.root;
+        numN += other.numN;
+        other.root = nullptr;
+        other.numN = 0;
+    } // merge()
+
+
     // Description: Add a new element to the pairing heap. Returns a Node*
     //              corresponding to the newly added element.
     // Runtime: O(1)
@@ -280,15 +464,14 @@ public:
     //       when you implement updateElt() and updatePriorities().
     Node* addNode(const TYPE &val) {
         // TODO: Implement this function
-        Node* node = new Node{val};
-        if (root != nullptr) {
-            root = meld(root, node);  
-        }
-        else {
-            root = node;
-        }
-        numN++;
-        return node;
+        return linkNode(createNode(val));
+    } // addNode()
+
+
+    // Description: Same as above, but moves val into the new Node.
+    // Runtime: O(1)
+    Node* addNode(TYPE &&val) {
+        return linkNode(createNode(std::move(val)));
     } // addNode()
 
 
@@ -300,21 +483,272 @@ private:
     // TODO: We recommend creating a 'meld' function (see the Pairing Heap
     // papers).
 
+    // Description: Allocates a node from the allocator and constructs it from args.
+    // Runtime: O(1)
+    template<typename... Args>
+    Node* createNode(Args &&...args) {
+        Node* node = NodeTraits::allocate(this->nodeAllocator(), 1);
+        try {
+            ::new (static_cast<void*>(node)) Node(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            NodeTraits::deallocate(this->nodeAllocator(), node, 1);
+            throw;
+        }
+        return node;
+    } // createNode()
+
+    // Description: Destroys a node and gives it back to the allocator.
+    // Runtime: O(1)
+    void destroyNode(Node* node) {
+        node->~Node();
+        NodeTraits::deallocate(this->nodeAllocator(), node, 1);
+    } // destroyNode()
+
+    // Description: Frees every node without visiting them, which is only
+    //              possible when elements need no destructor and the
+    //              allocator is a PoolAllocator nobody else shares. Returns
+    //              false if the nodes have to be destroyed one by one.
+    // Runtime: O(log(n))
+    bool releaseAll() {
+        if constexpr (std::is_trivially_destructible<TYPE>::value
+                      && std::is_same<NodeAllocator, PoolAllocator<Node>>::value) {
+            return this->nodeAllocator().release();
+        }
+        else {
+            return false;
+        }
+    } // releaseAll()
+
+    // Description: Two-pass pairing of the sibling list starting at first:
+    //              meld pairs left to right, then meld the results right to
+    //              left. Works in place on the sibling links, so it never
+    //              allocates. Returns the new root (nullptr for an empty
+    //              list).
+    // Runtime: O(length of the list)
+    Node* combine(Node* first) {
+        // First pass. The pair winners are chained through sibling in
+        // reverse order, which is the order the second pass needs.
+        Node* pairs = nullptr;
+        while (first != nullptr) {
+            Node* a = first;
+            Node* b = a->sibling;
+            first = (b != nullptr) ? b->sibling : nullptr;
+            a->sibling = nullptr;
+            a->prev = nullptr;
+            if (b != nullptr) {
+                b->sibling = nullptr;
+                b->prev = nullptr;
+                a = meld(a, b);
+            }
+            a->sibling = pairs;
+            pairs = a;
+        }
+
+        // Second pass.
+        Node* result = pairs;
+        if (result != nullptr) {
+            pairs = result->sibling;
+            result->sibling = nullptr;
+        }
+        while (pairs != nullptr) {
+            Node* next = pairs->sibling;
+            pairs->sibling = nullptr;
+            result = meld(result, pairs);
+            pairs = next;
+        }
+        return result;
+    } // combine()
+
+    // Multipass pairing melds trees of equal size in pairs, round after
+    // round, until one is left. Unlike combine(), which leaves a root with
+    // n/2 children when given n single nodes, this builds a balanced,
+    // binomial-like tree. The rounds are run in binary counter order rather
+    // than as a FIFO queue: after the i-th node is added, the top ctz(i)
+    // trees of a stack are melded, so every meld touches recently used
+    // nodes. The stack is linked through sibling, top first, which keeps it
+    // a chain of trees that clear() can take apart at any point.
+
+    // Description: Adds a single node, the count-th, to a pairing stack.
+    // Runtime: O(1) amortized
+    Node* pushPaired(Node* stack, Node* node, std::size_t count) {
+        node->sibling = nullptr;
+        node->prev = nullptr;
+        for (std::size_t i = count; (i & 1) == 0; i >>= 1) {
+            Node* below = stack;
+            stack = below->sibling;
+            below->sibling = nullptr;
+            node = meld(below, node);
+        }
+        node->sibling = stack;
+        return node;
+    } // pushPaired()
+
+    // Description: Melds the trees left on a pairing stack, one per set bit
+    //              of the node count, and returns the root.
+    // Runtime: O(log(n))
+    Node* finishPaired(Node* stack) {
+        Node* result = stack;
+        if (result != nullptr) {
+            stack = result->sibling;
+            result->sibling = nullptr;
+        }
+        while (stack != nullptr) {
+            Node* next = stack->sibling;
+            stack->sibling = nullptr;
+            result = meld(stack, result);
+            stack = next;
+        }
+        return result;
+    } // finishPaired()
+
+    // Description: Multipass pairing of the sibling list starting at first.
+    //              Returns the new root (nullptr for an empty list).
+    // Runtime: O(length of the list)
+    Node* multipass(Node* first) {
+        Node* stack = nullptr;
+        std::size_t count = 0;
+        while (first != nullptr) {
+            Node* node = first;
+            first = node->sibling;
+            stack = pushPaired(stack, node, ++count);
+        }
+        return finishPaired(stack);
+    } // multipass()
+
+    // Description: Makes the allocator able to free the nodes of other: true if it
+    //              already can, or if it took over other's pool.
+    // Runtime: O(1), or see PoolAllocator::adopt()
+    bool adoptNodes(PairingPQ &other) {
+        if (this->nodeAllocator() == other.nodeAllocator()) {
+            return true;
+        }
+        if constexpr (std::is_same<NodeAllocator, PoolAllocator<Node>>::value) {
+            return this->nodeAllocator().adopt(other.nodeAllocator());
+        }
+        else {
+            return false;
+        }
+    } // adoptNodes()
+
+    // Description: With a PoolAllocator, asks the pool for n nodes in one
+    //              slab. Other allocators allocate node by node anyway.
+    // Runtime: O(1) amortized
+    void reserveNodes(std::size_t n) {
+        if constexpr (std::is_same<NodeAllocator, PoolAllocator<Node>>::value) {
+            this->nodeAllocator().reserve(n);
+        }
+    } // reserveNodes()
+
+    // Description: Takes apart a tree without extra memory. list is a chain
+    //              of nodes linked through sibling; while the head still has
+    //              children, its first child is moved in front of it. Once
+    //              the head is childless it is unlinked and returned, and
+    //              list advances. Every node is moved at most once per
+    //              child, so draining a tree of n nodes is O(n).
+    // Runtime: O(1) amortized
+    static Node* unlinkNext(Node* &list) {
+        while (list->child != nullptr) {
+            Node* first = list->child;
+            list->child = first->sibling;
+            first->sibling = list;
+            list = first;
+        }
+        Node* node = list;
+        list = node->sibling;
+        return node;
+    } // unlinkNext()
+
+    // Description: Melds a freshly allocated node into the heap.
+    // Runtime: O(1)
+    Node* linkNode(Node* node) {
+        if (root != nullptr) {
+            root = meld(root, node);
+        }
+        else {
+            root = node;
+        }
+        numN++;
+        return node;
+    } // linkNode()
+
+    // Description: Melds two trees whose roots have no siblings: the less
+    //              extreme root becomes the leftmost child of the other.
+    //              Returns the new root.
+    // Runtime: O(1)
     Node* meld(Node* a, Node* b) {
         if (this->compare(a->elt, b->elt)) {
-            a->sibling = b->child;
-            a->parent = b;
-            b->child = a;
-            return b;
+            std::swap(a, b);
+        }
+        b->sibling = a->child;
+        if (a->child != nullptr) {
+            a->child->prev = b;
+        }
+        b->prev = a;
+        a->child = b;
+        return a;
+    } // meld()
+
+    // Description: Unlinks node, with its subtree, from its parent's child
+    //              list. node must not be the root.
+    // Runtime: O(1)
+    static void cut(Node* node) {
+        if (node->prev->child == node) {
+            node->prev->child = node->sibling;
         }
         else {
-            b->sibling = a->child;
-            b->parent = a;
-            a->child = b;
-            return a;
+            node->prev->sibling = node->sibling;
+        }
+        if (node->sibling != nullptr) {
+            node->sibling->prev = node->prev;
+        }
+        node->prev = nullptr;
+        node->sibling = nullptr;
+    } // cut()
+
+    // Description: Cuts node out of the heap alone, pairs its children into
+    //              one tree as pop() does, and melds both back with the
+    //              root. Afterwards node is ordered correctly whatever its
+    //              element became. When several nodes are reinserted in a
+    //              row, links to a node that is still out of order are
+    //              undone once that node's turn comes.
+    // Runtime: Amortized O(log(n))
+    void reinsert(Node* node) {
+        Node* children = node->child;
+        node->child = nullptr;
+        if (node != root) {
+            cut(node);
+            root = meld(root, node);
+        }
+        Node* rest = combine(children);
+        if (rest != nullptr) {
+            root = meld(root, rest);
+        }
+    } // reinsert()
+
+    // Description: Returns the node after node in a preorder walk (down
+    //              through child, across through sibling, back up when a
+    //              subtree is done), or nullptr at the end.
+    // Runtime: O(1) amortized over a whole walk
+    static Node* nextInPreorder(Node* node) {
+        if (node->child != nullptr) {
+            return node->child;
+        }
+        while (node != nullptr && node->sibling == nullptr) {
+            node = parentOf(node);
+        }
+        return (node != nullptr) ? node->sibling : nullptr;
+    } // nextInPreorder()
+
+    // Description: Returns the parent of node, or nullptr for the root, by
+    //              walking left to the leftmost sibling.
+    // Runtime: O(number of left siblings)
+    static Node* parentOf(const Node* node) {
+        while (node->prev != nullptr && node->prev->child != node) {
+            node = node->prev;
         }
-        return nullptr;
-    }
+        return node->prev;
+    } // parentOf()
     // NOTE: For member variables, you are only allowed to add a "root
     //       pointer" and a "count" of the number of nodes. Anything else
     //       (such as a deque) should be declared inside of member functions
@@ -0,0 +1,125 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PARALLELREBUILD_H
+#define PARALLELREBUILD_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+
+// Threads that the array-based queues (BinaryPQ, SortedPQ) may use to
+// rebuild themselves in updatePriorities() and their range constructors.
+// The default of 1 keeps every rebuild serial. The setting is shared by
+// the whole process, like the thread count of an OpenMP runtime, so a
+// queue built from a range can pick it up before it has been constructed.
+inline std::atomic<std::size_t> &rebuildThreadSetting() {
+    static std::atomic<std::size_t> threads{ 1 };
+    return threads;
+} // rebuildThreadSetting()
+
+
+// Description: Sets how many threads a rebuild may use; 0 means one per
+//              hardware thread.
+// Runtime: O(1)
+inline void setRebuildThreads(std::size_t threads) {
+    if (threads == 0)
+        threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    rebuildThreadSetting().store(threads, std::memory_order_relaxed);
+} // setRebuildThreads()
+
+
+// Description: Returns the setting made with setRebuildThreads().
+// Runtime: O(1)
+inline std::size_t rebuildThreads() {
+    return rebuildThreadSetting().load(std::memory_order_relaxed);
+} // rebuildThreads()
+
+
+// Below this many elements per thread, starting the threads costs more than
+// they save, so rebuildWorkers() asks for fewer of them.
+constexpr std::size_t PARALLEL_REBUILD_GRAIN = 32768;
+
+
+// Description: Number of threads to rebuild n elements with: the setting,
+//              capped so that each thread gets at least
+//              PARALLEL_REBUILD_GRAIN elements. 1 means stay serial.
+// Runtime: O(1)
+inline std::size_t rebuildWorkers(std::size_t n) {
+    return std::max<std::size_t>(std::min(rebuildThreads(), n / PARALLEL_REBUILD_GRAIN), 1);
+} // rebuildWorkers()
+
+
+// Description: Runs task(i) for every i in [0, count) on up to 'threads'
+//              threads, the calling one included, and returns when all are
+//              done. Tasks are handed out one at a time, so uneven tasks
+//              still balance. If a task throws, the remaining ones are
+//              skipped and the first exception is rethrown here.
+// Runtime: O(count / threads) tasks per thread
+template<typename Task>
+void parallelFor(std::size_t threads, std::size_t count, const Task &task) {
+    std::atomic<std::size_t> next{ 0 };
+    std::exception_ptr failure;
+    std::mutex failureLock;
+    auto work = [&]() {
+        for (std::size_t i = next++; i < count; i = next++) {
+            try {
+                task(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock{ failureLock };
+                if (!failure)
+                    failure = std::current_exception();
+                next = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    try {
+        for (std::size_t t = 1; t < std::min(threads, count); ++t)
+            helpers.emplace_back(work);
+    }
+    catch (const std::system_error &) {
+        // Out of threads: the ones already running finish the job.
+    }
+    work();
+    for (std::thread &helper : helpers)
+        helper.join();
+    if (failure)
+        std::rethrow_exception(failure);
+} // parallelFor()
+
+
+// Description: Sorts [first, last) with up to 'threads' threads: one
+//              std::sort per chunk, then rounds of pairwise inplace_merge,
+//              each round merging twice as long runs as the one before.
+// Runtime: O(n log(n) / threads + n log(threads))
+template<typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp, std::size_t threads) {
+    using Diff = typename std::iterator_traits<RandomIt>::difference_type;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    std::vector<RandomIt> bounds;
+    for (std::size_t i = 0; i <= threads; ++i)
+        bounds.push_back(first + static_cast<Diff>(n * i / threads));
+
+    parallelFor(threads, threads, [&](std::size_t i) {
+        std::sort(bounds[i], bounds[i + 1], comp);
+    });
+    for (std::size_t width = 1; width < threads; width *= 2) {
+        std::size_t pairs = (threads - width + 2 * width - 1) / (2 * width);
+        parallelFor(threads, pairs, [&](std::size_t j) {
+            std::size_t lo = 2 * width * j;
+            std::inplace_merge(bounds[lo], bounds[lo + width], bounds[std::min(lo + 2 * width, threads)], comp);
+        });
+    }
+} // parallelSort()
+
+
+#endif // PARALLELREBUILD_H
@@ -0,0 +1,286 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef POOLALLOCATOR_H
+#define POOLALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+
+// A pool of equally sized blocks carved out of large slabs. Freed blocks go
+// on a free list and are handed out again before any new slab is touched,
+// so a heap that churns through nodes stops calling the system allocator
+// once it has reached its peak size.
+class NodePool {
+public:
+    NodePool() = default;
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    ~NodePool() {
+        releaseSlabs();
+    } // ~NodePool()
+
+
+    // Description: Returns an uninitialized block of 'bytes' bytes. The
+    //              first call fixes the block size of the pool; requests of
+    //              any other size return nullptr.
+    // Runtime: O(1) amortized
+    void *allocate(std::size_t bytes) {
+        if (!fixBlockSize(bytes))
+            return nullptr;
+
+        if (freeList != nullptr) {
+            FreeBlock *block = freeList;
+            freeList = block->next;
+            return block;
+        }
+        if (bump == slabEnd)
+            addSlab(nextSlabBlocks);
+        void *block = bump;
+        bump += blockSize;
+        return block;
+    } // allocate()
+
+
+    // Description: Returns a block obtained from allocate() to the pool.
+    // Runtime: O(1)
+    void deallocate(void *ptr) {
+        freeList = ::new (ptr) FreeBlock{ freeList };
+    } // deallocate()
+
+
+    // Description: Makes room for 'count' more blocks of 'bytes' bytes in
+    //              one contiguous slab, so that a bulk build into a fresh
+    //              pool touches memory sequentially. The unused tail of the
+    //              current slab goes on the free list, and the free list is
+    //              still drained first.
+    // Runtime: O(blocks left in the current slab)
+    void reserve(std::size_t bytes, std::size_t count) {
+        if (!fixBlockSize(bytes) || static_cast<std::size_t>(slabEnd - bump) / blockSize >= count)
+            return;
+        while (bump != slabEnd) {
+            deallocate(bump);
+            bump += blockSize;
+        }
+        addSlab(std::max(count, nextSlabBlocks));
+    } // reserve()
+
+
+    // Description: True if blocks of 'bytes' bytes come from this pool.
+    // Runtime: O(1)
+    bool owns(std::size_t bytes) const {
+        return blockSize != 0
+               && roundUp(std::max(bytes, sizeof(FreeBlock)), alignof(std::max_align_t)) == blockSize;
+    } // owns()
+
+
+    // Description: Takes over every slab of other, so that the blocks other
+    //              handed out can be freed to this pool, and leaves other
+    //              empty. Both pools must have the same block size (or
+    //              other none yet); returns false, and does nothing, if
+    //              they do not. Of the two unused slab tails only the
+    //              larger is kept; the other stays allocated, unused, until
+    //              the slabs are released.
+    // Runtime: O(number of slabs of other + blocks on other's free list)
+    bool adopt(NodePool &other) {
+        if (&other == this || other.blockSize == 0)
+            return true;
+        if (blockSize != 0 && blockSize != other.blockSize)
+            return false;
+        blockSize = other.blockSize;
+
+        if (other.slabs != nullptr) {
+            SlabHeader *last = other.slabs;
+            while (last->next != nullptr)
+                last = last->next;
+            last->next = slabs;
+            slabs = other.slabs;
+        }
+        if (other.freeList != nullptr) {
+            FreeBlock *last = other.freeList;
+            while (last->next != nullptr)
+                last = last->next;
+            last->next = freeList;
+            freeList = other.freeList;
+        }
+        if (other.slabEnd - other.bump > slabEnd - bump) {
+            bump = other.bump;
+            slabEnd = other.slabEnd;
+        }
+        nextSlabBlocks = std::max(nextSlabBlocks, other.nextSlabBlocks);
+
+        other.slabs = nullptr;
+        other.freeList = nullptr;
+        other.bump = other.slabEnd = nullptr;
+        other.nextSlabBlocks = FIRST_SLAB_BLOCKS;
+        return true;
+    } // adopt()
+
+
+    // Description: Gives every slab back to the system at once, invalidating
+    //              all blocks handed out so far. Nothing is destroyed.
+    // Runtime: O(number of slabs), which is O(log(peak blocks))
+    void release() {
+        releaseSlabs();
+        freeList = nullptr;
+        bump = slabEnd = nullptr;
+        nextSlabBlocks = FIRST_SLAB_BLOCKS;
+    } // release()
+
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    // Slabs are chained through a header at their start.
+    struct SlabHeader {
+        SlabHeader *next;
+    };
+
+    // Slabs double in size from 64 blocks up to 64K blocks, so a pool that
+    // grows to n blocks owns O(log n) slabs.
+    static constexpr std::size_t FIRST_SLAB_BLOCKS = 64;
+    static constexpr std::size_t MAX_SLAB_BLOCKS = 65536;
+
+    static std::size_t roundUp(std::size_t bytes, std::size_t align) {
+        return (bytes + align - 1) / align * align;
+    } // roundUp()
+
+    std::size_t blockSize = 0;
+    std::size_t nextSlabBlocks = FIRST_SLAB_BLOCKS;
+    FreeBlock *freeList = nullptr;
+    SlabHeader *slabs = nullptr;
+    char *bump = nullptr;
+    char *slabEnd = nullptr;
+
+    // Sets the block size on first use; false if 'bytes' does not match it.
+    bool fixBlockSize(std::size_t bytes) {
+        std::size_t size = roundUp(std::max(bytes, sizeof(FreeBlock)), alignof(std::max_align_t));
+        if (blockSize == 0)
+            blockSize = size;
+        return size == blockSize;
+    } // fixBlockSize()
+
+    void addSlab(std::size_t blocks) {
+        std::size_t header = roundUp(sizeof(SlabHeader), alignof(std::max_align_t));
+        char *raw = static_cast<char *>(::operator new(header + blocks * blockSize));
+        slabs = ::new (raw) SlabHeader{ slabs };
+        bump = raw + header;
+        slabEnd = bump + blocks * blockSize;
+        nextSlabBlocks = std::min(2 * nextSlabBlocks, MAX_SLAB_BLOCKS);
+    } // addSlab()
+
+    void releaseSlabs() {
+        while (slabs != nullptr) {
+            SlabHeader *next = slabs->next;
+            ::operator delete(slabs);
+            slabs = next;
+        }
+    } // releaseSlabs()
+}; // NodePool
+
+
+// Allocator backed by a NodePool, meant for node-based containers such as
+// PairingPQ that allocate one node at a time. Copies and rebound copies
+// share the same pool, so any of them can free what another allocated;
+// a container copy gets a fresh pool of its own (see
+// select_on_container_copy_construction()). Requests for more than one
+// object, or for a size other than the pool's, go to operator new.
+template<typename TYPE>
+class PoolAllocator {
+    static_assert(alignof(TYPE) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+public:
+    using value_type = TYPE;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    PoolAllocator() :
+        pool{ std::make_shared<NodePool>() } {
+    } // PoolAllocator()
+
+    template<typename OTHER>
+    PoolAllocator(const PoolAllocator<OTHER> &other) :
+        pool{ other.pool } {
+    } // PoolAllocator()
+
+
+    TYPE *allocate(std::size_t n) {
+        if (n == 1) {
+            void *block = pool->allocate(sizeof(TYPE));
+            if (block != nullptr)
+                return static_cast<TYPE *>(block);
+        }
+        return static_cast<TYPE *>(::operator new(n * sizeof(TYPE)));
+    } // allocate()
+
+
+    void deallocate(TYPE *ptr, std::size_t n) {
+        if (n == 1 && pool->owns(sizeof(TYPE)))
+            pool->deallocate(ptr);
+        else
+            ::operator delete(ptr);
+    } // deallocate()
+
+
+    // Description: Prepares the pool to hand out n objects from one slab.
+    // Runtime: O(1) amortized
+    void reserve(std::size_t n) {
+        pool->reserve(sizeof(TYPE), n);
+    } // reserve()
+
+
+    // Description: Releases every slab of the pool in one go if no other
+    //              allocator shares it. Returns false, and does nothing,
+    //              otherwise. Objects still allocated are not destroyed.
+    // Runtime: O(number of slabs)
+    bool release() {
+        if (pool.use_count() != 1)
+            return false;
+        pool->release();
+        return true;
+    } // release()
+
+
+    // Description: Makes this allocator's pool take over other's, so that
+    //              whatever other allocated can be freed through this
+    //              allocator (e.g. when a container takes over another's
+    //              nodes). Returns false, and does nothing, if another
+    //              allocator shares other's pool, or if the pools hold
+    //              blocks of different sizes.
+    // Runtime: See NodePool::adopt().
+    template<typename OTHER>
+    bool adopt(PoolAllocator<OTHER> &other) {
+        if (other.pool == pool)
+            return true;
+        if (other.pool.use_count() != 1)
+            return false;
+        return pool->adopt(*other.pool);
+    } // adopt()
+
+
+    PoolAllocator select_on_container_copy_construction() const {
+        return PoolAllocator{};
+    } // select_on_container_copy_construction()
+
+
+    template<typename OTHER>
+    bool operator==(const PoolAllocator<OTHER> &other) const { return pool == other.pool; }
+    template<typename OTHER>
+    bool operator!=(const PoolAllocator<OTHER> &other) const { return pool != other.pool; }
+
+private:
+    template<typename OTHER>
+    friend class PoolAllocator;
+
+    std::shared_ptr<NodePool> pool;
+}; // PoolAllocator
+
+
+#endif // POOLALLOCATOR_H
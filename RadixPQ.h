@@ -0,0 +1,276 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef RADIXPQ_H
+#define RADIXPQ_H
+
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Eecs281PQ.h"
+#include "PQKey.h"
+
+
+// A specialized version of the priority queue ADT implemented as a radix
+// heap (Ahuja, Mehlhorn, Orlin and Tarjan, 1990), for integer priorities
+// that are popped in monotone order, as in Dijkstra's algorithm: no element
+// may be pushed that is more extreme than the last one popped.
+//
+// Elements are mapped to unsigned keys by PQKey<TYPE, COMP_FUNCTOR>, the
+// most extreme element having the smallest key; see PQKey.h for the
+// supported types (integers, and std::pair with an integer key ordered by
+// FirstLess or FirstGreater). Bucket 0 holds the elements whose key equals
+// 'last', the key of the last element popped. Bucket i > 0 holds the
+// elements whose key first differs from 'last' in bit i - 1. When the
+// lowest nonempty bucket has to be popped, 'last' becomes its smallest key
+// and its elements are spread over lower buckets, so each element moves at
+// most once per bit of the key.
+//
+// Each bucket is a vector that keeps its capacity, so a queue that has
+// reached its working size no longer allocates; pushes append to the end
+// of a bucket and spreading a bucket reads it front to back.
+//
+// Pushing an element with a key below 'last' would break the bucket
+// invariant, so push() and updatePriorities() reject it with a
+// std::logic_error instead.
+template<typename TYPE, typename COMP_FUNCTOR = std::greater<TYPE>>
+class RadixPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(HasPQKey<TYPE, COMP_FUNCTOR>::value,
+                  "RadixPQ needs an integer key: specialize PQKey for this type and comparator");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+    using Key = PQKey<TYPE, COMP_FUNCTOR>;
+
+public:
+    using key_type = typename Key::key_type;
+
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit RadixPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+    } // RadixPQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    RadixPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+        while (start != end)
+            push(*start++);
+    } // RadixPQ()
+
+
+    // Description: Destructor doesn't need any code, the buckets will be
+    //              destroyed automatically.
+    virtual ~RadixPQ() {
+    } // ~RadixPQ()
+
+
+    // Description: Assumes that all elements are out of order and puts each
+    //              in the bucket of its current key. Throws
+    //              std::logic_error, leaving the PQ unchanged, if a key is
+    //              now below the key of the last element popped.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        for (const std::vector<TYPE> &bucket : buckets) {
+            for (const TYPE &val : bucket)
+                checkMonotone(val);
+        }
+        std::vector<TYPE> all;
+        all.reserve(count);
+        for (std::vector<TYPE> &bucket : buckets) {
+            for (TYPE &val : bucket)
+                all.push_back(std::move(val));
+            bucket.clear();
+        }
+        count = 0;
+        for (TYPE &val : all)
+            insert(std::move(val));
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ. Throws std::logic_error,
+    //              leaving the PQ unchanged, if val is more extreme than the
+    //              last element popped.
+    // Runtime: O(1)
+    virtual void push(const TYPE &val) {
+        checkMonotone(val);
+        insert(TYPE(val));
+    } // push()
+
+
+    // Description: Add a new element to the PQ, moving from val. Throws
+    //              like push(const TYPE &).
+    // Runtime: O(1)
+    virtual void push(TYPE &&val) {
+        checkMonotone(val);
+        insert(std::move(val));
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Note: We will not run tests on your code that would require it to pop
+    // an element when the PQ is empty. Though you are welcome to if you are
+    // familiar with them, you do not need to use exceptions in this project.
+    // Runtime: Amortized O(log(C)), where C is the largest key.
+    virtual void pop() {
+        extractTop();
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value (moved, not copied).
+    // Runtime: Amortized O(log(C)), where C is the largest key.
+    virtual TYPE pop_top() {
+        return extractTop();
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ. This should be a reference for speed. It MUST
+    //              be const because we cannot allow it to be modified, as
+    //              that might make it no longer be the most extreme element.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return buckets[topBucket][topIndex];
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: The key of the last element popped (0 before the first
+    //              pop). Pushed elements must not have a smaller key.
+    // Runtime: O(1)
+    key_type lastKey() const {
+        return last;
+    } // lastKey()
+
+
+private:
+    // One bucket for keys equal to 'last', and one per bit of the key.
+    static constexpr std::size_t BUCKETS = std::numeric_limits<key_type>::digits + 1;
+
+    std::array<std::vector<TYPE>, BUCKETS> buckets;
+    std::size_t count = 0;
+    key_type last = 0;
+    // Where the most extreme element is, valid while the PQ is not empty.
+    // The smallest key is always in the lowest nonempty bucket, but only
+    // bucket 0 holds nothing else, so the position is kept here rather
+    // than searched for by top().
+    std::size_t topBucket = 0;
+    std::size_t topIndex = 0;
+
+
+    // Description: The bucket for key, given the current 'last': one more
+    //              than the index of the highest bit in which they differ.
+    // Runtime: O(1)
+    std::size_t bucketOf(key_type key) const {
+        unsigned long long diff = static_cast<unsigned long long>(key ^ last);
+        if (diff == 0)
+            return 0;
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(std::numeric_limits<unsigned long long>::digits - __builtin_clzll(diff));
+#else
+        std::size_t width = 0;
+        for (; diff != 0; diff >>= 1)
+            ++width;
+        return width;
+#endif
+    } // bucketOf()
+
+
+    // Description: Throws std::logic_error if val cannot be pushed because
+    //              it is more extreme than the last element popped.
+    // Runtime: O(1)
+    void checkMonotone(const TYPE &val) const {
+        if (Key::key(val) < last)
+            throw std::logic_error("RadixPQ: pushed an element that is more extreme than the last one "
+                                   "popped; RadixPQ needs priorities that are popped in monotone order");
+    } // checkMonotone()
+
+
+    // Description: Adds val to its bucket and updates the top position.
+    // Runtime: O(1)
+    void insert(TYPE &&val) {
+        const key_type key = Key::key(val);
+        const std::size_t b = bucketOf(key);
+        buckets[b].push_back(std::move(val));
+        if (count++ == 0 || key < Key::key(top())) {
+            topBucket = b;
+            topIndex = buckets[b].size() - 1;
+        }
+    } // insert()
+
+
+    // Description: Removes the top element and returns it. If it came from
+    //              bucket i > 0, its key becomes 'last' and the rest of
+    //              bucket i is spread over the buckets below i.
+    // Runtime: Amortized O(log(C)), where C is the largest key.
+    TYPE extractTop() {
+        std::vector<TYPE> &bucket = buckets[topBucket];
+        if (topIndex + 1 != bucket.size())
+            std::swap(bucket[topIndex], bucket.back());
+        TYPE result = std::move(bucket.back());
+        bucket.pop_back();
+        --count;
+
+        last = Key::key(result);
+        if (topBucket != 0) {
+            // Every key left in this bucket is at least 'last' and shares
+            // its bits above topBucket - 1, so it moves to a lower bucket.
+            for (TYPE &val : bucket)
+                buckets[bucketOf(Key::key(val))].push_back(std::move(val));
+            bucket.clear();
+        }
+        findTop();
+        return result;
+    } // extractTop()
+
+
+    // Description: Finds the most extreme element after a pop: the back of
+    //              bucket 0 if it is not empty, else the smallest key of the
+    //              lowest nonempty bucket.
+    // Runtime: O(k) for a lowest nonempty bucket of k elements, which the
+    //          next pop then spreads.
+    void findTop() {
+        if (count == 0)
+            return;
+        std::size_t b = 0;
+        while (buckets[b].empty())
+            ++b;
+        topBucket = b;
+        topIndex = buckets[b].size() - 1;
+        if (b == 0)
+            return;
+        key_type best = Key::key(buckets[b][topIndex]);
+        for (std::size_t i = 0; i < buckets[b].size(); ++i) {
+            const key_type key = Key::key(buckets[b][i]);
+            if (key < best) {
+                best = key;
+                topIndex = i;
+            }
+        }
+    } // findTop()
+}; // RadixPQ
+
+
+#endif // RADIXPQ_H
@@ -0,0 +1,604 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef RANKPAIRINGPQ_H
+#define RANKPAIRINGPQ_H
+
+#include "Eecs281PQ.h"
+#include "PoolAllocator.h"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A specialized version of the priority queue ADT implemented as a
+// rank-pairing heap (Haeupler, Sen and Tarjan, 2011), type 1. It has the
+// same handle API as PairingPQ: addNode() returns a Node* that stays valid
+// until its element is popped or erased, and updateElt() changes the
+// element in place.
+//
+// The heap is a circular list of half-trees, linked through the right
+// pointers of their roots; root points to the most extreme root. A
+// half-tree is a binary tree whose root has a left child only, and every
+// node is at least as extreme as all nodes in its left subtree. Each node
+// has a rank: a root's is one more than its left child's, and an inner
+// node with children of ranks a and b has max(a, b) + 1 when they differ
+// by at most 1, max(a, b) otherwise (a missing child has rank -1). Two
+// half-trees of equal rank are linked by making the loser the left child
+// of the winner, the winner's old left subtree becoming the loser's right.
+//
+// push() only adds a root. pop() turns the right spine of the top's left
+// subtree into roots and links them, and all other roots, in a single
+// pass by rank. updateElt() to a more extreme value cuts the node, with
+// its left subtree, into a root of its own and only lowers ranks on the
+// way up, which keeps the half-trees balanced enough for amortized O(1)
+// promotions and O(log(n)) pops, like a Fibonacci heap, while doing
+// about as little work per operation as a pairing heap.
+//
+// Nodes are obtained from ALLOCATOR (rebound to Node), as in PairingPQ.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>, typename ALLOCATOR = PoolAllocator<TYPE>>
+class RankPairingPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Each node within the rank-pairing heap
+    class Node {
+        public:
+            explicit Node(const TYPE &val)
+                : elt{ val }
+            {}
+
+            explicit Node(TYPE &&val)
+                : elt{ std::move(val) }
+            {}
+
+            // Constructs the element in place from args (used by emplace()).
+            template<typename... Args>
+            explicit Node(std::in_place_t, Args &&...args)
+                : elt(std::forward<Args>(args)...)
+            {}
+
+            // Description: Allows access to the element at that Node's
+            // position.
+            // Runtime: O(1)
+            const TYPE &getElt() const { return elt; }
+            const TYPE &operator*() const { return elt; }
+
+            friend RankPairingPQ;
+
+        private:
+            TYPE elt;
+            Node *left = nullptr;
+            // The right child, or for a root the next root.
+            Node *right = nullptr;
+            // The node whose left or right child this is, nullptr for a
+            // root.
+            Node *parent = nullptr;
+            int rank = 0;
+    }; // Node
+
+
+    using allocator_type = ALLOCATOR;
+
+
+    // Description: Construct an empty rank-pairing heap with an optional
+    //              comparison functor and allocator.
+    // Runtime: O(1)
+    explicit RankPairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const ALLOCATOR &allocator = ALLOCATOR()) :
+        BaseClass{ comp }, alloc{ allocator } {
+    } // RankPairingPQ()
+
+
+    // Description: Construct a rank-pairing heap out of an iterator range
+    //              with an optional comparison functor and allocator. Every
+    //              element becomes a root; the first pop() links them.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    RankPairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                  const ALLOCATOR &allocator = ALLOCATOR()) :
+        BaseClass{ comp }, alloc{ allocator } {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+            reserveNodes(static_cast<std::size_t>(std::distance(start, end)));
+        }
+        try {
+            for (; start != end; ++start) {
+                addNode(*start);
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    } // RankPairingPQ()
+
+
+    // Description: Copy constructor. The copy holds the same elements, each
+    //              as a root of its own; the first pop() links them.
+    // Runtime: O(n)
+    RankPairingPQ(const RankPairingPQ &other) :
+        BaseClass{ other.compare },
+        alloc{ NodeTraits::select_on_container_copy_construction(other.alloc) } {
+        if (other.root == nullptr) {
+            return;
+        }
+        reserveNodes(other.numN);
+        try {
+            // The roots first, then the nodes of their half-trees; below a
+            // root, both children are tree nodes.
+            std::vector<const Node *> pending;
+            const Node *first = other.root;
+            const Node *node = first;
+            do {
+                addNode(node->elt);
+                if (node->left != nullptr) {
+                    pending.push_back(node->left);
+                }
+                node = node->right;
+            } while (node != first);
+            while (!pending.empty()) {
+                node = pending.back();
+                pending.pop_back();
+                addNode(node->elt);
+                if (node->left != nullptr) {
+                    pending.push_back(node->left);
+                }
+                if (node->right != nullptr) {
+                    pending.push_back(node->right);
+                }
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    } // RankPairingPQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    RankPairingPQ &operator=(const RankPairingPQ &rhs) {
+        RankPairingPQ temp(rhs);
+        std::swap(numN, temp.numN);
+        std::swap(root, temp.root);
+        std::swap(alloc, temp.alloc);
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor
+    // Runtime: O(n)
+    ~RankPairingPQ() {
+        clear();
+    } // ~RankPairingPQ()
+
+
+    // Description: Removes every element from the rank-pairing heap. With
+    //              the default PoolAllocator and a trivially destructible
+    //              TYPE the nodes are not visited, as in PairingPQ.
+    // Runtime: O(n), O(log(n)) with PoolAllocator and trivial TYPE
+    void clear() {
+        if (root != nullptr && !releaseAll()) {
+            Node *node = flatten();
+            while (node != nullptr) {
+                Node *next = node->right;
+                destroyNode(node);
+                node = next;
+            }
+        }
+        root = nullptr;
+        numN = 0;
+    } // clear()
+
+
+    // Description: Assumes that all elements inside the rank-pairing heap
+    //              are out of order and 'rebuilds' it: every node becomes a
+    //              root of rank 0, and the most extreme one the top. The
+    //              nodes are kept, so handles stay valid.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        if (root == nullptr) {
+            return;
+        }
+        Node *node = flatten();
+        while (node != nullptr) {
+            Node *next = node->right;
+            node->parent = nullptr;
+            node->rank = 0;
+            addRoot(node);
+            node = next;
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the rank-pairing heap.
+    // Runtime: O(1)
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Add a new element to the rank-pairing heap, moving from
+    //              val.
+    // Runtime: O(1)
+    virtual void push(TYPE &&val) {
+        addNode(std::move(val));
+    } // push()
+
+
+    // Description: Add a new element to the rank-pairing heap, constructed
+    //              in place inside its Node from args.
+    // Runtime: O(1)
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        linkNode(createNode(std::in_place, std::forward<Args>(args)...));
+    } // emplace()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the rank-pairing heap.
+    // Note: We will not run tests on your code that would require it to pop
+    // an element when the rank-pairing heap is empty. Though you are welcome
+    // to if you are familiar with them, you do not need to use exceptions in
+    // this project.
+    // Runtime: Amortized O(log(n))
+    virtual void pop() {
+        Node *old = root;
+        removeRoot(old);
+        destroyNode(old);
+        --numN;
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the rank-pairing heap and return it by value
+    //              (moved, not copied).
+    // Runtime: Amortized O(log(n))
+    virtual TYPE pop_top() {
+        TYPE result = std::move(root->elt);
+        pop();
+        return result;
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the rank-pairing heap. This should be a reference for
+    //              speed. It MUST be const because we cannot allow it to be
+    //              modified, as that might make it no longer be the most
+    //              extreme element.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return root->elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the rank-pairing heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return numN;
+    } // size()
+
+
+    // Description: Return true if the rank-pairing heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return numN == 0;
+    } // empty()
+
+
+    // Description: Updates the priority of an element already in the
+    //              rank-pairing heap by replacing the element refered to by
+    //              the Node with new_value.
+    //
+    //              new_value may be more or less extreme than the old value.
+    //              A more extreme node is cut out with its left subtree and
+    //              becomes a root. Otherwise the node is taken out as pop()
+    //              takes out the top, and added back as a single node. That
+    //              also covers elements that compare equal before and
+    //              after, such as pointers whose pointees changed.
+    //
+    // Runtime: Amortized O(1) when the value becomes more extreme;
+    //          amortized O(log(n)) otherwise.
+    void updateElt(Node *node, const TYPE &new_value) {
+        updateElt(node, TYPE(new_value));
+    } // updateElt()
+
+
+    // Description: Same as above, but moves new_value into the Node.
+    // Runtime: As above.
+    void updateElt(Node *node, TYPE &&new_value) {
+        const bool promoted = this->compare(node->elt, new_value);
+        node->elt = std::move(new_value);
+
+        if (promoted) {
+            if (node->parent != nullptr) {
+                cutToRoot(node);
+            }
+            if (this->compare(root->elt, node->elt)) {
+                root = node;
+            }
+            return;
+        }
+
+        if (node->parent != nullptr) {
+            cutToRoot(node);
+        }
+        removeRoot(node);
+        node->left = nullptr;
+        node->rank = 0;
+        addRoot(node);
+    } // updateElt()
+
+
+    // Description: Removes the element refered to by node from the
+    //              rank-pairing heap, wherever it is. The node is destroyed,
+    //              so node must not be used afterwards.
+    // Runtime: Amortized O(log(n))
+    void erase(Node *node) {
+        if (node->parent != nullptr) {
+            cutToRoot(node);
+        }
+        removeRoot(node);
+        destroyNode(node);
+        --numN;
+    } // erase()
+
+
+    // Description: Add a new element to the rank-pairing heap. Returns a
+    //              Node* corresponding to the newly added element, which
+    //              stays valid until the element is popped or erased.
+    // Runtime: O(1)
+    Node *addNode(const TYPE &val) {
+        return linkNode(createNode(val));
+    } // addNode()
+
+
+    // Description: Same as above, but moves val into the new Node.
+    // Runtime: O(1)
+    Node *addNode(TYPE &&val) {
+        return linkNode(createNode(std::move(val)));
+    } // addNode()
+
+
+private:
+    using NodeAllocator = typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    // More than the largest possible rank: a half-tree of rank r has at
+    // least phi^r nodes, and phi^93 exceeds 2^64.
+    static constexpr std::size_t MAX_RANK = 96;
+
+    // The most extreme root, nullptr when empty.
+    Node *root = nullptr;
+    std::size_t numN = 0;
+    NodeAllocator alloc;
+
+
+    // Description: Allocates a node from alloc and constructs it from args.
+    // Runtime: O(1)
+    template<typename... Args>
+    Node *createNode(Args &&...args) {
+        Node *node = NodeTraits::allocate(alloc, 1);
+        try {
+            ::new (static_cast<void *>(node)) Node(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    } // createNode()
+
+    // Description: Destroys a node and gives it back to alloc.
+    // Runtime: O(1)
+    void destroyNode(Node *node) {
+        node->~Node();
+        NodeTraits::deallocate(alloc, node, 1);
+    } // destroyNode()
+
+    // Description: Frees every node without visiting them, when elements
+    //              need no destructor and the allocator is a PoolAllocator
+    //              nobody else shares. Returns false otherwise.
+    // Runtime: O(log(n))
+    bool releaseAll() {
+        if constexpr (std::is_trivially_destructible<TYPE>::value
+                      && std::is_same<NodeAllocator, PoolAllocator<Node>>::value) {
+            return alloc.release();
+        }
+        else {
+            return false;
+        }
+    } // releaseAll()
+
+    // Description: With a PoolAllocator, asks the pool for n nodes in one
+    //              slab. Other allocators allocate node by node anyway.
+    // Runtime: O(1) amortized
+    void reserveNodes(std::size_t n) {
+        if constexpr (std::is_same<NodeAllocator, PoolAllocator<Node>>::value) {
+            alloc.reserve(n);
+        }
+    } // reserveNodes()
+
+    // Description: The rank of node, -1 for a missing child.
+    // Runtime: O(1)
+    static int rankOf(const Node *node) {
+        return (node != nullptr) ? node->rank : -1;
+    } // rankOf()
+
+    // Description: Takes the whole heap apart without extra memory and
+    //              returns its nodes as one list linked through right, with
+    //              every left pointer nullptr. The roots, opened after the
+    //              top, already are such a list if left subtrees are seen
+    //              as hanging off it; while a node has a left child, a
+    //              right rotation moves that child into the list in front
+    //              of it.
+    // Runtime: O(n)
+    Node *flatten() {
+        Node *head = root->right;
+        root->right = nullptr;
+        Node *prev = nullptr;
+        Node *node = head;
+        while (node != nullptr) {
+            if (node->left != nullptr) {
+                Node *up = node->left;
+                node->left = up->right;
+                up->right = node;
+                node = up;
+                if (prev != nullptr) {
+                    prev->right = node;
+                }
+                else {
+                    head = node;
+                }
+            }
+            else {
+                prev = node;
+                node = node->right;
+            }
+        }
+        root = nullptr;
+        return head;
+    } // flatten()
+
+    // Description: Adds a node that has no right pointer to the roots and
+    //              makes it the top if it is more extreme.
+    // Runtime: O(1)
+    void addRoot(Node *node) {
+        if (root == nullptr) {
+            node->right = node;
+            root = node;
+            return;
+        }
+        node->right = root->right;
+        root->right = node;
+        if (this->compare(root->elt, node->elt)) {
+            root = node;
+        }
+    } // addRoot()
+
+    // Description: Adds a freshly allocated node to the roots.
+    // Runtime: O(1)
+    Node *linkNode(Node *node) {
+        addRoot(node);
+        numN++;
+        return node;
+    } // linkNode()
+
+    // Description: Links two half-trees of equal rank, whose roots have no
+    //              right pointers: the less extreme root becomes the left
+    //              child of the other. Returns the new root.
+    // Runtime: O(1)
+    Node *link(Node *a, Node *b) {
+        if (this->compare(a->elt, b->elt)) {
+            std::swap(a, b);
+        }
+        b->right = a->left;
+        if (b->right != nullptr) {
+            b->right->parent = b;
+        }
+        a->left = b;
+        b->parent = a;
+        ++a->rank;
+        return a;
+    } // link()
+
+    // Description: Cuts node, which must not be a root, out of its tree
+    //              with its left subtree and adds it to the roots, without
+    //              updating the top. Its right subtree takes its place, and
+    //              the ranks above are lowered where the rank rule allows.
+    // Runtime: Amortized O(1)
+    void cutToRoot(Node *node) {
+        Node *parent = node->parent;
+        Node *rest = node->right;
+        if (parent->left == node) {
+            parent->left = rest;
+        }
+        else {
+            parent->right = rest;
+        }
+        if (rest != nullptr) {
+            rest->parent = parent;
+        }
+        node->parent = nullptr;
+        node->rank = rankOf(node->left) + 1;
+        node->right = root->right;
+        root->right = node;
+
+        for (Node *above = parent; above != nullptr; above = above->parent) {
+            if (above->parent == nullptr) {
+                above->rank = rankOf(above->left) + 1;
+                break;
+            }
+            const int a = rankOf(above->left);
+            const int b = rankOf(above->right);
+            const int rank = (a - b > 1 || b - a > 1) ? std::max(a, b) : std::max(a, b) + 1;
+            if (rank >= above->rank) {
+                break;
+            }
+            above->rank = rank;
+        }
+    } // cutToRoot()
+
+    // Description: Takes the root node (the top or another root) out of the
+    //              heap, leaving it with no right pointer. The right spine
+    //              of its left subtree becomes roots, which are linked with
+    //              the other roots in one pass: a half-tree is linked with
+    //              the first one of equal rank that is waiting, and the
+    //              result waits no more. Then the new top is found.
+    // Runtime: Amortized O(log(n))
+    void removeRoot(Node *node) {
+        std::array<Node *, MAX_RANK> byRank{};
+        Node *done = nullptr;
+        int maxRank = -1;
+        auto add = [&](Node *tree) {
+            tree->parent = nullptr;
+            const int rank = tree->rank;
+            Node *&waiting = byRank[static_cast<std::size_t>(rank)];
+            if (waiting != nullptr) {
+                Node *linked = link(waiting, tree);
+                waiting = nullptr;
+                linked->right = done;
+                done = linked;
+            }
+            else {
+                waiting = tree;
+                maxRank = std::max(maxRank, rank);
+            }
+        };
+
+        for (Node *spine = node->left; spine != nullptr;) {
+            Node *next = spine->right;
+            spine->right = nullptr;
+            spine->rank = rankOf(spine->left) + 1;
+            add(spine);
+            spine = next;
+        }
+        for (Node *other = node->right; other != node;) {
+            Node *next = other->right;
+            other->right = nullptr;
+            add(other);
+            other = next;
+        }
+        node->left = nullptr;
+        node->right = nullptr;
+
+        root = nullptr;
+        while (done != nullptr) {
+            Node *next = done->right;
+            addRoot(done);
+            done = next;
+        }
+        for (int rank = 0; rank <= maxRank; ++rank) {
+            Node *waiting = byRank[static_cast<std::size_t>(rank)];
+            if (waiting != nullptr) {
+                addRoot(waiting);
+            }
+        }
+    } // removeRoot()
+};
+
+
+#endif // RANKPAIRINGPQ_H
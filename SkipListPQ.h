@@ -0,0 +1,464 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SKIPLISTPQ_H
+#define SKIPLISTPQ_H
+
+#include "EpochReclaimer.h"
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <optional>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// A lock-free priority queue on a skiplist, after Lindén and Jonsson, "A
+// Skiplist-Based Concurrent Priority Queue with Minimal Memory Contention"
+// (2013). The nodes are sorted from the most extreme element down. push()
+// is a lock-free skiplist insertion. pop() claims the first node that is
+// not yet claimed, with one fetch_or on the bottom-level link that points
+// to it; nothing else is written, so concurrent pops only ever contend on
+// that one link.
+//
+// A claimed node stays in the list for a while: the claimed nodes always
+// form a prefix of the list, marked by the low bit of the bottom-level
+// links into them, and insertions land after it. Once a pop has walked
+// past more than BOUND_OFFSET claimed nodes, it cuts the prefix off the
+// head with a single compare-and-swap and retires those nodes to
+// EpochReclaimer, which frees them once no thread can still be reading
+// them.
+//
+// Other threads may still be comparing against a node after it has been
+// claimed, so its element is never modified: pop_top() and try_pop()
+// return a copy of it, and it is destroyed with the node.
+//
+// push(), pop(), pop_top(), try_pop(), try_top(), size() and empty() may
+// be called from any number of threads at once. top() is safe alongside
+// any number of pushes; it returns the first element not yet claimed, and
+// the reference stays valid until that element is popped. With several
+// threads popping, use try_top(), which copies the element instead. The
+// copy constructor and updatePriorities() may only be used while no other
+// thread touches the queue. The comparator is called concurrently and must
+// be safe for that.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class SkipListPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit SkipListPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+        init();
+    } // SkipListPQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n log(n)) where n is number of elements in range.
+    template<typename InputIterator>
+    SkipListPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        BaseClass{ comp } {
+        init();
+        std::vector<Node *> nodes;
+        for (; start != end; ++start)
+            nodes.push_back(makeNode(randomHeight(), *start));
+        relink(nodes);
+    } // SkipListPQ()
+
+
+    // Description: Copy constructor. other must not be modified meanwhile.
+    // Runtime: O(n)
+    SkipListPQ(const SkipListPQ &other) :
+        BaseClass{ other.compare } {
+        init();
+        std::vector<Node *> nodes;
+        for (Node *node = other.firstLive(); node != other.tail; node = nodeOf(node->next()[0].load()))
+            nodes.push_back(makeNode(node->height, *node->value));
+        relink(nodes);
+    } // SkipListPQ()
+
+
+    // Threads may be working on the nodes, so there is no assignment.
+    SkipListPQ &operator=(const SkipListPQ &) = delete;
+
+
+    // Description: Destructor. Frees the nodes still in the list; those
+    //              already retired are freed by EpochReclaimer.
+    // Runtime: O(n)
+    virtual ~SkipListPQ() {
+        Node *node = head;
+        while (node != tail) {
+            Node *next = nodeOf(node->next()[0].load());
+            destroyNode(node);
+            node = next;
+        }
+        destroyNode(tail);
+    } // ~SkipListPQ()
+
+
+    // Description: Re-sorts the list after the elements changed priority.
+    //              Not thread safe.
+    // Runtime: O(n log(n))
+    virtual void updatePriorities() {
+        std::vector<Node *> nodes;
+        Link link = head->next()[0].load();
+        // Nobody else is using the queue, so claimed nodes can go at once.
+        while (marked(link)) {
+            Node *claimed = nodeOf(link);
+            link = claimed->next()[0].load();
+            destroyNode(claimed);
+        }
+        for (Node *node = nodeOf(link); node != tail; node = nodeOf(node->next()[0].load()))
+            nodes.push_back(node);
+        relink(nodes);
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ. Thread safe and lock-free.
+    // Runtime: O(log(n)) expected
+    virtual void push(const TYPE &val) {
+        insert(makeNode(randomHeight(), val));
+    } // push()
+
+
+    // Description: Add a new element to the PQ, moving from val. Thread safe
+    //              and lock-free.
+    // Runtime: O(log(n)) expected
+    virtual void push(TYPE &&val) {
+        insert(makeNode(randomHeight(), std::move(val)));
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ. Thread safe; the PQ must not be empty.
+    // Runtime: O(1) amortized without contention
+    virtual void pop() {
+        EpochReclaimer::Guard guard;
+        claim();
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return a copy of it. Thread safe; the PQ
+    //              must not be empty.
+    // Runtime: O(1) amortized without contention
+    virtual TYPE pop_top() {
+        EpochReclaimer::Guard guard;
+        return *claim()->value;
+    } // pop_top()
+
+
+    // Description: Remove the most extreme element from the PQ and copy it
+    //              into out. Returns false, leaving out alone, if the PQ
+    //              was empty. Thread safe.
+    // Runtime: O(1) amortized without contention
+    bool try_pop(TYPE &out) {
+        EpochReclaimer::Guard guard;
+        Node *node = claim();
+        if (node == nullptr)
+            return false;
+        out = *node->value;
+        return true;
+    } // try_pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ that is not claimed yet. Safe alongside pushes.
+    // Runtime: O(1) amortized
+    virtual const TYPE &top() const {
+        EpochReclaimer::Guard guard;
+        return *firstLive()->value;
+    } // top()
+
+
+    // Description: Copy the most extreme element of the PQ into out, as it
+    //              was at some moment during the call. Returns false,
+    //              leaving out alone, if the PQ was empty. Thread safe.
+    // Runtime: O(1) amortized
+    bool try_top(TYPE &out) const {
+        EpochReclaimer::Guard guard;
+        Node *node = firstLive();
+        if (node == tail)
+            return false;
+        out = *node->value;
+        return true;
+    } // try_top()
+
+
+    // Description: Get the number of elements in the PQ. Under concurrent
+    //              use, the number at some recent moment.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count.load(std::memory_order_relaxed);
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return size() == 0;
+    } // empty()
+
+
+private:
+    // A pointer to the next node, with the low bit set when the node it
+    // points to has been claimed.
+    using Link = std::uintptr_t;
+
+    static constexpr Link MARK = 1;
+    static constexpr std::size_t MAX_LEVELS = 32;
+    // Claimed nodes a pop may walk past before it cuts them off the list.
+    static constexpr std::size_t BOUND_OFFSET = 32;
+
+    // The links follow the node in the same allocation, one per level.
+    struct Node {
+        std::optional<TYPE> value;      // empty in head and tail
+        std::size_t height;
+        std::atomic<bool> inserting{ false };
+
+        explicit Node(std::size_t h) : height{ h } {}
+
+        std::atomic<Link> *next() {
+            return reinterpret_cast<std::atomic<Link> *>(this + 1);
+        } // next()
+    };
+
+    Node *head = nullptr;
+    Node *tail = nullptr;
+    std::atomic<std::size_t> count{ 0 };
+
+    static bool marked(Link link) {
+        return (link & MARK) != 0;
+    } // marked()
+
+    static Node *nodeOf(Link link) {
+        return reinterpret_cast<Node *>(link & ~MARK);
+    } // nodeOf()
+
+    static Link linkTo(Node *node) {
+        return reinterpret_cast<Link>(node);
+    } // linkTo()
+
+    // Description: Allocates a node with 'height' levels of links, holding
+    //              an element built from args, or none if args is empty.
+    // Runtime: O(height)
+    template<typename... Args>
+    static Node *makeNode(std::size_t height, Args &&... args) {
+        void *raw = ::operator new(sizeof(Node) + height * sizeof(std::atomic<Link>),
+                                   std::align_val_t{ alignof(Node) });
+        Node *node = new (raw) Node{ height };
+        for (std::size_t i = 0; i < height; ++i)
+            new (&node->next()[i]) std::atomic<Link>{ 0 };
+        if constexpr (sizeof...(Args) > 0) {
+            try {
+                node->value.emplace(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                destroyNode(node);
+                throw;
+            }
+        }
+        return node;
+    } // makeNode()
+
+    static void destroyNode(void *ptr) {
+        static_cast<Node *>(ptr)->~Node();
+        ::operator delete(ptr, std::align_val_t{ alignof(Node) });
+    } // destroyNode()
+
+    // Description: A height with probability 2^-h, from a generator per
+    //              thread.
+    // Runtime: O(1) expected
+    static std::size_t randomHeight() {
+        thread_local std::minstd_rand rng{ static_cast<std::minstd_rand::result_type>(
+            std::hash<std::thread::id>{}(std::this_thread::get_id())) };
+        std::minstd_rand::result_type bits = rng();
+        std::size_t height = 1;
+        while (height < MAX_LEVELS && (bits & 1) != 0) {
+            ++height;
+            bits >>= 1;
+        }
+        return height;
+    } // randomHeight()
+
+    void init() {
+        head = makeNode(MAX_LEVELS);
+        tail = makeNode(1);
+        for (std::size_t i = 0; i < MAX_LEVELS; ++i)
+            head->next()[i].store(linkTo(tail));
+    } // init()
+
+    // Description: Links the given nodes, in order of priority, as the
+    //              whole list. Only while the PQ is not shared.
+    // Runtime: O(n log(n))
+    void relink(std::vector<Node *> &nodes) {
+        std::stable_sort(nodes.begin(), nodes.end(), [this](Node *a, Node *b) {
+            return this->compare(*b->value, *a->value);
+        });
+        Node *last[MAX_LEVELS];
+        std::fill(last, last + MAX_LEVELS, head);
+        for (Node *node : nodes) {
+            for (std::size_t i = 0; i < node->height; ++i) {
+                last[i]->next()[i].store(linkTo(node));
+                last[i] = node;
+            }
+        }
+        for (std::size_t i = 0; i < MAX_LEVELS; ++i)
+            last[i]->next()[i].store(linkTo(tail));
+        count.store(nodes.size(), std::memory_order_relaxed);
+    } // relink()
+
+    // Description: The first node that is not claimed, or tail. The caller
+    //              must be pinned.
+    // Runtime: O(1) amortized
+    Node *firstLive() const {
+        Link link = head->next()[0].load();
+        while (marked(link))
+            link = nodeOf(link)->next()[0].load();
+        return nodeOf(link);
+    } // firstLive()
+
+    // Description: Finds, on every level, the last node that comes before
+    //              val and is not claimed (preds) and the node after it
+    //              (succs). At the bottom level claimed nodes are always
+    //              skipped, so val lands after them. Returns the last
+    //              claimed node seen at the bottom level, if any.
+    // Runtime: O(log(n)) expected
+    Node *locate(const TYPE &val, Node **preds, Node **succs) {
+        Node *claimed = nullptr;
+        Node *pred = head;
+        for (std::size_t i = MAX_LEVELS; i-- > 0;) {
+            Link link = pred->next()[i].load();
+            Node *cur = nodeOf(link);
+            // A node is claimed if the link into it is marked (known only at
+            // the bottom level), or if its successor is claimed.
+            while (cur != tail
+                   && ((i == 0 && marked(link)) || marked(cur->next()[0].load())
+                       || this->compare(val, *cur->value))) {
+                if (i == 0 && marked(link))
+                    claimed = cur;
+                pred = cur;
+                link = pred->next()[i].load();
+                cur = nodeOf(link);
+            }
+            preds[i] = pred;
+            succs[i] = cur;
+        }
+        return claimed;
+    } // locate()
+
+    // Description: Links node in, bottom level first; the upper levels are
+    //              only shortcuts, so giving up on them when they race with
+    //              claims is harmless.
+    // Runtime: O(log(n)) expected
+    void insert(Node *node) {
+        EpochReclaimer::Guard guard;
+        const TYPE &val = *node->value;
+        Node *preds[MAX_LEVELS];
+        Node *succs[MAX_LEVELS];
+        node->inserting.store(true);
+        // Counted first, so that a pop can never make the count wrap.
+        count.fetch_add(1, std::memory_order_relaxed);
+
+        Node *claimed = nullptr;
+        while (true) {
+            claimed = locate(val, preds, succs);
+            Link expected = linkTo(succs[0]);
+            node->next()[0].store(expected);
+            if (preds[0]->next()[0].compare_exchange_strong(expected, linkTo(node)))
+                break;
+        }
+
+        for (std::size_t i = 1; i < node->height;) {
+            node->next()[i].store(linkTo(succs[i]));
+            // Stop if the node itself or its successor was claimed: the
+            // prefix may be cut off at any moment.
+            if (marked(node->next()[0].load()) || marked(succs[i]->next()[0].load()) || succs[i] == claimed)
+                break;
+            Link expected = linkTo(succs[i]);
+            if (preds[i]->next()[i].compare_exchange_strong(expected, linkTo(node))) {
+                ++i;
+            }
+            else {
+                claimed = locate(val, preds, succs);
+                if (succs[0] != node)
+                    break;
+            }
+        }
+        node->inserting.store(false);
+    } // insert()
+
+    // Description: Claims the first unclaimed node and returns it, or
+    //              nullptr if there is none. Cuts the claimed prefix off
+    //              when it has grown past BOUND_OFFSET. The caller must be
+    //              pinned, and stay pinned while it uses the node.
+    // Runtime: O(1) amortized without contention
+    Node *claim() {
+        const Link observedHead = head->next()[0].load();
+        Node *x = head;
+        Node *newHead = nullptr;
+        std::size_t offset = 0;
+        Link link = 0;
+        do {
+            link = x->next()[0].load();
+            if (nodeOf(link) == tail)
+                return nullptr;
+            // The prefix must not be cut past a node still being inserted:
+            // it may yet link one of its upper levels to a later node.
+            if (newHead == nullptr && x->inserting.load())
+                newHead = x;
+            if (!marked(link))
+                link = x->next()[0].fetch_or(MARK);
+            ++offset;
+            x = nodeOf(link);
+        } while (marked(link));
+        count.fetch_sub(1, std::memory_order_relaxed);
+
+        if (newHead == nullptr)
+            newHead = x;
+        if (offset <= BOUND_OFFSET || head->next()[0].load() != observedHead)
+            return x;
+        Link expected = observedHead;
+        if (head->next()[0].compare_exchange_strong(expected, linkTo(newHead) | MARK)) {
+            restructure();
+            for (Node *cut = nodeOf(observedHead); cut != newHead;) {
+                Node *next = nodeOf(cut->next()[0].load());
+                EpochReclaimer::retire(cut, destroyNode);
+                cut = next;
+            }
+        }
+        return x;
+    } // claim()
+
+    // Description: Moves the upper-level links of the head past claimed
+    //              nodes, after the bottom level was cut.
+    // Runtime: O(log(n)) expected
+    void restructure() {
+        Node *pred = head;
+        for (std::size_t i = MAX_LEVELS - 1; i > 0;) {
+            Link first = head->next()[i].load();
+            if (!marked(nodeOf(first)->next()[0].load())) {
+                --i;
+                continue;
+            }
+            Node *cur = nodeOf(pred->next()[i].load());
+            while (marked(cur->next()[0].load())) {
+                pred = cur;
+                cur = nodeOf(pred->next()[i].load());
+            }
+            if (head->next()[i].compare_exchange_strong(first, pred->next()[i].load()))
+                --i;
+        }
+    } // restructure()
+}; // SkipListPQ
+
+
+#endif // SKIPLISTPQ_H
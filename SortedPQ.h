@@ -4,16 +4,22 @@
 #define SORTEDPQ_H
 
 #include "Eecs281PQ.h"
+#include "ParallelRebuild.h"
 #include <algorithm>
 #include <iostream>
+#include <iterator>
 
 // A specialized version of the priority queue ADT that is implemented with an
 // underlying sorted array-based container.
 // Note: The most extreme element should be found at the end of the
 // 'data' container, such that traversing the iterators yields the elements in
 // sorted order.
+//
+// push() costs O(n) moves, so bursts of k pushes cost O(n k). push_batch()
+// inserts a whole range with one merge instead; BufferedSortedPQ collects
+// plain pushes and merges them the same way.
 template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class SortedPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+class SortedPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
@@ -37,7 +43,7 @@ public:
             data.push_back(*start);
             ++start;
         }
-        std::sort(data.begin(), data.end(), this->compare);
+        sortData();
     } // SortedPQ
 
 
@@ -56,6 +62,55 @@ public:
     } // push()
 
 
+    // Description: Add a new element to the PQ, moving from val.
+    // Runtime: O(n)
+    virtual void push(TYPE &&val) {
+        auto ptr = std::lower_bound(data.begin(), data.end(), val, this->compare);
+        data.insert(ptr, std::move(val));
+    } // push()
+
+
+    // Description: Add the elements of [first, last) to the PQ: they are
+    //              appended, sorted among themselves, and merged with the
+    //              rest in one pass.
+    // Runtime: O(k log(k) + n + k) for k new elements
+    template<typename InputIterator>
+    void push_batch(InputIterator first, InputIterator last) {
+        std::size_t old = data.size();
+        data.insert(data.end(), first, last);
+        mergeTail(old);
+    } // push_batch()
+
+
+    // Description: Moves every element of other into this PQ and leaves
+    //              other empty. other's sorted elements are appended and
+    //              merged with this PQ's in one pass. other must order
+    //              elements the same way as this PQ.
+    // Runtime: O(n + m) for m elements in other
+    void merge(SortedPQ &&other) {
+        if (&other == this)
+            return;
+        if (data.empty()) {
+            data.swap(other.data);
+            return;
+        }
+        std::size_t old = data.size();
+        data.insert(data.end(), std::make_move_iterator(other.data.begin()), std::make_move_iterator(other.data.end()));
+        other.data.clear();
+        std::inplace_merge(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(old), data.end(), this->compare);
+    } // merge()
+
+
+    // Description: Add a new element to the PQ, constructed from args. The
+    //              element has to exist before its position can be found,
+    //              so it is built once and then moved into place.
+    // Runtime: O(n)
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        push(TYPE(std::forward<Args>(args)...));
+    } // emplace()
+
+
     // Description: Remove the most extreme (defined by 'compare') element from
     //              the PQ.
     // Note: We will not run tests on your code that would require it to pop an
@@ -67,6 +122,16 @@ public:
     } // pop()
 
 
+    // Description: Remove the most extreme (defined by 'compare') element from
+    //              the PQ and return it by value (moved, not copied).
+    // Runtime: Amortized O(1)
+    virtual TYPE pop_top() {
+        TYPE result = std::move(data.back());
+        data.pop_back();
+        return result;
+    } // pop_top()
+
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the vector.  This should be a reference for speed.  It MUST
     //              be const because we cannot allow it to be modified, as that
@@ -74,7 +139,7 @@ public:
     // Runtime: O(1)
     virtual const TYPE &top() const {
         // TODO: Implement this function
-        return data.back();      // TODO: Delete or change this line
+        return data.back();
     } // top()
 
 
@@ -95,14 +160,47 @@ public:
 
 
     // Description: Assumes that all elements inside the PQ are out of order and
-    //              'rebuilds' the PQ by fixing the PQ invariant.
+    //              'rebuilds' the PQ by fixing the PQ invariant. Large PQs
+    //              are sorted with the threads allowed by
+    //              setRebuildThreads().
     // Runtime: O(n log n)
     virtual void updatePriorities() {
         // TODO: Implement this function
-        std::sort(data.begin(), data.end(), this->compare);
+        sortData();
     } // updatePriorities()
 
 
+    // Description: Re-sorts the PQ after the elements in 'changed' were
+    //              modified in place. The changed elements are taken out in
+    //              one pass that does not call the comparator, leaving the
+    //              rest sorted; they are sorted among themselves and merged
+    //              back, which places all k of them at once instead of
+    //              paying O(n) per binary-search insert. Falls back to
+    //              updatePriorities() when many elements changed or TYPE
+    //              cannot be searched.
+    // Runtime: O(n log(k)) for k changed elements
+    virtual void notifyChanged(const std::vector<TYPE> &changed) {
+        if constexpr (ChangedSet<TYPE>::SEARCHABLE) {
+            if (!BaseClass::rebuildCheaper(changed.size(), data.size())) {
+                ChangedSet<TYPE> dirty{ changed };
+                std::vector<TYPE> moved;
+                std::size_t kept = 0;
+                for (std::size_t i = 0; i < data.size(); ++i) {
+                    if (dirty.contains(data[i]))
+                        moved.push_back(std::move(data[i]));
+                    else if (kept++ != i)
+                        data[kept - 1] = std::move(data[i]);
+                }
+                data.erase(data.begin() + static_cast<std::ptrdiff_t>(kept), data.end());
+                data.insert(data.end(), std::make_move_iterator(moved.begin()), std::make_move_iterator(moved.end()));
+                mergeTail(kept);
+                return;
+            }
+        }
+        BaseClass::notifyChanged(changed);
+    } // notifyChanged()
+
+
 private:
     // Note: This vector *must* be used for your PQ implementation.
     std::vector<TYPE> data;
@@ -110,6 +208,25 @@ private:
     // TODO: Add any additional member functions you require here.
     //       You are NOT allowed to add any new member variables.
 
+    // Description: Sorts all of data, in parallel when it is large enough.
+    // Runtime: O(n log(n))
+    void sortData() {
+        std::size_t threads = rebuildWorkers(data.size());
+        if (threads > 1)
+            parallelSort(data.begin(), data.end(), this->compare, threads);
+        else
+            std::sort(data.begin(), data.end(), this->compare);
+    } // sortData()
+
+    // Description: Sorts the elements of data from index 'sorted' on and
+    //              merges them with the sorted elements before it.
+    // Runtime: O(k log(k) + n) for k elements in the tail
+    void mergeTail(std::size_t sorted) {
+        auto middle = data.begin() + static_cast<std::ptrdiff_t>(sorted);
+        std::sort(middle, data.end(), this->compare);
+        std::inplace_merge(data.begin(), middle, data.end(), this->compare);
+    } // mergeTail()
+
 }; // SortedPQ
 
 #endif // SORTEDPQ_H
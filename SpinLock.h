@@ -0,0 +1,58 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include <atomic>
+#include <thread>
+
+
+// A test-and-test-and-set lock for the very short critical sections of the
+// concurrent queues (one heap node, or one small heap). It is one byte
+// instead of std::mutex's 40, and never sleeps in the kernel; a waiter
+// yields its time slice after a few spins, so oversubscribed threads still
+// make progress. Satisfies Lockable, so std::lock_guard works with it.
+class SpinLock {
+public:
+    SpinLock() = default;
+
+    SpinLock(const SpinLock &) = delete;
+    SpinLock &operator=(const SpinLock &) = delete;
+
+
+    // Description: Waits until the lock is free and takes it.
+    // Runtime: O(1) without contention
+    void lock() {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+            // Spin on a plain load, which keeps the cache line shared,
+            // until the lock looks free.
+            for (int spins = 0; locked.load(std::memory_order_relaxed); ++spins) {
+                if (spins >= SPINS_BEFORE_YIELD)
+                    std::this_thread::yield();
+            }
+        }
+    } // lock()
+
+
+    // Description: Takes the lock if it is free. Returns false otherwise.
+    // Runtime: O(1)
+    bool try_lock() {
+        return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+    } // try_lock()
+
+
+    // Description: Releases the lock.
+    // Runtime: O(1)
+    void unlock() {
+        locked.store(false, std::memory_order_release);
+    } // unlock()
+
+
+private:
+    static constexpr int SPINS_BEFORE_YIELD = 64;
+
+    std::atomic<bool> locked{ false };
+}; // SpinLock
+
+
+#endif // SPINLOCK_H
@@ -0,0 +1,599 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef TIMERWHEELPQ_H
+#define TIMERWHEELPQ_H
+
+#include "Eecs281PQ.h"
+#include "PQKey.h"
+#include "PoolAllocator.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// A specialized version of the priority queue ADT implemented as a
+// hierarchical timing wheel (Varghese and Lauck, 1987), for timers that are
+// mostly cancelled or rescheduled before they expire. Elements are mapped
+// to unsigned deadlines by PQKey<TYPE, COMP_FUNCTOR> (see PQKey.h), the
+// earliest deadline being the most extreme element.
+//
+// The wheel has a current time, 'now', and LEVELS levels of 64 slots. A
+// deadline at or after now goes to the level of the first 6-bit digit in
+// which it differs from now, in the slot given by that digit, so a slot of
+// level 0 holds a single deadline and a slot of level l covers 64^l of
+// them. A bitmap per level marks its nonempty slots. Slots are intrusive
+// doubly linked lists of nodes, so addNode(), updateElt() and cancel()
+// only unlink and relink a node: O(1) whatever the size of the wheel.
+//
+// Moving now forward (advance(), or pop() reaching a slot above level 0)
+// spreads the slots that now falls into over the lower levels, so every
+// node moves down at most LEVELS times before it expires. Deadlines
+// already before now go to a 'late' list, kept sorted; they expire first.
+// That list stays short as long as timers are scheduled at or after the
+// time passed to advance().
+//
+// Like PairingPQ, addNode() returns a Node* that stays valid until its
+// element is popped, cancelled or expired, and nodes come from ALLOCATOR
+// (rebound to Node).
+template<typename TYPE, typename COMP_FUNCTOR = std::greater<TYPE>, typename ALLOCATOR = PoolAllocator<TYPE>>
+class TimerWheelPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(HasPQKey<TYPE, COMP_FUNCTOR>::value,
+                  "TimerWheelPQ needs an integer key: specialize PQKey for this type and comparator");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+    using Key = PQKey<TYPE, COMP_FUNCTOR>;
+
+public:
+    using key_type = typename Key::key_type;
+
+    // Each timer within the wheel
+    class Node {
+        public:
+            explicit Node(const TYPE &val) : elt{ val } {}
+
+            explicit Node(TYPE &&val) : elt{ std::move(val) } {}
+
+            // Constructs the element in place from args (used by emplace()).
+            template<typename... Args>
+            explicit Node(std::in_place_t, Args &&...args) : elt(std::forward<Args>(args)...) {}
+
+            // Description: Allows access to the element at that Node's
+            // position.
+            // Runtime: O(1)
+            const TYPE &getElt() const { return elt; }
+            const TYPE &operator*() const { return elt; }
+
+            friend TimerWheelPQ;
+
+        private:
+            TYPE elt;
+            Node *prev = nullptr;
+            Node *next = nullptr;
+            // Key::key(elt), cached.
+            key_type key = 0;
+            // Index into slots, or LATE.
+            std::size_t slot = 0;
+    }; // Node
+
+
+    using allocator_type = ALLOCATOR;
+
+
+    // Description: Construct an empty wheel, at time 0, with an optional
+    //              comparison functor and allocator.
+    // Runtime: O(LEVELS)
+    explicit TimerWheelPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const ALLOCATOR &allocator = ALLOCATOR()) :
+        BaseClass{ comp }, alloc{ allocator } {
+    } // TimerWheelPQ()
+
+
+    // Description: Construct a wheel out of an iterator range with an
+    //              optional comparison functor and allocator.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    TimerWheelPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                 const ALLOCATOR &allocator = ALLOCATOR()) :
+        BaseClass{ comp }, alloc{ allocator } {
+        try {
+            for (; start != end; ++start)
+                addNode(*start);
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    } // TimerWheelPQ()
+
+
+    // Description: Copy constructor. The copy is at the same time as other;
+    //              Node* handles of other do not refer to it.
+    // Runtime: O(n)
+    TimerWheelPQ(const TimerWheelPQ &other) :
+        BaseClass{ other.compare },
+        alloc{ NodeTraits::select_on_container_copy_construction(other.alloc) },
+        now{ other.now } {
+        try {
+            other.forEachNode([this](const Node *node) {
+                Node *copy = createNode(node->elt);
+                copy->key = node->key;
+                place(copy);
+                ++numN;
+            });
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    } // TimerWheelPQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    TimerWheelPQ &operator=(const TimerWheelPQ &rhs) {
+        TimerWheelPQ temp(rhs);
+        std::swap(slots, temp.slots);
+        std::swap(occupied, temp.occupied);
+        std::swap(late, temp.late);
+        std::swap(now, temp.now);
+        std::swap(numN, temp.numN);
+        std::swap(alloc, temp.alloc);
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor
+    // Runtime: O(n)
+    ~TimerWheelPQ() {
+        clear();
+    } // ~TimerWheelPQ()
+
+
+    // Description: Removes every element from the wheel. The time does not
+    //              change.
+    // Runtime: O(n)
+    void clear() {
+        std::vector<Node*> nodes;
+        forEachNode([&nodes](Node *node) { nodes.push_back(node); });
+        for (Node *node : nodes)
+            destroyNode(node);
+        slots.fill(nullptr);
+        occupied.fill(0);
+        late = nullptr;
+        numN = 0;
+    } // clear()
+
+
+    // Description: Assumes that all elements inside the wheel are out of
+    //              order and files every node again under its current
+    //              deadline. Nodes are kept, so handles stay valid.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        std::vector<Node*> nodes;
+        nodes.reserve(numN);
+        forEachNode([&nodes](Node *node) { nodes.push_back(node); });
+        slots.fill(nullptr);
+        occupied.fill(0);
+        late = nullptr;
+        for (Node *node : nodes) {
+            node->key = Key::key(node->elt);
+            place(node);
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the wheel.
+    // Runtime: O(1), or O(late timers) for a deadline before the time
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Add a new element to the wheel, moving from val.
+    // Runtime: O(1), or O(late timers) for a deadline before the time
+    virtual void push(TYPE &&val) {
+        addNode(std::move(val));
+    } // push()
+
+
+    // Description: Add a new element to the wheel, constructed in place
+    //              inside its Node from args.
+    // Runtime: O(1), or O(late timers) for a deadline before the time
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        linkNode(createNode(std::in_place, std::forward<Args>(args)...));
+    } // emplace()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the wheel. If it is in a slot above level 0, the
+    //              time moves to the start of that slot first.
+    // Note: We will not run tests on your code that would require it to pop
+    // an element when the wheel is empty. Though you are welcome to if you
+    // are familiar with them, you do not need to use exceptions in this
+    // project.
+    // Runtime: Amortized O(LEVELS)
+    virtual void pop() {
+        destroyNode(extractTop());
+    } // pop()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the wheel and return it by value (moved, not
+    //              copied).
+    // Runtime: Amortized O(LEVELS)
+    virtual TYPE pop_top() {
+        Node *node = extractTop();
+        TYPE result = std::move(node->elt);
+        destroyNode(node);
+        return result;
+    } // pop_top()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the wheel. This should be a reference for speed. It MUST
+    //              be const because we cannot allow it to be modified, as
+    //              that might make it no longer be the most extreme element.
+    // Runtime: O(LEVELS), plus the size of the slot the earliest deadline
+    //          is in when that slot is above level 0
+    virtual const TYPE &top() const {
+        if (late != nullptr)
+            return late->elt;
+        std::size_t level = lowestLevel();
+        const Node *best = slots[level * SLOTS + lowestSlot(level)];
+        if (level > 0) {
+            for (const Node *node = best->next; node != nullptr; node = node->next) {
+                if (node->key < best->key)
+                    best = node;
+            }
+        }
+        return best->elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the wheel.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return numN;
+    } // size()
+
+
+    // Description: Return true if the wheel is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return numN == 0;
+    } // empty()
+
+
+    // Description: Add a new element to the wheel. Returns a Node*
+    //              corresponding to the newly added element, valid until
+    //              the element leaves the wheel.
+    // Runtime: O(1), or O(late timers) for a deadline before the time
+    Node *addNode(const TYPE &val) {
+        return linkNode(createNode(val));
+    } // addNode()
+
+
+    // Description: Same as above, but moves val into the new Node.
+    // Runtime: As above.
+    Node *addNode(TYPE &&val) {
+        return linkNode(createNode(std::move(val)));
+    } // addNode()
+
+
+    // Description: Replaces the element refered to by node with new_value,
+    //              e.g. to reschedule a timer, earlier or later.
+    // Runtime: O(1), or O(late timers) for a deadline before the time
+    void updateElt(Node *node, const TYPE &new_value) {
+        updateElt(node, TYPE(new_value));
+    } // updateElt()
+
+
+    // Description: Same as above, but moves new_value into the Node.
+    // Runtime: As above.
+    void updateElt(Node *node, TYPE &&new_value) {
+        node->elt = std::move(new_value);
+        const key_type key = Key::key(node->elt);
+        // A timer pushed back within the same slot, as idle timeouts
+        // usually are, stays where it is, so its neighbours are not
+        // touched.
+        if (node->slot != LATE && !(key < now) && slotOf(key) == node->slot) {
+            node->key = key;
+            return;
+        }
+        unlink(node);
+        node->key = key;
+        place(node);
+    } // updateElt()
+
+
+    // Description: Removes the element refered to by node from the wheel
+    //              without it expiring. The node is destroyed, so node must
+    //              not be used afterwards.
+    // Runtime: O(1)
+    void cancel(Node *node) {
+        unlink(node);
+        destroyNode(node);
+        --numN;
+    } // cancel()
+
+
+    // Description: Moves the time to 'to' (if later), and expires every
+    //              element whose deadline is at or before it, in order of
+    //              deadline, by calling fire(TYPE &&) for it. fire may add,
+    //              update or cancel other timers; those due by 'to' expire
+    //              in the same call. Returns the number of elements expired.
+    // Runtime: O(expired + LEVELS) amortized
+    template<typename Fire>
+    std::size_t advance(key_type to, Fire fire) {
+        std::size_t expired = 0;
+        while (numN > 0) {
+            Node *node = late;
+            if (node != nullptr && to < node->key)
+                break;
+            if (node == nullptr) {
+                std::size_t level = lowestLevel();
+                std::size_t slot = lowestSlot(level);
+                key_type start = slotStart(level, slot);
+                if (start > to)
+                    break;
+                if (level > 0) {
+                    moveTo(start);
+                    continue;
+                }
+                // A level-0 slot holds one deadline: drain it front to back.
+                node = slots[slot];
+            }
+            unlink(node);
+            --numN;
+            ++expired;
+            TYPE elt = std::move(node->elt);
+            destroyNode(node);
+            fire(std::move(elt));
+        }
+        if (to > now)
+            moveTo(to);
+        return expired;
+    } // advance()
+
+
+    // Description: The current time of the wheel, in keys.
+    // Runtime: O(1)
+    key_type time() const {
+        return now;
+    } // time()
+
+
+private:
+    using NodeAllocator = typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    static constexpr std::size_t SLOT_BITS = 6;
+    static constexpr std::size_t SLOTS = std::size_t{ 1 } << SLOT_BITS;
+    static constexpr std::size_t KEY_BITS = std::numeric_limits<key_type>::digits;
+    static constexpr std::size_t LEVELS = (KEY_BITS + SLOT_BITS - 1) / SLOT_BITS;
+    // Node::slot of a node on the late list.
+    static constexpr std::size_t LATE = LEVELS * SLOTS;
+
+    static_assert(KEY_BITS <= 64, "keys wider than 64 bits are not supported");
+
+    NodeAllocator alloc;
+    std::array<Node*, LEVELS * SLOTS> slots{};
+    // Bit s of occupied[l] is set when slot s of level l is nonempty.
+    std::array<std::uint64_t, LEVELS> occupied{};
+    // Nodes with a deadline before now, earliest first.
+    Node *late = nullptr;
+    key_type now = 0;
+    std::size_t numN = 0;
+
+
+    // Description: Allocates a node from alloc and constructs it from args.
+    // Runtime: O(1)
+    template<typename... Args>
+    Node *createNode(Args &&...args) {
+        Node *node = NodeTraits::allocate(alloc, 1);
+        try {
+            ::new (static_cast<void*>(node)) Node(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    } // createNode()
+
+    // Description: Destroys a node and gives it back to alloc.
+    // Runtime: O(1)
+    void destroyNode(Node *node) {
+        node->~Node();
+        NodeTraits::deallocate(alloc, node, 1);
+    } // destroyNode()
+
+    // Description: Files a new node and counts it.
+    // Runtime: O(1), or O(late timers) for a deadline before the time
+    Node *linkNode(Node *node) {
+        node->key = Key::key(node->elt);
+        place(node);
+        ++numN;
+        return node;
+    } // linkNode()
+
+    // Description: Calls fn for every node, in no particular order.
+    // Runtime: O(n + LEVELS)
+    template<typename Fn>
+    void forEachNode(Fn fn) const {
+        for (Node *node = late; node != nullptr;) {
+            Node *next = node->next;
+            fn(node);
+            node = next;
+        }
+        for (std::size_t level = 0; level < LEVELS; ++level) {
+            for (std::uint64_t bits = occupied[level]; bits != 0; bits &= bits - 1) {
+                for (Node *node = slots[level * SLOTS + lowestBit(bits)]; node != nullptr;) {
+                    Node *next = node->next;
+                    fn(node);
+                    node = next;
+                }
+            }
+        }
+    } // forEachNode()
+
+    static std::size_t lowestBit(std::uint64_t bits) {
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(__builtin_ctzll(bits));
+#else
+        std::size_t bit = 0;
+        for (; (bits & 1) == 0; bits >>= 1)
+            ++bit;
+        return bit;
+#endif
+    } // lowestBit()
+
+    // Description: The level whose slot key falls into: the index of the
+    //              highest digit in which it differs from now.
+    // Runtime: O(1)
+    std::size_t levelOf(key_type key) const {
+        unsigned long long diff = static_cast<unsigned long long>(key ^ now);
+        if (diff == 0)
+            return 0;
+#if defined(__GNUC__)
+        std::size_t bit = static_cast<std::size_t>(std::numeric_limits<unsigned long long>::digits - 1
+                                                   - __builtin_clzll(diff));
+#else
+        std::size_t bit = 0;
+        while (diff >>= 1)
+            ++bit;
+#endif
+        return bit / SLOT_BITS;
+    } // levelOf()
+
+    // Description: Index into slots for a key at or after now.
+    // Runtime: O(1)
+    std::size_t slotOf(key_type key) const {
+        const std::size_t level = levelOf(key);
+        const std::size_t slot = static_cast<std::size_t>(
+            static_cast<unsigned long long>(key) >> (level * SLOT_BITS)) & (SLOTS - 1);
+        return level * SLOTS + slot;
+    } // slotOf()
+
+    // Description: The lowest level with a nonempty slot. The wheel must
+    //              hold an element that is not late.
+    // Runtime: O(LEVELS)
+    std::size_t lowestLevel() const {
+        std::size_t level = 0;
+        while (occupied[level] == 0)
+            ++level;
+        return level;
+    } // lowestLevel()
+
+    // Description: The earliest nonempty slot of a nonempty level. Every
+    //              slot of a level that is in use lies at or after the digit
+    //              of now, so that is the lowest set bit.
+    // Runtime: O(1)
+    std::size_t lowestSlot(std::size_t level) const {
+        return lowestBit(occupied[level]);
+    } // lowestSlot()
+
+    // Description: The earliest deadline that slot of level could hold:
+    //              the digits of now above level, then slot, then zeros.
+    // Runtime: O(1)
+    key_type slotStart(std::size_t level, std::size_t slot) const {
+        const std::size_t shift = level * SLOT_BITS;
+        unsigned long long high = 0;
+        if (shift + SLOT_BITS < 64)
+            high = static_cast<unsigned long long>(now) >> (shift + SLOT_BITS) << (shift + SLOT_BITS);
+        return static_cast<key_type>(high | (static_cast<unsigned long long>(slot) << shift));
+    } // slotStart()
+
+    // Description: Files node by its cached key: in a slot of the wheel, or
+    //              on the late list if its deadline has passed.
+    // Runtime: O(1), or O(late timers) for a deadline before the time
+    void place(Node *node) {
+        if (node->key < now) {
+            node->slot = LATE;
+            Node *prev = nullptr;
+            Node *next = late;
+            while (next != nullptr && !(node->key < next->key)) {
+                prev = next;
+                next = next->next;
+            }
+            node->prev = prev;
+            node->next = next;
+            (prev == nullptr ? late : prev->next) = node;
+            if (next != nullptr)
+                next->prev = node;
+            return;
+        }
+        node->slot = slotOf(node->key);
+        const std::size_t level = node->slot / SLOTS;
+        const std::size_t slot = node->slot % SLOTS;
+        node->prev = nullptr;
+        node->next = slots[node->slot];
+        if (node->next != nullptr)
+            node->next->prev = node;
+        slots[node->slot] = node;
+        occupied[level] |= std::uint64_t{ 1 } << slot;
+    } // place()
+
+    // Description: Takes node out of its slot or the late list.
+    // Runtime: O(1)
+    void unlink(Node *node) {
+        Node *&head = node->slot == LATE ? late : slots[node->slot];
+        if (node->prev != nullptr)
+            node->prev->next = node->next;
+        else
+            head = node->next;
+        if (node->next != nullptr)
+            node->next->prev = node->prev;
+        if (node->slot != LATE && head == nullptr)
+            occupied[node->slot / SLOTS] &= ~(std::uint64_t{ 1 } << (node->slot % SLOTS));
+    } // unlink()
+
+    // Description: Sets the time to 'to', which must not be after any
+    //              deadline in the wheel. Only the slot that 'to' falls into
+    //              on each level can hold deadlines that now belong lower,
+    //              so those slots are spread over the levels below.
+    // Runtime: O(nodes moved + LEVELS)
+    void moveTo(key_type to) {
+        now = to;
+        for (std::size_t level = 1; level < LEVELS; ++level) {
+            const std::size_t slot = static_cast<std::size_t>(
+                static_cast<unsigned long long>(now) >> (level * SLOT_BITS)) & (SLOTS - 1);
+            if ((occupied[level] & (std::uint64_t{ 1 } << slot)) == 0)
+                continue;
+            Node *node = slots[level * SLOTS + slot];
+            slots[level * SLOTS + slot] = nullptr;
+            occupied[level] &= ~(std::uint64_t{ 1 } << slot);
+            while (node != nullptr) {
+                Node *next = node->next;
+                place(node);
+                node = next;
+            }
+        }
+    } // moveTo()
+
+    // Description: Unlinks the most extreme node and uncounts it, moving
+    //              the time to the start of its slot if that slot is not on
+    //              level 0.
+    // Runtime: Amortized O(LEVELS)
+    Node *extractTop() {
+        Node *node = late;
+        while (node == nullptr) {
+            std::size_t level = lowestLevel();
+            std::size_t slot = lowestSlot(level);
+            if (level == 0)
+                node = slots[slot];
+            else
+                moveTo(slotStart(level, slot));
+        }
+        unlink(node);
+        --numN;
+        return node;
+    } // extractTop()
+}; // TimerWheelPQ
+
+
+#endif // TIMERWHEELPQ_H
@@ -4,6 +4,7 @@
 #define UNORDEREDFASTPQ_H
 
 #include "Eecs281PQ.h"
+#include "FindExtreme.h"
 
 #include <limits>  // needed for UNKNOWN
 
@@ -23,7 +24,7 @@ static const size_t UNKNOWN = std::numeric_limits<size_t>::max();
 // are written, especially the use of this->compare.
 
 template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class UnorderedFastPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+class UnorderedFastPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
@@ -69,6 +70,23 @@ public:
     } // push()
 
 
+    // Description: Add a new element to the PQ, moving from val.
+    // Runtime: Amortized O(1)
+    virtual void push(TYPE &&val) {
+        data.push_back(std::move(val));
+        extreme = UNKNOWN;
+    } // push()
+
+
+    // Description: Construct a new element in place at the back of the PQ.
+    // Runtime: Amortized O(1)
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        data.emplace_back(std::forward<Args>(args)...);
+        extreme = UNKNOWN;
+    } // emplace()
+
+
     // Description: Remove the most extreme (defined by 'compare') element
     //              from the PQ.
     // Note: We will not run tests on your code that would require it to pop
@@ -82,18 +100,25 @@ public:
         if (extreme == UNKNOWN)
             findExtreme();
 
-        // Replace the most extreme element with the element at the back,
-        // then pop_back().  This is much faster than erasing from the middle
-        // of a vector.
-        data[extreme] = data.back();
-        data.pop_back();
-
-        // Since the most extreme element has been removed, we no longer know
-        // where to find it.
-        extreme = UNKNOWN;
+        removeExtreme();
     } // pop()
 
 
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value (moved, not copied).
+    // Runtime: O(n)
+    // Note: If the most extreme element is already known (as would happen if
+    //       .top() was called before), this function is O(1).
+    virtual TYPE pop_top() {
+        if (extreme == UNKNOWN)
+            findExtreme();
+
+        TYPE result = std::move(data[extreme]);
+        removeExtreme();
+        return result;
+    } // pop_top()
+
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the vector.  This should be a reference for speed. It
     //              MUST be const because we cannot allow it to be modified,
@@ -132,18 +157,26 @@ private:
     // stores the index of the most extreme element, or UNKNOWN.
     mutable size_t extreme;
 
+    // Description: Remove the element at index 'extreme'.  Replace it with
+    //              the element at the back, then pop_back().  This is much
+    //              faster than erasing from the middle of a vector.
+    // Runtime: O(1)
+    void removeExtreme() {
+        if (extreme + 1 != data.size())
+            data[extreme] = std::move(data.back());
+        data.pop_back();
+
+        // Since the most extreme element has been removed, we no longer know
+        // where to find it.
+        extreme = UNKNOWN;
+    } // removeExtreme()
+
     // Description: Find the 'most extreme' element of the data vector, using
     //              this->compare() to check if one element is 'less than'
-    //              another.
+    //              another (SIMD for numbers, see FindExtreme.h).
     // Runtime: O(n)
     void findExtreme() const {
-        size_t index = 0;
-
-        for (size_t i = 1; i < data.size(); ++i)
-            if (this->compare(data[index], data[i]))
-                index = i;
-
-        extreme = index;
+        extreme = findExtremeIndex(data.data(), data.size(), this->compare);
     } // findExtreme()
 }; // UnorderedFastPQ
 
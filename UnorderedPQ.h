@@ -5,6 +5,7 @@
 #define UNORDEREDPQ_H
 
 #include "Eecs281PQ.h"
+#include "FindExtreme.h"
 
 
 // A specialized version of the priority queue ADT that is implemented with
@@ -16,7 +17,7 @@
 // are written, especially the use of this->compare.
 
 template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
-class UnorderedPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+class UnorderedPQ final : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
@@ -57,6 +58,21 @@ public:
     } // push()
 
 
+    // Description: Add a new element to the PQ, moving from val.
+    // Runtime: Amortized O(1)
+    virtual void push(TYPE &&val) {
+        data.push_back(std::move(val));
+    } // push()
+
+
+    // Description: Construct a new element in place at the back of the PQ.
+    // Runtime: Amortized O(1)
+    template<typename... Args>
+    void emplace(Args &&...args) {
+        data.emplace_back(std::forward<Args>(args)...);
+    } // emplace()
+
+
     // Description: Remove the most extreme (defined by 'compare') element
     //              from the PQ.
     // Note: We will not run tests on your code that would require it to pop
@@ -66,14 +82,21 @@ public:
     // Note: If the most extreme element is already known (as would happen if
     //       .top() was called before .pop()), this function is O(1).
     virtual void pop() {
-        // Replace the most extreme element with the element at the back,
-        // then pop_back().  This is much faster than erasing from the middle
-        // of a vector.
-        data[findExtreme()] = data.back();
-        data.pop_back();
+        removeAt(findExtreme());
     } // pop()
 
 
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ and return it by value (moved, not copied).
+    // Runtime: O(n)
+    virtual TYPE pop_top() {
+        size_t index = findExtreme();
+        TYPE result = std::move(data[index]);
+        removeAt(index);
+        return result;
+    } // pop_top()
+
+
     // Description: Return the most extreme (defined by 'compare') element of
     //              the vector.  This should be a reference for speed.  It
     //              MUST be const because we cannot allow it to be modified,
@@ -104,18 +127,24 @@ private:
     std::vector<TYPE> data;
 
 private:
+    // Description: Remove the element at index.  Replace it with the element
+    //              at the back, then pop_back().  This is much faster than
+    //              erasing from the middle of a vector.
+    // Runtime: O(1)
+    void removeAt(size_t index) {
+        if (index + 1 != data.size())
+            data[index] = std::move(data.back());
+        data.pop_back();
+    } // removeAt()
+
+
     // Description: Find the 'most extreme' element of the data vector, using
     //              this->compare() to check if one element is 'less than'
-    //              another.
+    //              another.  findExtremeIndex() is that loop, vectorized
+    //              for arithmetic TYPEs with std::less or std::greater.
     // Runtime: O(n)
     size_t findExtreme() const {
-        size_t index = 0;
-
-        for (size_t i = 1; i < data.size(); ++i)
-            if (this->compare(data[index], data[i]))
-                index = i;
-
-        return index;
+        return findExtremeIndex(data.data(), data.size(), this->compare);
     } // findExtreme()
 }; // UnorderedPQ
 
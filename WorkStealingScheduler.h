@@ -0,0 +1,311 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef WORKSTEALINGSCHEDULER_H
+#define WORKSTEALINGSCHEDULER_H
+
+#include "BinaryPQ.h"
+#include "ParallelRebuild.h"
+#include "SpinLock.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// What a worker that ran out of tasks takes from its victim.
+enum class StealPolicy {
+    One,    // the victim's top task
+    Half,   // the better half of the victim's tasks
+};
+
+
+// Runs prioritized tasks on several threads, each with its own BinaryPQ
+// (after the work-stealing schedulers of Blumofe and Leiserson, with
+// priorities per worker). A worker pushes the tasks it creates to its own
+// queue and pops its own top, so the threads share no queue and no
+// counter on the common path. A worker whose queue is empty steals from
+// random victims, per StealPolicy.
+//
+// The order is therefore only approximate: each worker processes its own
+// top, which may be worse than the top of another worker. Processing a
+// task may have to be repeated or undone later; the caller has to cope
+// with that, as label-correcting algorithms do.
+//
+// run() returns once every task is done, including the ones pushed while
+// it ran. To find out, a shared count of the tasks that are not finished
+// is kept, but the workers reserve it in batches of CREDIT_BATCH and
+// return the unused part only when they run out of work, so it is
+// touched rarely.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class WorkStealingScheduler {
+public:
+    // What the workers did during one run().
+    struct Stats {
+        std::size_t processed = 0;      // tasks processed
+        std::size_t steals = 0;         // successful steals
+        std::size_t stolen = 0;         // tasks taken by them
+        std::size_t failedSteals = 0;   // steal attempts that found nothing
+    };
+
+
+    // The handle a task gets to push the tasks it creates.
+    class Worker {
+    public:
+        // Description: Add a task to this worker's queue.
+        // Runtime: O(log(n)) where n is the size of the worker's queue.
+        void push(const TYPE &task) {
+            scheduler.pushLocal(*this, TYPE(task));
+        } // push()
+
+        // Description: Add a task to this worker's queue, moving from task.
+        // Runtime: O(log(n)) where n is the size of the worker's queue.
+        void push(TYPE &&task) {
+            scheduler.pushLocal(*this, std::move(task));
+        } // push()
+
+        // Description: Index of this worker, from 0 to workers() - 1.
+        // Runtime: O(1)
+        std::size_t index() const {
+            return id;
+        } // index()
+
+    private:
+        friend class WorkStealingScheduler;
+
+        WorkStealingScheduler &scheduler;
+        std::size_t id;
+        std::size_t credits = 0;
+        std::minstd_rand rng;
+        Stats stats;
+
+        Worker(WorkStealingScheduler &owner, std::size_t i) :
+            scheduler{ owner }, id{ i }, rng{ static_cast<std::minstd_rand::result_type>(i + 1) } {}
+    }; // Worker
+
+
+    // Description: Construct a scheduler with the given number of workers (0
+    //              means one per hardware thread), comparison functor and
+    //              steal policy.
+    // Runtime: O(workers)
+    explicit WorkStealingScheduler(std::size_t workers = 0, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                                   StealPolicy steal = StealPolicy::Half) :
+        policy{ steal } {
+        if (workers == 0)
+            workers = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        for (std::size_t i = 0; i < workers; ++i)
+            lanes.push_back(std::make_unique<Lane>(comp));
+    } // WorkStealingScheduler()
+
+
+    // Description: Add a task before run(), dealing tasks out to the
+    //              workers in turn. Not thread safe, and not for use during
+    //              run(); tasks push through their Worker instead.
+    // Runtime: O(log(n))
+    void push(const TYPE &task) {
+        Lane &lane = *lanes[nextLane++ % lanes.size()];
+        pending.fetch_add(1);
+        lane.lock.lock();
+        lane.heap.push(task);
+        lane.size.store(lane.heap.size(), std::memory_order_relaxed);
+        lane.lock.unlock();
+    } // push()
+
+
+    // Description: Processes every task with process(TYPE &&task, Worker &)
+    //              on workers() threads, the calling one included, and
+    //              returns when none is left. process may push new tasks
+    //              through the Worker. If it throws, the workers stop, the
+    //              remaining tasks are dropped and the exception is
+    //              rethrown here.
+    // Runtime: O(tasks * log(n) / workers) plus the cost of process
+    template<typename Process>
+    Stats run(Process process) {
+        std::vector<Worker> workers;
+        workers.reserve(lanes.size());
+        for (std::size_t i = 0; i < lanes.size(); ++i)
+            workers.push_back(Worker{ *this, i });
+        failed.store(false);
+        try {
+            parallelFor(lanes.size(), lanes.size(), [&](std::size_t i) {
+                work(workers[i], process);
+            });
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+
+        Stats total;
+        for (const Worker &worker : workers) {
+            total.processed += worker.stats.processed;
+            total.steals += worker.stats.steals;
+            total.stolen += worker.stats.stolen;
+            total.failedSteals += worker.stats.failedSteals;
+        }
+        return total;
+    } // run()
+
+
+    // Description: Number of workers.
+    // Runtime: O(1)
+    std::size_t workers() const {
+        return lanes.size();
+    } // workers()
+
+
+private:
+    // Tasks a worker adds to the shared count at a time.
+    static constexpr std::size_t CREDIT_BATCH = 64;
+    // Random victims a worker tries before it checks for the end.
+    static constexpr std::size_t STEAL_TRIES = 4;
+
+    // Each lane sits on its own cache lines, so that workers do not
+    // invalidate each other's.
+    struct alignas(64) Lane {
+        SpinLock lock;
+        BinaryPQ<TYPE, COMP_FUNCTOR> heap;
+        // heap.size(), readable without the lock, so thieves can skip
+        // empty lanes without taking their locks.
+        std::atomic<std::size_t> size{ 0 };
+
+        explicit Lane(const COMP_FUNCTOR &comp) : heap{ comp } {}
+    };
+
+    std::vector<std::unique_ptr<Lane>> lanes;
+    StealPolicy policy;
+    std::size_t nextLane = 0;
+    // Unfinished tasks plus the credits the workers hold.
+    std::atomic<std::size_t> pending{ 0 };
+    std::atomic<bool> failed{ false };
+
+    template<typename Process>
+    void work(Worker &worker, Process &process) {
+        while (!failed.load(std::memory_order_relaxed)) {
+            std::optional<TYPE> task = popLocal(worker.id);
+            if (!task)
+                task = steal(worker);
+            if (task) {
+                try {
+                    process(std::move(*task), worker);
+                }
+                catch (...) {
+                    failed.store(true);
+                    throw;
+                }
+                ++worker.stats.processed;
+                // The finished task's credit goes back to the worker, and
+                // what it holds beyond two batches to the shared count.
+                if (++worker.credits > 2 * CREDIT_BATCH) {
+                    pending.fetch_sub(worker.credits - CREDIT_BATCH);
+                    worker.credits = CREDIT_BATCH;
+                }
+                continue;
+            }
+            // Out of work: give back every credit, so the count can reach
+            // zero once all the other workers are out of work too.
+            if (worker.credits > 0) {
+                pending.fetch_sub(worker.credits);
+                worker.credits = 0;
+            }
+            if (pending.load() == 0)
+                break;
+            std::this_thread::yield();
+        }
+    } // work()
+
+    // Description: Pushes to the worker's own lane. A task is counted
+    //              before it can be seen, from credits taken in batches.
+    // Runtime: O(log(n))
+    void pushLocal(Worker &worker, TYPE &&task) {
+        if (worker.credits == 0) {
+            pending.fetch_add(CREDIT_BATCH);
+            worker.credits = CREDIT_BATCH;
+        }
+        --worker.credits;
+        Lane &lane = *lanes[worker.id];
+        lane.lock.lock();
+        lane.heap.push(std::move(task));
+        lane.size.store(lane.heap.size(), std::memory_order_relaxed);
+        lane.lock.unlock();
+    } // pushLocal()
+
+    // Description: Pops the top of a lane, if it has one.
+    // Runtime: O(log(n))
+    std::optional<TYPE> popLocal(std::size_t i) {
+        Lane &lane = *lanes[i];
+        if (lane.size.load(std::memory_order_relaxed) == 0)
+            return std::nullopt;
+        std::optional<TYPE> task;
+        lane.lock.lock();
+        if (!lane.heap.empty()) {
+            task.emplace(lane.heap.pop_top());
+            lane.size.store(lane.heap.size(), std::memory_order_relaxed);
+        }
+        lane.lock.unlock();
+        return task;
+    } // popLocal()
+
+    // Description: Takes work from up to STEAL_TRIES random victims and
+    //              returns the best task taken; with StealPolicy::Half, the
+    //              rest of the better half goes to the thief's own lane.
+    // Runtime: O(k log(n)) for k tasks taken
+    std::optional<TYPE> steal(Worker &worker) {
+        if (lanes.size() == 1)
+            return std::nullopt;
+        for (std::size_t attempt = 0; attempt < STEAL_TRIES; ++attempt) {
+            // Any lane but the thief's own.
+            std::size_t victim = worker.rng() % (lanes.size() - 1);
+            if (victim >= worker.id)
+                ++victim;
+            Lane &lane = *lanes[victim];
+            if (lane.size.load(std::memory_order_relaxed) == 0 || !lane.lock.try_lock()) {
+                ++worker.stats.failedSteals;
+                continue;
+            }
+
+            std::vector<TYPE> taken;
+            std::size_t want = policy == StealPolicy::Half ? (lane.heap.size() + 1) / 2 : 1;
+            while (taken.size() < want && !lane.heap.empty())
+                taken.push_back(lane.heap.pop_top());
+            lane.size.store(lane.heap.size(), std::memory_order_relaxed);
+            lane.lock.unlock();
+            if (taken.empty()) {
+                ++worker.stats.failedSteals;
+                continue;
+            }
+
+            ++worker.stats.steals;
+            worker.stats.stolen += taken.size();
+            if (taken.size() > 1) {
+                Lane &own = *lanes[worker.id];
+                own.lock.lock();
+                for (std::size_t k = 1; k < taken.size(); ++k)
+                    own.heap.push(std::move(taken[k]));
+                own.size.store(own.heap.size(), std::memory_order_relaxed);
+                own.lock.unlock();
+            }
+            return std::move(taken.front());
+        }
+        return std::nullopt;
+    } // steal()
+
+    // Description: Drops every task, after a failed run().
+    // Runtime: O(n)
+    void clear() {
+        for (std::unique_ptr<Lane> &lane : lanes) {
+            while (!lane->heap.empty())
+                lane->heap.pop();
+            lane->size.store(0, std::memory_order_relaxed);
+        }
+        pending.store(0);
+    } // clear()
+}; // WorkStealingScheduler
+
+
+#endif // WORKSTEALINGSCHEDULER_H
@@ -0,0 +1,342 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+/*
+ * Benchmark driver for the thread-safe priority queues. Every queue is
+ * filled with n random ints, then T threads each run n / T operations of a
+ * mixed workload: a push of a random int or a try_pop(), with equal odds.
+ * The driver reports the throughput for every thread count, with its
+ * speedup over the first thread count.
+ *
+ * Build with 'make benchConcurrentPQ' (always an optimized build), then for
+ * example:
+ *
+ *     ./benchConcurrentPQ                  every queue, 1,2,4,8,16 threads
+ *     ./benchConcurrentPQ -n 1000000 -t 1,8 -i LockedHeap,MultiQueue
+ *     ./benchConcurrentPQ --help
+ *
+ * Queues:
+ *   MutexBinary  a BinaryPQ behind one std::mutex, the baseline
+ *   LockedHeap   LockedHeapPQ, a heap with a lock per node
+ *   MultiQueue   MultiQueuePQ with its defaults (two lanes per hardware
+ *                thread, two choices)
+ *   SkipList     SkipListPQ, lock-free
+ *
+ * MultiQueue trades exactness for scalability, so the driver also measures
+ * its rank error: with one thread, it pops n / 2 elements from a queue of
+ * n and counts, for each, how many elements still in the queue were
+ * greater. The table lists the mean and maximum rank error over a grid of
+ * lane and choice counts (-l, -c). A rank error of 0 is an exact pop.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "LockedHeapPQ.h"
+#include "MultiQueuePQ.h"
+#include "SkipListPQ.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+
+// BinaryPQ behind one lock: what a program gets without a concurrent queue.
+class MutexBinaryPQ {
+public:
+    void push(int val) {
+        std::lock_guard<std::mutex> guard{ lock };
+        heap.push(val);
+    } // push()
+
+    bool try_pop(int &out) {
+        std::lock_guard<std::mutex> guard{ lock };
+        if (heap.empty())
+            return false;
+        out = heap.pop_top();
+        return true;
+    } // try_pop()
+
+private:
+    std::mutex lock;
+    BinaryPQ<int> heap;
+}; // MutexBinaryPQ
+
+
+struct Options {
+    size_t size = 1000000;
+    uint32_t seed = 281;
+    std::vector<std::string> impls;
+    std::vector<size_t> threadCounts;
+    std::vector<size_t> laneCounts;
+    std::vector<size_t> choiceCounts;
+};
+
+
+// Description: Fills the queue with n random ints, then times 'threads'
+//              threads each doing n / threads random pushes and try_pops.
+//              Returns operations per second.
+template<typename PQ>
+double throughput(size_t threads, const Options &opt) {
+    PQ pq;
+    std::mt19937 rng{ opt.seed };
+    for (size_t i = 0; i < opt.size; ++i)
+        pq.push(static_cast<int>(rng() >> 1));
+
+    const size_t perThread = opt.size / threads;
+    auto work = [&](size_t t) {
+        std::mt19937 local{ static_cast<uint32_t>(opt.seed + t + 1) };
+        uint64_t sum = 0;
+        for (size_t i = 0; i < perThread; ++i) {
+            uint32_t r = static_cast<uint32_t>(local());
+            int value = 0;
+            if (r & 1)
+                pq.push(static_cast<int>(r >> 1));
+            else if (pq.try_pop(value))
+                sum += static_cast<uint64_t>(value);
+        }
+        return sum;
+    };
+
+    std::vector<std::thread> helpers;
+    std::vector<uint64_t> sums(threads);
+    Clock::time_point start = Clock::now();
+    for (size_t t = 1; t < threads; ++t)
+        helpers.emplace_back([&, t]() { sums[t] = work(t); });
+    sums[0] = work(0);
+    for (std::thread &helper : helpers)
+        helper.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return seconds > 0 ? static_cast<double>(perThread * threads) / seconds : 0.0;
+} // throughput()
+
+
+struct Impl {
+    const char *name;
+    double (*run)(size_t, const Options &);
+};
+
+const std::vector<Impl> &implementations() {
+    static const std::vector<Impl> impls {
+        { "MutexBinary", throughput<MutexBinaryPQ> },
+        { "LockedHeap", throughput<LockedHeapPQ<int>> },
+        { "MultiQueue", throughput<MultiQueuePQ<int>> },
+        { "SkipList", throughput<SkipListPQ<int>> },
+    };
+    return impls;
+} // implementations()
+
+
+// A Fenwick tree over the values 0..n-1, counting how many of them are
+// still in the queue, so the rank of a popped value takes O(log n).
+class PresentCounts {
+public:
+    explicit PresentCounts(size_t n) : tree(n + 1, 0) {}
+
+    void add(size_t value, int delta) {
+        for (size_t i = value + 1; i < tree.size(); i += i & (~i + 1))
+            tree[i] += delta;
+    } // add()
+
+    // Number of present values below 'value'.
+    int below(size_t value) const {
+        int sum = 0;
+        for (size_t i = value; i > 0; i -= i & (~i + 1))
+            sum += tree[i];
+        return sum;
+    } // below()
+
+private:
+    std::vector<int> tree;
+}; // PresentCounts
+
+
+struct RankError {
+    double mean = 0;
+    int max = 0;
+};
+
+
+// Description: Pops half of a queue holding a permutation of 0..n-1 with
+//              try_pop() and measures how far each pop was from the top.
+// Runtime: O(n log n)
+RankError rankError(size_t lanes, size_t choices, const Options &opt) {
+    std::vector<int> values(opt.size);
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = static_cast<int>(i);
+    std::mt19937 rng{ opt.seed };
+    std::shuffle(values.begin(), values.end(), rng);
+
+    MultiQueuePQ<int> pq{ std::less<int>(), lanes, choices };
+    PresentCounts present{ opt.size };
+    for (int value : values) {
+        pq.push(value);
+        present.add(static_cast<size_t>(value), 1);
+    }
+
+    RankError result;
+    size_t remaining = opt.size;
+    const size_t pops = opt.size / 2;
+    for (size_t i = 0; i < pops; ++i) {
+        int value = 0;
+        pq.try_pop(value);
+        present.add(static_cast<size_t>(value), -1);
+        --remaining;
+        // Everything still present and above value was a better answer.
+        int rank = static_cast<int>(remaining) - present.below(static_cast<size_t>(value));
+        result.mean += rank;
+        result.max = std::max(result.max, rank);
+    }
+    if (pops > 0)
+        result.mean /= static_cast<double>(pops);
+    return result;
+} // rankError()
+
+
+std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::istringstream iss{ list };
+    std::string item;
+    while (std::getline(iss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+} // splitList()
+
+
+std::vector<size_t> splitCounts(const std::string &list) {
+    std::vector<size_t> counts;
+    for (const std::string &count : splitList(list))
+        counts.push_back(std::max<size_t>(std::stoul(count), 1));
+    return counts;
+} // splitCounts()
+
+
+void printHelp(const char *argv0) {
+    std::cout << "Usage: " << argv0 << " [options]\n"
+              << "  -n, --size N          prefill and operations per run (default 1000000)\n"
+              << "  -i, --impl LIST       comma separated queue names (default all)\n"
+              << "  -s, --seed N          random seed (default 281)\n"
+              << "  -t, --threads LIST    thread counts (default 1,2,4,8,16)\n"
+              << "  -l, --lanes LIST      MultiQueue lanes for the rank error table (default 4,16,64)\n"
+              << "  -c, --choices LIST    MultiQueue choices for the rank error table (default 1,2,4)\n"
+              << "  -h, --help            show this message\n"
+              << "Queues:";
+    for (const Impl &impl : implementations())
+        std::cout << ' ' << impl.name;
+    std::cout << std::endl;
+} // printHelp()
+
+
+Options parseOptions(int argc, char *argv[]) {
+    static const option longOpts[] = {
+        { "size", required_argument, nullptr, 'n' },
+        { "impl", required_argument, nullptr, 'i' },
+        { "seed", required_argument, nullptr, 's' },
+        { "threads", required_argument, nullptr, 't' },
+        { "lanes", required_argument, nullptr, 'l' },
+        { "choices", required_argument, nullptr, 'c' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, '\0' },
+    };
+
+    Options opt;
+    int choice = 0;
+    while ((choice = getopt_long(argc, argv, "n:i:s:t:l:c:h", longOpts, nullptr)) != -1) {
+        switch (choice) {
+        case 'n':
+            opt.size = std::stoul(optarg);
+            break;
+        case 'i':
+            opt.impls = splitList(optarg);
+            break;
+        case 's':
+            opt.seed = static_cast<uint32_t>(std::stoul(optarg));
+            break;
+        case 't':
+            opt.threadCounts = splitCounts(optarg);
+            break;
+        case 'l':
+            opt.laneCounts = splitCounts(optarg);
+            break;
+        case 'c':
+            opt.choiceCounts = splitCounts(optarg);
+            break;
+        case 'h':
+            printHelp(argv[0]);
+            std::exit(0);
+        default:
+            printHelp(argv[0]);
+            std::exit(1);
+        }
+    }
+
+    if (opt.threadCounts.empty())
+        opt.threadCounts = { 1, 2, 4, 8, 16 };
+    if (opt.laneCounts.empty())
+        opt.laneCounts = { 4, 16, 64 };
+    if (opt.choiceCounts.empty())
+        opt.choiceCounts = { 1, 2, 4 };
+    if (opt.impls.empty())
+        for (const Impl &impl : implementations())
+            opt.impls.push_back(impl.name);
+    return opt;
+} // parseOptions()
+
+
+int main(int argc, char *argv[]) {
+    std::ios_base::sync_with_stdio(false);
+    Options opt = parseOptions(argc, argv);
+
+    std::cout << "Concurrent PQ benchmark, n = " << opt.size << ", seed = " << opt.seed
+              << ", hardware threads = " << std::thread::hardware_concurrency() << std::endl
+              << std::left << std::setw(16) << "impl" << std::right << std::setw(8) << "threads"
+              << std::setw(14) << "ops/sec" << std::setw(10) << "speedup" << std::endl;
+    for (const std::string &name : opt.impls) {
+        const Impl *impl = nullptr;
+        for (const Impl &candidate : implementations())
+            if (name == candidate.name)
+                impl = &candidate;
+        if (impl == nullptr) {
+            std::cerr << "Unknown queue " << name << std::endl;
+            return 1;
+        }
+
+        double base = 0;
+        for (size_t threads : opt.threadCounts) {
+            double ops = impl->run(threads, opt);
+            if (base == 0)
+                base = ops;
+            std::cout << std::left << std::setw(16) << impl->name << std::right << std::setw(8) << threads
+                      << std::setw(14) << std::fixed << std::setprecision(0) << ops << std::setw(9)
+                      << std::setprecision(2) << (base > 0 ? ops / base : 0.0) << 'x' << std::endl;
+        }
+    }
+
+    std::cout << std::endl << "MultiQueue rank error of try_pop (mean / max):" << std::endl
+              << "  " << std::left << std::setw(8) << "lanes" << std::right;
+    for (size_t choices : opt.choiceCounts)
+        std::cout << std::setw(15) << (std::to_string(choices) + " choice" + (choices == 1 ? "" : "s"));
+    std::cout << std::endl;
+    for (size_t lanes : opt.laneCounts) {
+        std::cout << "  " << std::left << std::setw(8) << lanes << std::right;
+        for (size_t choices : opt.choiceCounts) {
+            RankError error = rankError(lanes, choices, opt);
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(1) << error.mean << " / " << error.max;
+            std::cout << std::setw(15) << cell.str();
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+} // main()
@@ -0,0 +1,277 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+/*
+ * Benchmark driver for ExternalPQ, on a batch job that pushes n random ints
+ * and then pops all of them. The same job is run on a BinaryPQ, which keeps
+ * everything in memory, and on an ExternalPQ whose insertion buffer holds
+ * only m elements and spills the rest to disk. Every queue runs in its own
+ * child process, so the peak RSS column is that queue's alone; the
+ * checksum folds in every popped value in order and must be identical for
+ * all queues.
+ *
+ * Build with 'make benchExternal' (always an optimized build), then for
+ * example:
+ *
+ *     ./benchExternal                      both queues, default sizes
+ *     ./benchExternal -n 200000000 -m 4000000 -i External
+ *     ./benchExternal --help
+ *
+ * Queues:
+ *   Binary    BinaryPQ<int>
+ *   External  ExternalPQ<int> with an m element buffer and blocks of b
+ *             elements (1 MiB by default), spilling to $TMPDIR or -d DIR
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BinaryPQ.h"
+#include "ExternalPQ.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+
+struct Options {
+    size_t elements = 20000000;
+    size_t memoryElements = 1000000;
+    size_t blockElements = 0;
+    std::string directory;
+    uint32_t seed = 281;
+    std::vector<std::string> impls;
+};
+
+
+// What a run did. Every queue must report the same checksum.
+struct Result {
+    double pushSeconds = 0;
+    double popSeconds = 0;
+    uint64_t spilledBytes = 0;
+    uint64_t readBackBytes = 0;
+    size_t runs = 0;
+    uint64_t checksum = 0;
+};
+
+
+// Description: Records what pq spilled so far: nothing for a queue that
+//              stays in memory. The runs are counted when the pushes are
+//              done, before pops use them up.
+void noteSpills(Result &, const BinaryPQ<int> &) {
+} // noteSpills()
+
+void noteSpills(Result &result, const ExternalPQ<int> &pq) {
+    result.runs = std::max(result.runs, pq.runCount());
+    result.spilledBytes = pq.bytesSpilled();
+    result.readBackBytes = pq.bytesReadBack();
+} // noteSpills()
+
+
+// Description: Pushes opt.elements random ints into pq, then pops them all,
+//              checking that they come out in order.
+template<typename PQ>
+Result batch(PQ &pq, const Options &opt) {
+    std::mt19937 rng{ opt.seed };
+    Result result;
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < opt.elements; ++i)
+        pq.push(static_cast<int>(rng() >> 1));
+    Clock::time_point pushed = Clock::now();
+    noteSpills(result, pq);
+    int last = pq.empty() ? 0 : pq.top();
+    while (!pq.empty()) {
+        int val = pq.pop_top();
+        if (val > last) {
+            std::cerr << "out of order: " << val << " after " << last << std::endl;
+            std::exit(1);
+        }
+        last = val;
+        result.checksum = result.checksum * 1000003 + static_cast<uint64_t>(val);
+    }
+    Clock::time_point popped = Clock::now();
+    noteSpills(result, pq);
+
+    result.pushSeconds = std::chrono::duration<double>(pushed - start).count();
+    result.popSeconds = std::chrono::duration<double>(popped - pushed).count();
+    return result;
+} // batch()
+
+
+Result runBinary(const Options &opt) {
+    BinaryPQ<int> pq;
+    return batch(pq, opt);
+} // runBinary()
+
+
+Result runExternal(const Options &opt) {
+    ExternalPQ<int> pq{ std::less<int>(), opt.memoryElements, opt.blockElements, opt.directory };
+    return batch(pq, opt);
+} // runExternal()
+
+
+struct Impl {
+    const char *name;
+    Result (*run)(const Options &);
+};
+
+const std::vector<Impl> &implementations() {
+    static const std::vector<Impl> impls {
+        { "Binary", runBinary },
+        { "External", runExternal },
+    };
+    return impls;
+} // implementations()
+
+
+long peakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+} // peakRssKb()
+
+
+std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::istringstream iss{ list };
+    std::string item;
+    while (std::getline(iss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+} // splitList()
+
+
+void printHelp(const char *argv0) {
+    std::cout << "Usage: " << argv0 << " [options]\n"
+              << "  -n, --elements N      ints pushed, then popped (default 20000000)\n"
+              << "  -m, --memory N        elements ExternalPQ keeps in memory (default 1000000)\n"
+              << "  -b, --block N         elements per block of I/O (default 1 MiB worth)\n"
+              << "  -d, --dir DIR         directory for the spill file (default $TMPDIR or /tmp)\n"
+              << "  -i, --impl LIST       comma separated queue names (default all)\n"
+              << "  -s, --seed N          random seed (default 281)\n"
+              << "  -h, --help            show this message\n"
+              << "Queues:";
+    for (const Impl &impl : implementations())
+        std::cout << ' ' << impl.name;
+    std::cout << std::endl;
+} // printHelp()
+
+
+Options parseOptions(int argc, char *argv[]) {
+    static const option longOpts[] = {
+        { "elements", required_argument, nullptr, 'n' },
+        { "memory", required_argument, nullptr, 'm' },
+        { "block", required_argument, nullptr, 'b' },
+        { "dir", required_argument, nullptr, 'd' },
+        { "impl", required_argument, nullptr, 'i' },
+        { "seed", required_argument, nullptr, 's' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, '\0' },
+    };
+
+    Options opt;
+    int choice = 0;
+    while ((choice = getopt_long(argc, argv, "n:m:b:d:i:s:h", longOpts, nullptr)) != -1) {
+        switch (choice) {
+        case 'n':
+            opt.elements = std::stoul(optarg);
+            break;
+        case 'm':
+            opt.memoryElements = std::max<size_t>(std::stoul(optarg), 1);
+            break;
+        case 'b':
+            opt.blockElements = std::stoul(optarg);
+            break;
+        case 'd':
+            opt.directory = optarg;
+            break;
+        case 'i':
+            opt.impls = splitList(optarg);
+            break;
+        case 's':
+            opt.seed = static_cast<uint32_t>(std::stoul(optarg));
+            break;
+        case 'h':
+            printHelp(argv[0]);
+            std::exit(0);
+        default:
+            printHelp(argv[0]);
+            std::exit(1);
+        }
+    }
+
+    if (opt.impls.empty())
+        for (const Impl &impl : implementations())
+            opt.impls.push_back(impl.name);
+    return opt;
+} // parseOptions()
+
+
+// Description: Runs impl in a child process and prints its row, so that
+//              the peak RSS belongs to that queue alone.
+// Returns: false if the child failed.
+bool runForked(const Impl &impl, const Options &opt) {
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "fork failed" << std::endl;
+        return false;
+    }
+    if (pid == 0) {
+        Result r = impl.run(opt);
+        const double seconds = r.pushSeconds + r.popSeconds;
+        std::cout << std::left << std::setw(10) << impl.name << std::right << std::fixed
+                  << std::setw(10) << std::setprecision(1) << r.pushSeconds * 1000
+                  << std::setw(10) << r.popSeconds * 1000 << std::setw(14) << std::setprecision(0)
+                  << (seconds > 0 ? 2.0 * static_cast<double>(opt.elements) / seconds : 0.0)
+                  << std::setw(12) << std::setprecision(1) << static_cast<double>(r.spilledBytes) / 1048576.0
+                  << std::setw(12) << static_cast<double>(r.readBackBytes) / 1048576.0
+                  << std::setw(7) << r.runs << std::setw(12) << peakRssKb() << std::setw(22) << r.checksum
+                  << std::endl;
+        std::exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+} // runForked()
+
+
+int main(int argc, char *argv[]) {
+    std::ios_base::sync_with_stdio(false);
+    Options opt = parseOptions(argc, argv);
+
+    std::cout << "External memory benchmark, n = " << opt.elements << ", m = " << opt.memoryElements
+              << ", seed = " << opt.seed << std::endl
+              << std::left << std::setw(10) << "impl" << std::right << std::setw(10) << "push ms"
+              << std::setw(10) << "pop ms" << std::setw(14) << "ops/sec" << std::setw(12) << "spilled MB"
+              << std::setw(12) << "read MB" << std::setw(7) << "runs" << std::setw(12) << "rss(KB)"
+              << std::setw(22) << "checksum" << std::endl;
+    for (const std::string &name : opt.impls) {
+        const Impl *impl = nullptr;
+        for (const Impl &candidate : implementations())
+            if (name == candidate.name)
+                impl = &candidate;
+        if (impl == nullptr) {
+            std::cerr << "Unknown queue " << name << std::endl;
+            return 1;
+        }
+        if (!runForked(*impl, opt)) {
+            std::cerr << impl->name << " failed" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+} // main()
@@ -0,0 +1,1418 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+/*
+ * Benchmark driver for the priority queue implementations. Every queue is
+ * run through the same deterministic workloads and the driver reports
+ * throughput, per-operation latency percentiles and the peak resident set
+ * size of the process that ran the workload.
+ *
+ * Build with 'make benchPQ' (always an optimized build), then for example:
+ *
+ *     ./benchPQ                            every queue, every workload
+ *     ./benchPQ -n 1000000 -i Binary,Pairing -w hold,dijkstra
+ *     ./benchPQ -n 100000000 -i Binary,BHeap -w hold,pop
+ *     ./benchPQ --help
+ *
+ * Payloads (the element type of every workload except dijkstra and dense):
+ *   int       plain int
+ *   string    32 character std::string (heap allocated, expensive to copy)
+ *   large     64 byte struct ordered by an int key (expensive to move)
+ *
+ * Workloads:
+ *   push      90% push / 10% pop, starting from an empty queue. Every pop
+ *             is a pop_top(), which is how the queues are used in practice.
+ *   pop       10% push / 90% pop, starting from a queue of size n
+ *   hold      pop followed by push of a lower-priority value, steady size n
+ *   dijkstra  single-source shortest paths on a random graph, using lazy
+ *             deletion (re-push instead of decrease-key). Radix (RadixPQ)
+ *             runs only this workload, the only one whose priorities are
+ *             popped in monotone order.
+ *   dense     single-source shortest paths on a dense random graph: about
+ *             2 * sqrt(n) vertices, each with edges to a quarter of them.
+ *             Queues with two-way handles (IndexedBinary, Pairing,
+ *             Fibonacci, RankPairing) use decrease-key: addNode() once per
+ *             vertex and updateElt() for every improved distance. All
+ *             others use lazy deletion as in dijkstra. Throughput counts
+ *             edges relaxed, which is the same for every queue.
+ *   bounded   50% push / 50% pop of priorities in 0..4095, like QoS
+ *             classes, starting from a queue of size n. Bucket (BucketPQ,
+ *             one bucket per priority) runs only this workload.
+ *   range     bulk construction from an iterator range of n elements
+ *   merge     consolidation of 10 shards that hold n elements between them
+ *             into the first one. Queues with merge() (Binary, BHeap,
+ *             Pairing, Sorted) use it; all others pop every element of a shard and
+ *             push it into the first. Throughput counts the elements moved.
+ *   update    sparse priority changes: the queue holds ids ordered by an
+ *             external key array; each step moves 4 random keys up or down,
+ *             repairs the queue, then pops the top id and pushes it back
+ *             with a new key. Queues with two-way handles (IndexedBinary,
+ *             Pairing, Fibonacci, RankPairing) repair with updateElt(), all
+ *             others with notifyChanged().
+ *             At most 2000 steps are run.
+ *   rebuild   full rebuilds: the queue holds n ids ordered by an external
+ *             key array; each repetition draws new keys for all of them
+ *             (untimed) and times one updatePriorities().
+ *
+ * The range and rebuild workloads are run once for every thread count
+ * given with --threads (default 1,4,16,64), which is passed on to
+ * setRebuildThreads(); only Binary and Sorted use it, and only for
+ * queues of at least PARALLEL_REBUILD_GRAIN elements per thread. A table
+ * of speedups over the first thread count is printed at the end.
+ *
+ * By default every operation is issued through an Eecs281PQ & (virtual
+ * dispatch). With --dispatch static the same loops are instantiated on the
+ * concrete queue type instead, so calls bind statically and the comparator
+ * can be inlined; --dispatch both reports the two side by side.
+ *
+ * Each (queue, workload) pair runs twice on an identical trace: once
+ * untimed per operation to measure throughput, then once with a clock read
+ * around every operation to collect latencies. Unless --no-fork is given,
+ * every pair runs in its own child process so that the reported peak RSS
+ * belongs to that pair alone. The checksum column folds in every value
+ * returned by top(); it must be identical for all queues on a workload.
+ * The allocs/op column counts calls to operator new during the untimed
+ * pass, divided by the number of operations.
+ * When more than one queue is run, a summary of the fastest queue for
+ * every workload and payload is printed at the end.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BinaryPQ.h"
+#include "BucketPQ.h"
+#include "CompactPairingPQ.h"
+#include "IndexedBinaryPQ.h"
+#include "DaryPQ.h"
+#include "Eecs281PQ.h"
+#include "FibonacciPQ.h"
+#include "PairingPQ.h"
+#include "ParallelRebuild.h"
+#include "PQKey.h"
+#include "RadixPQ.h"
+#include "RankPairingPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "UnorderedPQ.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+
+// The workload loops must not be inlined into the code that created the
+// queue, or the compiler would see the dynamic type and devirtualize the
+// "virtual" runs on its own.
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+
+// Every operator new in the process is counted, so that the driver can
+// report how often a queue goes to the system allocator. The deletes are
+// kept out of line, or GCC would see free() paired with new and complain.
+std::atomic<uint64_t> allocationCount{ 0 };
+
+void *operator new(std::size_t bytes) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(bytes == 0 ? 1 : bytes))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t bytes, std::align_val_t align) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t alignment = static_cast<std::size_t>(align);
+    std::size_t rounded = (std::max<std::size_t>(bytes, 1) + alignment - 1) / alignment * alignment;
+    if (void *ptr = std::aligned_alloc(alignment, rounded))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+BENCH_NOINLINE void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+BENCH_NOINLINE void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+BENCH_NOINLINE void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+BENCH_NOINLINE void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+
+enum class Workload {
+    PushHeavy,
+    PopHeavy,
+    Hold,
+    Dijkstra,
+    Range,
+    Update,
+    Rebuild,
+    Bounded,
+    Dense,
+    Merge,
+};
+
+std::ostream& operator<<(std::ostream& ost, Workload workload) {
+    switch (workload) {
+    case Workload::PushHeavy:
+        return ost << "push";
+    case Workload::PopHeavy:
+        return ost << "pop";
+    case Workload::Hold:
+        return ost << "hold";
+    case Workload::Dijkstra:
+        return ost << "dijkstra";
+    case Workload::Range:
+        return ost << "range";
+    case Workload::Update:
+        return ost << "update";
+    case Workload::Rebuild:
+        return ost << "rebuild";
+    case Workload::Bounded:
+        return ost << "bounded";
+    case Workload::Dense:
+        return ost << "dense";
+    case Workload::Merge:
+        return ost << "merge";
+    }
+
+    return ost << "unknown";
+}
+
+
+// How the workload loops call into the queue.
+enum class Dispatch {
+    Virtual,
+    Static,
+};
+
+std::ostream& operator<<(std::ostream& ost, Dispatch dispatch) {
+    return ost << (dispatch == Dispatch::Static ? "static" : "virtual");
+}
+
+
+// Element types the simple workloads can run on.
+enum class Payload {
+    Int,
+    String,
+    Large,
+};
+
+std::ostream& operator<<(std::ostream& ost, Payload payload) {
+    switch (payload) {
+    case Payload::Int:
+        return ost << "int";
+    case Payload::String:
+        return ost << "string";
+    case Payload::Large:
+        return ost << "large";
+    }
+
+    return ost << "unknown";
+}
+
+
+// A trivially copyable element that is expensive to move around.
+struct LargePayload {
+    int key;
+    int filler[15];
+};
+
+bool operator<(const LargePayload &a, const LargePayload &b) {
+    return a.key < b.key;
+}
+
+
+// Turns an int key into a payload value and back. Every payload orders
+// the same way its key does.
+template <typename T>
+struct PayloadTraits;
+
+template <>
+struct PayloadTraits<int> {
+    static int make(int key) {
+        return key;
+    }
+
+    static int key(const int &value) {
+        return value;
+    }
+};
+
+// Zero padded decimal key followed by filler: 32 characters is too long for
+// the small string optimization, so every copy allocates.
+template <>
+struct PayloadTraits<std::string> {
+    static std::string make(int key) {
+        std::string value(32, 'x');
+        for (size_t i = 10; i > 0; --i) {
+            value[i - 1] = static_cast<char>('0' + key % 10);
+            key /= 10;
+        }
+        return value;
+    }
+
+    static int key(const std::string &value) {
+        int key = 0;
+        for (size_t i = 0; i < 10; ++i)
+            key = key * 10 + (value[i] - '0');
+        return key;
+    }
+};
+
+template <>
+struct PayloadTraits<LargePayload> {
+    static LargePayload make(int key) {
+        LargePayload value{};
+        value.key = key;
+        for (int &f : value.filler)
+            f = key;
+        return value;
+    }
+
+    static int key(const LargePayload &value) {
+        return value.key;
+    }
+};
+
+
+// Command line settings shared by every benchmark.
+struct Options {
+    size_t size = 20000;
+    uint32_t seed = 281;
+    unsigned reps = 5;
+    bool fork = true;
+    std::vector<size_t> threadCounts;
+    size_t threads = 1;               // of the current run
+    std::vector<std::string> impls;
+    std::vector<Workload> workloads;
+    std::vector<Dispatch> dispatches;
+    std::vector<Payload> payloads;
+};
+
+
+// What a single (queue, workload) run measured.
+struct Measurement {
+    size_t ops = 0;
+    double seconds = 0.0;
+    std::vector<uint64_t> latencies;  // nanoseconds, one sample per op
+    uint64_t checksum = 0;
+    uint64_t allocations = 0;         // operator new calls, untimed pass
+};
+
+
+// One step of a push/pop trace. Pops carry no value.
+template <typename T>
+struct Op {
+    bool push;
+    T value;
+};
+
+
+// Element used by the Dijkstra workload: tentative distance to a vertex.
+struct DistEntry {
+    uint64_t dist;
+    uint32_t vertex;
+};
+
+// Orders DistEntry so the smallest distance is the most extreme.
+struct DistEntryComp {
+    bool operator()(const DistEntry &a, const DistEntry &b) const {
+        if (a.dist != b.dist)
+            return a.dist > b.dist;
+        return a.vertex > b.vertex;
+    }
+};
+
+
+// RadixPQ orders DistEntry by distance alone. Entries at equal distances
+// may come out in another order than DistEntryComp's, which the workload's
+// checksum (the sum of the distances) does not depend on.
+template <>
+struct PQKey<DistEntry, DistEntryComp> {
+    using key_type = uint64_t;
+
+    static key_type key(const DistEntry &entry) {
+        return entry.dist;
+    }
+};
+
+
+// Element used by the update workload: the id of an entry in an external
+// key array, the way testPQ's IntPtrComp orders pointers by what they point
+// to. Changing a key silently breaks the queue until it is repaired.
+struct KeyRef {
+    uint32_t id;
+};
+
+// Orders KeyRefs by id, not by key, so notifyChanged() can find them.
+bool operator<(const KeyRef &a, const KeyRef &b) {
+    return a.id < b.id;
+}
+
+struct KeyRefComp {
+    const std::vector<int> *keys = nullptr;
+
+    bool operator()(const KeyRef &a, const KeyRef &b) const {
+        return (*keys)[a.id] < (*keys)[b.id];
+    }
+};
+
+// One step of the update workload.
+struct UpdateStep {
+    uint32_t ids[4];
+    int keys[4];
+    int holdKey;
+};
+
+// Queues whose updateElt(handle, value) accepts a change in either
+// direction, so the update workload can repair them one element at a time.
+template <typename PQ>
+struct TwoWayHandles : std::false_type {};
+
+template <typename TYPE, typename COMP>
+struct TwoWayHandles<IndexedBinaryPQ<TYPE, COMP>> : std::true_type {};
+
+template <typename TYPE, typename COMP, typename ALLOCATOR>
+struct TwoWayHandles<PairingPQ<TYPE, COMP, ALLOCATOR>> : std::true_type {};
+
+template <typename TYPE, typename COMP, typename ALLOCATOR>
+struct TwoWayHandles<FibonacciPQ<TYPE, COMP, ALLOCATOR>> : std::true_type {};
+
+template <typename TYPE, typename COMP, typename ALLOCATOR>
+struct TwoWayHandles<RankPairingPQ<TYPE, COMP, ALLOCATOR>> : std::true_type {};
+
+
+struct Edge {
+    uint32_t to;
+    uint32_t weight;
+};
+
+using Graph = std::vector<std::vector<Edge>>;
+
+
+// Reads the clock only when timing is requested, so that the same replay
+// loop serves both the throughput and the latency pass.
+class OpTimer {
+public:
+    OpTimer(bool enabled, std::vector<uint64_t> &samples) :
+        enabled{ enabled }, samples{ samples } {
+    } // OpTimer()
+
+    void start() {
+        if (enabled)
+            begin = Clock::now();
+    } // start()
+
+    void stop() {
+        if (enabled) {
+            auto elapsed = Clock::now() - begin;
+            samples.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    } // stop()
+
+private:
+    bool enabled;
+    std::vector<uint64_t> &samples;
+    Clock::time_point begin;
+}; // OpTimer
+
+
+// Number of shards the merge workload consolidates.
+const size_t MERGE_SHARDS = 10;
+
+
+// Number of distinct priorities in the bounded workload.
+const int BOUNDED_KEYS = 4096;
+
+
+// Builds the push/pop trace for the simple workloads. The trace tracks the
+// queue size itself, so no pop is ever issued against an empty queue.
+template <typename T>
+std::vector<Op<T>> makeTrace(Workload workload, size_t n, size_t initial, std::mt19937 &rng) {
+    std::uniform_int_distribution<int> value(0, workload == Workload::Bounded ? BOUNDED_KEYS - 1 : (1 << 30) - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    int pushPercent = 10;
+    if (workload == Workload::PushHeavy)
+        pushPercent = 90;
+    else if (workload == Workload::Bounded)
+        pushPercent = 50;
+
+    std::vector<Op<T>> trace;
+    trace.reserve(n);
+    size_t size = initial;
+    for (size_t i = 0; i < n; ++i) {
+        bool push = size == 0 || percent(rng) < pushPercent;
+        trace.push_back(Op<T>{ push, PayloadTraits<T>::make(push ? value(rng) : 0) });
+        size = push ? size + 1 : size - 1;
+    }
+    return trace;
+} // makeTrace()
+
+
+// Random graph with 'vertices' vertices, 'degree' random out-edges each and
+// a ring so that every vertex is reachable from vertex 0.
+Graph makeGraph(size_t vertices, size_t degree, std::mt19937 &rng) {
+    std::uniform_int_distribution<uint32_t> target(0, static_cast<uint32_t>(vertices - 1));
+    std::uniform_int_distribution<uint32_t> weight(1, 1000);
+
+    Graph graph(vertices);
+    for (size_t v = 0; v < vertices; ++v) {
+        graph[v].push_back(Edge{ static_cast<uint32_t>((v + 1) % vertices), weight(rng) });
+        for (size_t e = 1; e < degree; ++e)
+            graph[v].push_back(Edge{ target(rng), weight(rng) });
+    }
+    return graph;
+} // makeGraph()
+
+
+// Replays a push/pop trace, moving the pushed values out of the trace.
+template <typename PQ>
+BENCH_NOINLINE uint64_t replay(PQ &pq, std::vector<Op<typename PQ::value_type>> &trace, OpTimer &timer) {
+    using Traits = PayloadTraits<typename PQ::value_type>;
+    uint64_t checksum = 0;
+    for (auto &op : trace) {
+        timer.start();
+        if (op.push) {
+            pq.push(std::move(op.value));
+            timer.stop();
+        }
+        else {
+            auto value = pq.pop_top();
+            timer.stop();
+            checksum += static_cast<uint64_t>(Traits::key(value));
+        }
+    }
+    return checksum;
+} // replay()
+
+
+// Hold model: each step pops the most extreme element and pushes it back
+// with a random lower priority (wrapping around at 2^30), keeping the queue
+// at a steady size.
+template <typename PQ>
+BENCH_NOINLINE uint64_t hold(PQ &pq, const std::vector<int> &offsets, OpTimer &timer) {
+    using Traits = PayloadTraits<typename PQ::value_type>;
+    uint64_t checksum = 0;
+    for (int offset : offsets) {
+        timer.start();
+        auto value = pq.pop_top();
+        timer.stop();
+
+        int key = Traits::key(value);
+        checksum += static_cast<uint64_t>(key);
+        auto next = Traits::make((key - offset) & ((1 << 30) - 1));
+
+        timer.start();
+        pq.push(std::move(next));
+        timer.stop();
+    }
+    return checksum;
+} // hold()
+
+
+// Dijkstra with lazy deletion: an improved distance is pushed again and
+// stale entries are skipped when they surface.
+template <typename PQ>
+BENCH_NOINLINE uint64_t dijkstra(PQ &pq, const Graph &graph, OpTimer &timer, size_t &ops) {
+    const uint64_t infinity = UINT64_MAX;
+    std::vector<uint64_t> dist(graph.size(), infinity);
+    std::vector<bool> done(graph.size(), false);
+
+    dist[0] = 0;
+    timer.start();
+    pq.push(DistEntry{ 0, 0 });
+    timer.stop();
+    ++ops;
+
+    while (!pq.empty()) {
+        timer.start();
+        DistEntry entry = pq.pop_top();
+        timer.stop();
+        ++ops;
+
+        if (done[entry.vertex])
+            continue;
+        done[entry.vertex] = true;
+
+        for (const Edge &edge : graph[entry.vertex]) {
+            uint64_t candidate = entry.dist + edge.weight;
+            if (candidate < dist[edge.to]) {
+                dist[edge.to] = candidate;
+                timer.start();
+                pq.push(DistEntry{ candidate, edge.to });
+                timer.stop();
+                ++ops;
+            }
+        }
+    }
+
+    uint64_t checksum = 0;
+    for (uint64_t d : dist)
+        checksum += d;
+    return checksum;
+} // dijkstra()
+
+
+
+// Sparse updates. q is the queue as seen through the requested dispatch;
+// pq is the same queue with its concrete type, for the handle calls.
+template <typename PQ, typename Q, typename Handles>
+BENCH_NOINLINE uint64_t sparseUpdate(PQ &pq, Q &q, std::vector<int> &keys, Handles &handles,
+                                     const std::vector<UpdateStep> &steps, OpTimer &timer) {
+    uint64_t checksum = 0;
+    std::vector<KeyRef> changed(4);
+    for (const UpdateStep &step : steps) {
+        timer.start();
+        for (size_t k = 0; k < 4; ++k) {
+            keys[step.ids[k]] = step.keys[k];
+            if constexpr (TwoWayHandles<PQ>::value)
+                pq.updateElt(handles[step.ids[k]], KeyRef{ step.ids[k] });
+            else
+                changed[k] = KeyRef{ step.ids[k] };
+        }
+        if constexpr (!TwoWayHandles<PQ>::value)
+            q.notifyChanged(changed);
+
+        KeyRef top = q.pop_top();
+        checksum += static_cast<uint64_t>(keys[top.id]);
+        keys[top.id] = step.holdKey;
+        if constexpr (TwoWayHandles<PQ>::value)
+            handles[top.id] = pq.addNode(top);
+        else
+            q.push(top);
+        timer.stop();
+    }
+    return checksum;
+} // sparseUpdate()
+
+
+// Queues that can take over all elements of another with merge(PQ &&).
+template <typename PQ, typename = void>
+struct HasMerge : std::false_type {};
+
+template <typename PQ>
+struct HasMerge<PQ, std::void_t<decltype(std::declval<PQ &>().merge(std::declval<PQ &&>()))>> : std::true_type {};
+
+
+// Moves every element of from into pq, with merge() where the queue has
+// it. q is pq as seen through the requested dispatch.
+template <typename PQ, typename Q>
+BENCH_NOINLINE void consolidate(PQ &pq, Q &q, PQ &from) {
+    if constexpr (HasMerge<PQ>::value) {
+        pq.merge(std::move(from));
+    }
+    else {
+        Q &source = from;
+        while (!source.empty())
+            q.push(source.pop_top());
+    }
+} // consolidate()
+
+
+// One full rebuild, kept out of line like the other workload loops.
+template <typename Q>
+BENCH_NOINLINE void rebuild(Q &q) {
+    q.updatePriorities();
+} // rebuild()
+
+
+// Handle type of a queue in the update workload (int for queues without
+// two-way handles, which never use it).
+template <typename PQ, typename = void>
+struct UpdateHandle {
+    using type = int;
+};
+
+template <typename PQ>
+struct UpdateHandle<PQ, std::enable_if_t<TwoWayHandles<PQ>::value>> {
+    using type = decltype(std::declval<PQ &>().addNode(std::declval<const typename PQ::value_type &>()));
+};
+
+
+// Dijkstra with decrease-key: every vertex enters the queue once, through
+// addNode(), and an improved distance updates its entry in place. q is the
+// queue as seen through the requested dispatch; pq is the same queue with
+// its concrete type, for the handle calls.
+template <typename PQ, typename Q>
+BENCH_NOINLINE uint64_t dijkstraDecrease(PQ &pq, Q &q, const Graph &graph, OpTimer &timer, size_t &ops) {
+    const uint64_t infinity = UINT64_MAX;
+    std::vector<uint64_t> dist(graph.size(), infinity);
+    std::vector<typename UpdateHandle<PQ>::type> handles(graph.size());
+
+    dist[0] = 0;
+    timer.start();
+    handles[0] = pq.addNode(DistEntry{ 0, 0 });
+    timer.stop();
+    ++ops;
+
+    while (!q.empty()) {
+        timer.start();
+        DistEntry entry = q.pop_top();
+        timer.stop();
+        ++ops;
+
+        for (const Edge &edge : graph[entry.vertex]) {
+            uint64_t candidate = entry.dist + edge.weight;
+            if (candidate < dist[edge.to]) {
+                // A vertex that was popped has its final distance, so one
+                // with a finite distance is still in the queue.
+                timer.start();
+                if (dist[edge.to] == infinity)
+                    handles[edge.to] = pq.addNode(DistEntry{ candidate, edge.to });
+                else
+                    pq.updateElt(handles[edge.to], DistEntry{ candidate, edge.to });
+                timer.stop();
+                dist[edge.to] = candidate;
+                ++ops;
+            }
+        }
+    }
+
+    uint64_t checksum = 0;
+    for (uint64_t d : dist)
+        checksum += d;
+    return checksum;
+} // dijkstraDecrease()
+
+
+// Calls fn with either the concrete queue or its Eecs281PQ base, so that
+// the workload loops are instantiated for static or virtual dispatch.
+template <typename PQ, typename Fn>
+auto dispatchOn(Dispatch dispatch, PQ &pq, Fn fn) {
+    static_assert(IsStaticPQ<PQ>::value, "benchmarked queues must support static dispatch");
+    using BaseClass = Eecs281PQ<typename PQ::value_type, typename PQ::value_compare>;
+    if (dispatch == Dispatch::Static)
+        return fn(pq);
+    return fn(static_cast<BaseClass &>(pq));
+} // dispatchOn()
+
+
+// Runs the dijkstra or dense workload on one queue type, twice: once for
+// throughput and once for per-operation latency.
+template <template <typename...> typename PQ>
+Measurement measureDijkstra(Workload workload, Dispatch dispatch, const Options &opt) {
+    using Queue = PQ<DistEntry, DistEntryComp>;
+    std::mt19937 rng{ opt.seed };
+    Measurement result;
+    const bool dense = workload == Workload::Dense;
+    size_t vertices = std::max<size_t>(opt.size / 8, 2);
+    size_t degree = 8;
+    if (dense) {
+        vertices = std::max<size_t>(static_cast<size_t>(2 * std::sqrt(static_cast<double>(opt.size))), 4);
+        degree = vertices / 4;
+    }
+    Graph graph = makeGraph(vertices, degree, rng);
+    for (bool timed : { false, true }) {
+        Queue pq;
+        size_t ops = 0;
+        OpTimer timer{ timed, result.latencies };
+        uint64_t allocations = allocationCount.load();
+        auto begin = Clock::now();
+        result.checksum = dispatchOn(dispatch, pq, [&](auto &q) {
+            if constexpr (TwoWayHandles<Queue>::value) {
+                if (dense)
+                    return dijkstraDecrease(pq, q, graph, timer, ops);
+            }
+            return dijkstra(q, graph, timer, ops);
+        });
+        if (!timed) {
+            result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            result.allocations = allocationCount.load() - allocations;
+            // Every edge is relaxed once, whatever the queue.
+            result.ops = dense ? vertices * degree : ops;
+            result.latencies.reserve(ops);
+        }
+    }
+    return result;
+} // measureDijkstra()
+
+
+// Runs the bounded workload on the queues makeQueue() returns, twice: once
+// for throughput and once for per-operation latency.
+template <typename T, typename MakeQueue>
+Measurement measureBounded(Dispatch dispatch, const Options &opt, MakeQueue makeQueue) {
+    std::mt19937 rng{ opt.seed };
+    Measurement result;
+    std::uniform_int_distribution<int> value(0, BOUNDED_KEYS - 1);
+    std::vector<T> initial;
+    initial.reserve(opt.size);
+    for (size_t i = 0; i < opt.size; ++i)
+        initial.push_back(PayloadTraits<T>::make(value(rng)));
+    std::vector<Op<T>> trace = makeTrace<T>(Workload::Bounded, opt.size, initial.size(), rng);
+    result.ops = trace.size();
+    result.latencies.reserve(result.ops);
+
+    for (bool timed : { false, true }) {
+        auto pq = makeQueue();
+        for (const T &v : initial)
+            pq.push(v);
+        std::vector<Op<T>> work = trace;
+
+        OpTimer timer{ timed, result.latencies };
+        uint64_t allocations = allocationCount.load();
+        auto begin = Clock::now();
+        result.checksum = dispatchOn(dispatch, pq, [&](auto &q) {
+            return replay(q, work, timer);
+        });
+        if (!timed) {
+            result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            result.allocations = allocationCount.load() - allocations;
+        }
+    }
+    return result;
+} // measureBounded()
+
+
+// Runs one workload on one queue type, twice: once for throughput and once
+// for per-operation latency.
+template <template <typename...> typename PQ, typename T>
+Measurement measure(Workload workload, Dispatch dispatch, const Options &opt) {
+    using Traits = PayloadTraits<T>;
+    std::mt19937 rng{ opt.seed };
+    Measurement result;
+    setRebuildThreads(opt.threads);
+
+    if (workload == Workload::Dijkstra || workload == Workload::Dense)
+        return measureDijkstra<PQ>(workload, dispatch, opt);
+    if (workload == Workload::Bounded)
+        return measureBounded<T>(dispatch, opt, [] { return PQ<T>{}; });
+
+    if (workload == Workload::Update) {
+        std::uniform_int_distribution<int> key(0, (1 << 30) - 1);
+        std::uniform_int_distribution<uint32_t> id(0, static_cast<uint32_t>(std::max<size_t>(opt.size, 1) - 1));
+        std::vector<int> initialKeys(std::max<size_t>(opt.size, 1));
+        for (int &k : initialKeys)
+            k = key(rng);
+        std::vector<UpdateStep> steps(std::min<size_t>(opt.size, 2000));
+        for (UpdateStep &step : steps) {
+            for (size_t k = 0; k < 4; ++k) {
+                step.ids[k] = id(rng);
+                step.keys[k] = key(rng);
+            }
+            step.holdKey = key(rng);
+        }
+        result.ops = steps.size();
+        result.latencies.reserve(result.ops);
+
+        for (bool timed : { false, true }) {
+            std::vector<int> keys = initialKeys;
+            PQ<KeyRef, KeyRefComp> pq{ KeyRefComp{ &keys } };
+            std::vector<typename UpdateHandle<PQ<KeyRef, KeyRefComp>>::type> handles;
+            for (uint32_t i = 0; i < keys.size(); ++i) {
+                if constexpr (TwoWayHandles<PQ<KeyRef, KeyRefComp>>::value)
+                    handles.push_back(pq.addNode(KeyRef{ i }));
+                else
+                    pq.push(KeyRef{ i });
+            }
+
+            OpTimer timer{ timed, result.latencies };
+            uint64_t allocations = allocationCount.load();
+            auto begin = Clock::now();
+            result.checksum = dispatchOn(dispatch, pq, [&](auto &q) {
+                return sparseUpdate(pq, q, keys, handles, steps, timer);
+            });
+            if (!timed) {
+                result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+                result.allocations = allocationCount.load() - allocations;
+            }
+        }
+        return result;
+    }
+
+    if (workload == Workload::Rebuild) {
+        // One latency sample per rebuild, amortized over the elements.
+        std::uniform_int_distribution<int> key(0, (1 << 30) - 1);
+        std::vector<int> keys(std::max<size_t>(opt.size, 1));
+        std::vector<KeyRef> ids;
+        for (uint32_t i = 0; i < keys.size(); ++i) {
+            keys[i] = key(rng);
+            ids.push_back(KeyRef{ i });
+        }
+        PQ<KeyRef, KeyRefComp> pq{ ids.begin(), ids.end(), KeyRefComp{ &keys } };
+
+        result.latencies.reserve(opt.reps);
+        for (unsigned rep = 0; rep < opt.reps; ++rep) {
+            for (int &k : keys)
+                k = key(rng);
+            uint64_t allocations = allocationCount.load();
+            auto start = Clock::now();
+            dispatchOn(dispatch, pq, [](auto &q) {
+                rebuild(q);
+                return 0;
+            });
+            auto elapsed = Clock::now() - start;
+            result.allocations += allocationCount.load() - allocations;
+            result.seconds += std::chrono::duration<double>(elapsed).count();
+            auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            result.latencies.push_back(static_cast<uint64_t>(nanos) / keys.size());
+            result.checksum += static_cast<uint64_t>(keys[pq.top().id]);
+        }
+        result.ops = keys.size() * opt.reps;
+        return result;
+    }
+
+    std::uniform_int_distribution<int> value(0, (1 << 30) - 1);
+    std::vector<T> initial;
+    if (workload != Workload::PushHeavy) {
+        initial.reserve(opt.size);
+        for (size_t i = 0; i < opt.size; ++i)
+            initial.push_back(Traits::make(value(rng)));
+    }
+
+    if (workload == Workload::Merge) {
+        // One latency sample per shard merged, amortized over its elements.
+        result.latencies.reserve(opt.reps * (MERGE_SHARDS - 1));
+        for (unsigned rep = 0; rep < opt.reps; ++rep) {
+            // Shards are built from ranges: pushes would be quadratic for
+            // SortedPQ.
+            std::vector<std::unique_ptr<PQ<T>>> shards;
+            for (size_t s = 0; s < MERGE_SHARDS; ++s) {
+                auto begin = initial.begin() + static_cast<std::ptrdiff_t>(initial.size() * s / MERGE_SHARDS);
+                auto end = initial.begin() + static_cast<std::ptrdiff_t>(initial.size() * (s + 1) / MERGE_SHARDS);
+                shards.push_back(std::make_unique<PQ<T>>(begin, end));
+            }
+
+            PQ<T> &pq = *shards[0];
+            uint64_t allocations = allocationCount.load();
+            for (size_t s = 1; s < MERGE_SHARDS; ++s) {
+                const size_t moved = shards[s]->size();
+                auto start = Clock::now();
+                dispatchOn(dispatch, pq, [&](auto &q) {
+                    consolidate(pq, q, *shards[s]);
+                    return 0;
+                });
+                auto elapsed = Clock::now() - start;
+                auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+                result.seconds += std::chrono::duration<double>(elapsed).count();
+                result.latencies.push_back(static_cast<uint64_t>(nanos) / std::max<size_t>(moved, 1));
+                result.ops += moved;
+            }
+            result.allocations += allocationCount.load() - allocations;
+            result.checksum += pq.size() + static_cast<uint64_t>(Traits::key(pq.top()));
+        }
+        return result;
+    }
+
+    if (workload == Workload::Range) {
+        // One latency sample per construction, amortized over the elements.
+        result.latencies.reserve(opt.reps);
+        uint64_t allocations = allocationCount.load();
+        auto begin = Clock::now();
+        for (unsigned rep = 0; rep < opt.reps; ++rep) {
+            auto start = Clock::now();
+            PQ<T> pq{ initial.begin(), initial.end() };
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+            result.latencies.push_back(static_cast<uint64_t>(elapsed.count()) / std::max<size_t>(initial.size(), 1));
+            result.checksum += static_cast<uint64_t>(Traits::key(pq.top()));
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        result.allocations = allocationCount.load() - allocations;
+        result.ops = initial.size() * opt.reps;
+        return result;
+    }
+
+    std::vector<Op<T>> trace;
+    std::vector<int> offsets;
+    if (workload == Workload::Hold) {
+        std::uniform_int_distribution<int> offset(1, 1 << 20);
+        offsets.resize(opt.size);
+        for (int &o : offsets)
+            o = offset(rng);
+        result.ops = 2 * offsets.size();
+    }
+    else {
+        trace = makeTrace<T>(workload, opt.size, initial.size(), rng);
+        result.ops = trace.size();
+    }
+    result.latencies.reserve(result.ops);
+
+    for (bool timed : { false, true }) {
+        PQ<T> pq;
+        for (const T &v : initial)
+            pq.push(v);
+        std::vector<Op<T>> work = trace;
+
+        OpTimer timer{ timed, result.latencies };
+        uint64_t allocations = allocationCount.load();
+        auto begin = Clock::now();
+        result.checksum = dispatchOn(dispatch, pq, [&](auto &q) {
+            if (workload == Workload::Hold)
+                return hold(q, offsets, timer);
+            return replay(q, work, timer);
+        });
+        if (!timed) {
+            result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            result.allocations = allocationCount.load() - allocations;
+        }
+    }
+    return result;
+} // measure()
+
+
+// Picks the measure() instantiation for the requested payload.
+template <template <typename...> typename PQ>
+Measurement measurePayload(Workload workload, Dispatch dispatch, Payload payload, const Options &opt) {
+    switch (payload) {
+    case Payload::String:
+        return measure<PQ, std::string>(workload, dispatch, opt);
+    case Payload::Large:
+        return measure<PQ, LargePayload>(workload, dispatch, opt);
+    case Payload::Int:
+        break;
+    }
+    return measure<PQ, int>(workload, dispatch, opt);
+} // measurePayload()
+
+
+// DaryPQ takes its arity as a third template argument; these aliases give
+// it the PQ<TYPE, COMP> shape that measure() expects.
+template <typename TYPE, typename COMP = std::less<TYPE>>
+using Dary4PQ = DaryPQ<TYPE, COMP, 4>;
+template <typename TYPE, typename COMP = std::less<TYPE>>
+using Dary8PQ = DaryPQ<TYPE, COMP, 8>;
+// BinaryPQ in the B-heap layout, for heaps larger than the caches.
+template <typename TYPE, typename COMP = std::less<TYPE>>
+using BHeapPQ = BinaryPQ<TYPE, COMP, HeapLayout::BHeap>;
+// PairingPQ with plain operator new/delete per node, to measure the pool.
+template <typename TYPE, typename COMP = std::less<TYPE>>
+using PairingMallocPQ = PairingPQ<TYPE, COMP, std::allocator<TYPE>>;
+
+
+// A queue implementation the driver knows how to run.
+struct Impl {
+    const char *name;
+    Measurement (*run)(Workload, Dispatch, Payload, const Options &);
+    // The only workload a specialized queue can run, if any.
+    std::optional<Workload> only = std::nullopt;
+};
+
+
+Measurement measureRadix(Workload, Dispatch dispatch, Payload, const Options &opt) {
+    return measureDijkstra<RadixPQ>(Workload::Dijkstra, dispatch, opt);
+} // measureRadix()
+
+
+// BucketPQ needs the range of priorities, and gets them from the payload.
+struct PayloadPriority {
+    template <typename T>
+    int operator()(const T &value) const {
+        return PayloadTraits<T>::key(value);
+    }
+};
+
+template <typename T>
+using BoundedBucketPQ = BucketPQ<T, std::less<T>, PayloadPriority>;
+
+Measurement measureBucket(Workload, Dispatch dispatch, Payload payload, const Options &opt) {
+    switch (payload) {
+    case Payload::String:
+        return measureBounded<std::string>(dispatch, opt, [] { return BoundedBucketPQ<std::string>{ 0, BOUNDED_KEYS - 1 }; });
+    case Payload::Large:
+        return measureBounded<LargePayload>(dispatch, opt, [] { return BoundedBucketPQ<LargePayload>{ 0, BOUNDED_KEYS - 1 }; });
+    case Payload::Int:
+        break;
+    }
+    return measureBounded<int>(dispatch, opt, [] { return BoundedBucketPQ<int>{ 0, BOUNDED_KEYS - 1 }; });
+} // measureBucket()
+
+const std::vector<Impl> &implementations() {
+    static const std::vector<Impl> impls {
+        { "Unordered", measurePayload<UnorderedPQ> },
+        { "UnorderedFast", measurePayload<UnorderedFastPQ> },
+        { "Sorted", measurePayload<SortedPQ> },
+        { "Binary", measurePayload<BinaryPQ> },
+        { "BHeap", measurePayload<BHeapPQ> },
+        { "Pairing", measurePayload<PairingPQ> },
+        { "PairingMalloc", measurePayload<PairingMallocPQ> },
+        { "CompactPairing", measurePayload<CompactPairingPQ> },
+        { "IndexedBinary", measurePayload<IndexedBinaryPQ> },
+        { "Dary4", measurePayload<Dary4PQ> },
+        { "Dary8", measurePayload<Dary8PQ> },
+        { "Fibonacci", measurePayload<FibonacciPQ> },
+        { "RankPairing", measurePayload<RankPairingPQ> },
+        { "Radix", measureRadix, Workload::Dijkstra },
+        { "Bucket", measureBucket, Workload::Bounded },
+    };
+    return impls;
+} // implementations()
+
+
+uint64_t percentile(std::vector<uint64_t> &samples, double fraction) {
+    if (samples.empty())
+        return 0;
+    size_t k = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(k), samples.end());
+    return samples[k];
+} // percentile()
+
+
+long peakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+} // peakRssKb()
+
+
+void printHeader() {
+    std::cout << std::left << std::setw(16) << "impl" << std::setw(10) << "workload"
+              << std::setw(9) << "dispatch" << std::setw(8) << "payload" << std::setw(8) << "threads"
+              << std::right << std::setw(12) << "ops" << std::setw(14) << "ops/sec"
+              << std::setw(10) << "p50(ns)" << std::setw(10) << "p99(ns)"
+              << std::setw(11) << "allocs/op" << std::setw(12) << "rss(KB)" << std::setw(22) << "checksum" << std::endl;
+} // printHeader()
+
+
+// Runs and prints a single benchmark, returning its throughput.
+double runOne(const Impl &impl, Workload workload, Dispatch dispatch, Payload payload, const Options &opt) {
+    Measurement m = impl.run(workload, dispatch, payload, opt);
+    double throughput = m.seconds > 0 ? static_cast<double>(m.ops) / m.seconds : 0.0;
+    uint64_t p50 = percentile(m.latencies, 0.50);
+    uint64_t p99 = percentile(m.latencies, 0.99);
+    double allocsPerOp = m.ops > 0 ? static_cast<double>(m.allocations) / static_cast<double>(m.ops) : 0.0;
+
+    std::cout << std::left << std::setw(16) << impl.name << std::setw(10) << workload
+              << std::setw(9) << dispatch << std::setw(8);
+    if (workload == Workload::Dijkstra || workload == Workload::Dense)
+        std::cout << "dist";
+    else
+        std::cout << payload;
+    std::cout << std::setw(8) << opt.threads
+              << std::right << std::setw(12) << m.ops
+              << std::setw(14) << std::fixed << std::setprecision(0) << throughput
+              << std::setw(10) << p50 << std::setw(10) << p99
+              << std::setw(11) << std::setprecision(3) << allocsPerOp
+              << std::setw(12) << peakRssKb() << std::setw(22) << m.checksum << std::endl;
+    return throughput;
+} // runOne()
+
+
+// Runs a single benchmark in a child process so that its peak RSS is not
+// polluted by earlier benchmarks. The child reports its throughput back
+// through a pipe; 0 means the benchmark failed.
+double runIsolated(const Impl &impl, Workload workload, Dispatch dispatch, Payload payload,
+                   const Options &opt) {
+    int fds[2];
+    if (!opt.fork || pipe(fds) != 0)
+        return runOne(impl, workload, dispatch, payload, opt);
+
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "fork failed, running in-process" << std::endl;
+        close(fds[0]);
+        close(fds[1]);
+        return runOne(impl, workload, dispatch, payload, opt);
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        double throughput = runOne(impl, workload, dispatch, payload, opt);
+        std::cout.flush();
+        ssize_t written = write(fds[1], &throughput, sizeof(throughput));
+        _exit(written == static_cast<ssize_t>(sizeof(throughput)) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    double throughput = 0.0;
+    if (read(fds[0], &throughput, sizeof(throughput)) != static_cast<ssize_t>(sizeof(throughput)))
+        throughput = 0.0;
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << impl.name << " failed on " << workload << std::endl;
+        return 0.0;
+    }
+    return throughput;
+} // runIsolated()
+
+
+// The fastest queue seen so far for one workload/payload/dispatch.
+struct Winner {
+    Workload workload;
+    Payload payload;
+    Dispatch dispatch;
+    std::string impl;
+    double throughput;
+};
+
+
+void printWinners(const std::vector<Winner> &winners) {
+    std::cout << std::endl << "Fastest queue per workload and payload:" << std::endl;
+    for (const Winner &w : winners) {
+        std::cout << "  " << std::left << std::setw(10) << w.workload << std::setw(9) << w.dispatch
+                  << std::setw(8);
+        if (w.workload == Workload::Dijkstra || w.workload == Workload::Dense)
+            std::cout << "dist";
+        else
+            std::cout << w.payload;
+        std::cout << std::setw(16) << w.impl << std::right << std::fixed << std::setprecision(0)
+                  << w.throughput << " ops/sec" << std::endl;
+    }
+} // printWinners()
+
+
+// Throughput of one queue on one workload at every thread count.
+struct Scaling {
+    Workload workload;
+    Payload payload;
+    Dispatch dispatch;
+    std::string impl;
+    std::vector<double> throughputs;
+};
+
+
+void printScaling(const std::vector<Scaling> &rows, const std::vector<size_t> &threadCounts) {
+    std::cout << std::endl << "Speedup over " << threadCounts.front() << " thread(s):" << std::endl
+              << "  " << std::left << std::setw(10) << "workload" << std::setw(9) << "dispatch"
+              << std::setw(8) << "payload" << std::setw(16) << "impl" << std::right;
+    for (size_t threads : threadCounts)
+        std::cout << std::setw(9) << threads;
+    std::cout << std::endl;
+    for (const Scaling &row : rows) {
+        std::cout << "  " << std::left << std::setw(10) << row.workload << std::setw(9) << row.dispatch
+                  << std::setw(8) << row.payload << std::setw(16) << row.impl << std::right << std::fixed
+                  << std::setprecision(2);
+        for (double throughput : row.throughputs) {
+            double base = row.throughputs.front();
+            std::cout << std::setw(8) << (base > 0 ? throughput / base : 0.0) << 'x';
+        }
+        std::cout << std::endl;
+    }
+} // printScaling()
+
+
+std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::istringstream iss{ list };
+    std::string item;
+    while (std::getline(iss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+} // splitList()
+
+
+void printHelp(const char *argv0) {
+    std::cout << "Usage: " << argv0 << " [options]\n"
+              << "  -n, --size N          elements / operations per workload (default 20000)\n"
+              << "  -w, --workload LIST   comma separated: push,pop,hold,dijkstra,range,update,rebuild,\n"
+              << "                        bounded,dense,merge (default all)\n"
+              << "  -i, --impl LIST       comma separated queue names (default all)\n"
+              << "  -s, --seed N          random seed (default 281)\n"
+              << "  -r, --reps N          repetitions of the range and merge workloads (default 5)\n"
+              << "  -d, --dispatch MODE   virtual, static or both (default virtual)\n"
+              << "  -p, --payload LIST    comma separated: int,string,large (default int)\n"
+              << "  -t, --threads LIST    rebuild thread counts for range and rebuild (default 1,4,16,64)\n"
+              << "      --no-fork         run everything in this process\n"
+              << "  -h, --help            show this message\n"
+              << "Queues:";
+    for (const Impl &impl : implementations())
+        std::cout << ' ' << impl.name;
+    std::cout << std::endl;
+} // printHelp()
+
+
+Options parseOptions(int argc, char *argv[]) {
+    static const option longOpts[] = {
+        { "size", required_argument, nullptr, 'n' },
+        { "workload", required_argument, nullptr, 'w' },
+        { "impl", required_argument, nullptr, 'i' },
+        { "seed", required_argument, nullptr, 's' },
+        { "reps", required_argument, nullptr, 'r' },
+        { "dispatch", required_argument, nullptr, 'd' },
+        { "payload", required_argument, nullptr, 'p' },
+        { "threads", required_argument, nullptr, 't' },
+        { "no-fork", no_argument, nullptr, 'F' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, '\0' },
+    };
+
+    const std::vector<Workload> allWorkloads {
+        Workload::PushHeavy, Workload::PopHeavy, Workload::Hold,
+        Workload::Dijkstra, Workload::Dense, Workload::Range, Workload::Merge, Workload::Update,
+        Workload::Rebuild, Workload::Bounded,
+    };
+
+    Options opt;
+    int choice = 0;
+    while ((choice = getopt_long(argc, argv, "n:w:i:s:r:d:p:t:h", longOpts, nullptr)) != -1) {
+        switch (choice) {
+        case 'n':
+            opt.size = std::stoul(optarg);
+            break;
+        case 'w':
+            for (const std::string &name : splitList(optarg)) {
+                bool found = false;
+                for (Workload w : allWorkloads) {
+                    std::ostringstream oss;
+                    oss << w;
+                    if (oss.str() == name) {
+                        opt.workloads.push_back(w);
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    std::cerr << "Unknown workload " << name << std::endl;
+                    std::exit(1);
+                }
+            }
+            break;
+        case 'i':
+            opt.impls = splitList(optarg);
+            break;
+        case 's':
+            opt.seed = static_cast<uint32_t>(std::stoul(optarg));
+            break;
+        case 'r':
+            opt.reps = static_cast<unsigned>(std::stoul(optarg));
+            break;
+        case 'd':
+            if (std::string{ optarg } == "virtual") {
+                opt.dispatches = { Dispatch::Virtual };
+            }
+            else if (std::string{ optarg } == "static") {
+                opt.dispatches = { Dispatch::Static };
+            }
+            else if (std::string{ optarg } == "both") {
+                opt.dispatches = { Dispatch::Virtual, Dispatch::Static };
+            }
+            else {
+                std::cerr << "Unknown dispatch mode " << optarg << std::endl;
+                std::exit(1);
+            }
+            break;
+        case 'p':
+            for (const std::string &name : splitList(optarg)) {
+                if (name == "int") {
+                    opt.payloads.push_back(Payload::Int);
+                }
+                else if (name == "string") {
+                    opt.payloads.push_back(Payload::String);
+                }
+                else if (name == "large") {
+                    opt.payloads.push_back(Payload::Large);
+                }
+                else {
+                    std::cerr << "Unknown payload " << name << std::endl;
+                    std::exit(1);
+                }
+            }
+            break;
+        case 't':
+            for (const std::string &count : splitList(optarg))
+                opt.threadCounts.push_back(std::max<size_t>(std::stoul(count), 1));
+            break;
+        case 'F':
+            opt.fork = false;
+            break;
+        case 'h':
+            printHelp(argv[0]);
+            std::exit(0);
+        default:
+            printHelp(argv[0]);
+            std::exit(1);
+        }
+    }
+
+    if (opt.workloads.empty())
+        opt.workloads = allWorkloads;
+    if (opt.dispatches.empty())
+        opt.dispatches = { Dispatch::Virtual };
+    if (opt.payloads.empty())
+        opt.payloads = { Payload::Int };
+    if (opt.threadCounts.empty())
+        opt.threadCounts = { 1, 4, 16, 64 };
+    if (opt.impls.empty())
+        for (const Impl &impl : implementations())
+            opt.impls.push_back(impl.name);
+    return opt;
+} // parseOptions()
+
+
+int main(int argc, char *argv[]) {
+    std::ios_base::sync_with_stdio(false);
+    Options opt = parseOptions(argc, argv);
+
+    std::cout << "PQ benchmark, n = " << opt.size << ", seed = " << opt.seed << std::endl;
+    printHeader();
+    std::vector<Winner> winners;
+    std::vector<Scaling> scaling;
+    for (Workload workload : opt.workloads) {
+        // Only the workloads that rebuild whole queues depend on threads.
+        const bool parallel = workload == Workload::Range || workload == Workload::Rebuild;
+        std::vector<size_t> threadCounts = opt.threadCounts;
+        if (!parallel)
+            threadCounts.resize(1);
+        for (const std::string &name : opt.impls) {
+            auto it = std::find_if(implementations().begin(), implementations().end(),
+                                   [&name](const Impl &impl) { return name == impl.name; });
+            if (it == implementations().end()) {
+                std::cerr << "Unknown queue " << name << std::endl;
+                return 1;
+            }
+            if (it->only && workload != *it->only)
+                continue;
+            for (Payload payload : opt.payloads) {
+                // The dijkstra and dense workloads have their own element type.
+                if ((workload == Workload::Dijkstra || workload == Workload::Dense)
+                    && payload != opt.payloads.front())
+                    continue;
+                for (Dispatch dispatch : opt.dispatches) {
+                    Scaling row{ workload, payload, dispatch, it->name, {} };
+                    double throughput = 0.0;
+                    for (size_t threads : threadCounts) {
+                        Options run = opt;
+                        run.threads = threads;
+                        row.throughputs.push_back(runIsolated(*it, workload, dispatch, payload, run));
+                        throughput = std::max(throughput, row.throughputs.back());
+                    }
+                    if (parallel && threadCounts.size() > 1)
+                        scaling.push_back(row);
+                    auto best = std::find_if(winners.begin(), winners.end(), [&](const Winner &w) {
+                        return w.workload == workload && w.payload == payload && w.dispatch == dispatch;
+                    });
+                    if (best == winners.end())
+                        winners.push_back(Winner{ workload, payload, dispatch, it->name, throughput });
+                    else if (throughput > best->throughput)
+                        *best = Winner{ workload, payload, dispatch, it->name, throughput };
+                }
+            }
+        }
+    }
+
+    if (opt.impls.size() > 1)
+        printWinners(winners);
+    if (!scaling.empty())
+        printScaling(scaling, opt.threadCounts);
+
+    return 0;
+}
@@ -0,0 +1,425 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+/*
+ * Parallel single-source shortest paths, to measure what the approximate
+ * order of WorkStealingScheduler costs. Every run solves the same problem
+ * from vertex 0 and checks its distances against a sequential Dijkstra.
+ *
+ * Build with 'make benchSSSP' (always an optimized build), then for
+ * example:
+ *
+ *     ./benchSSSP                          both graphs, 1,2,4,8 threads
+ *     ./benchSSSP -n 1000000 -g grid -t 1,16
+ *     ./benchSSSP --help
+ *
+ * Graphs:
+ *   random    n vertices with d random out-edges each, plus a ring so that
+ *             every vertex is reachable; weights 1..1000
+ *   grid      a square grid with edges to the four neighbours; weights
+ *             1..1000. Its frontier is narrow, so little work is parallel
+ *
+ * Schedulers:
+ *   Global       one BinaryPQ behind a mutex, shared by all threads: the
+ *                strict order, and the shared hot spot
+ *   StealOne     WorkStealingScheduler, stealing the victim's top task
+ *   StealHalf    WorkStealingScheduler, stealing the better half
+ *
+ * Every scheduler runs the same label-correcting loop: a task is a
+ * (distance, vertex) pair; it is stale, and skipped, if the vertex has a
+ * shorter distance by now; otherwise the vertex is expanded and every
+ * neighbour whose distance it lowers is pushed. Sequential Dijkstra
+ * expands each reachable vertex exactly once. Any expansion beyond that
+ * was done with a distance that later turned out too long: wasted work,
+ * reported relative to the number of vertices.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "ParallelRebuild.h"
+#include "WorkStealingScheduler.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+
+struct Edge {
+    uint32_t to;
+    uint32_t weight;
+};
+
+using Graph = std::vector<std::vector<Edge>>;
+
+
+// Tentative distance to a vertex.
+struct DistEntry {
+    uint64_t dist;
+    uint32_t vertex;
+};
+
+// Orders DistEntry so the smallest distance is the most extreme.
+struct DistEntryComp {
+    bool operator()(const DistEntry &a, const DistEntry &b) const {
+        if (a.dist != b.dist)
+            return a.dist > b.dist;
+        return a.vertex > b.vertex;
+    }
+};
+
+
+struct Options {
+    size_t vertices = 200000;
+    size_t degree = 8;
+    uint32_t seed = 281;
+    std::vector<std::string> graphs;
+    std::vector<std::string> schedulers;
+    std::vector<size_t> threadCounts;
+};
+
+
+// Random graph with 'vertices' vertices, 'degree' random out-edges each and
+// a ring so that every vertex is reachable from vertex 0.
+Graph makeRandomGraph(size_t vertices, size_t degree, std::mt19937 &rng) {
+    std::uniform_int_distribution<uint32_t> target(0, static_cast<uint32_t>(vertices - 1));
+    std::uniform_int_distribution<uint32_t> weight(1, 1000);
+
+    Graph graph(vertices);
+    for (size_t v = 0; v < vertices; ++v) {
+        graph[v].push_back(Edge{ static_cast<uint32_t>((v + 1) % vertices), weight(rng) });
+        for (size_t e = 1; e < degree; ++e)
+            graph[v].push_back(Edge{ target(rng), weight(rng) });
+    }
+    return graph;
+} // makeRandomGraph()
+
+
+// Square grid of about 'vertices' vertices, each with edges to its four
+// neighbours.
+Graph makeGridGraph(size_t vertices, std::mt19937 &rng) {
+    std::uniform_int_distribution<uint32_t> weight(1, 1000);
+    const size_t side = std::max<size_t>(static_cast<size_t>(std::sqrt(static_cast<double>(vertices))), 2);
+
+    Graph graph(side * side);
+    for (size_t r = 0; r < side; ++r) {
+        for (size_t c = 0; c < side; ++c) {
+            std::vector<Edge> &edges = graph[r * side + c];
+            if (r > 0)
+                edges.push_back(Edge{ static_cast<uint32_t>((r - 1) * side + c), weight(rng) });
+            if (r + 1 < side)
+                edges.push_back(Edge{ static_cast<uint32_t>((r + 1) * side + c), weight(rng) });
+            if (c > 0)
+                edges.push_back(Edge{ static_cast<uint32_t>(r * side + c - 1), weight(rng) });
+            if (c + 1 < side)
+                edges.push_back(Edge{ static_cast<uint32_t>(r * side + c + 1), weight(rng) });
+        }
+    }
+    return graph;
+} // makeGridGraph()
+
+
+// Sequential Dijkstra with lazy deletion: the reference distances.
+std::vector<uint64_t> dijkstra(const Graph &graph) {
+    std::vector<uint64_t> dist(graph.size(), UINT64_MAX);
+    BinaryPQ<DistEntry, DistEntryComp> pq;
+    dist[0] = 0;
+    pq.push(DistEntry{ 0, 0 });
+    while (!pq.empty()) {
+        DistEntry entry = pq.pop_top();
+        if (entry.dist > dist[entry.vertex])
+            continue;
+        for (const Edge &edge : graph[entry.vertex]) {
+            uint64_t candidate = entry.dist + edge.weight;
+            if (candidate < dist[edge.to]) {
+                dist[edge.to] = candidate;
+                pq.push(DistEntry{ candidate, edge.to });
+            }
+        }
+    }
+    return dist;
+} // dijkstra()
+
+
+// A BinaryPQ behind one mutex, shared by every thread, with the same run()
+// interface as WorkStealingScheduler. The order is as strict as threads
+// allow: every pop takes the global top.
+class GlobalScheduler {
+public:
+    using Stats = WorkStealingScheduler<DistEntry, DistEntryComp>::Stats;
+
+    class Worker {
+    public:
+        void push(const DistEntry &task) {
+            owner.pending.fetch_add(1);
+            std::lock_guard<std::mutex> guard{ owner.lock };
+            owner.heap.push(task);
+        } // push()
+
+        size_t index() const {
+            return id;
+        } // index()
+
+    private:
+        friend class GlobalScheduler;
+
+        GlobalScheduler &owner;
+        size_t id;
+        size_t processed = 0;
+
+        Worker(GlobalScheduler &scheduler, size_t i) : owner{ scheduler }, id{ i } {}
+    }; // Worker
+
+    explicit GlobalScheduler(size_t workers) : threads{ workers } {}
+
+    void push(const DistEntry &task) {
+        pending.fetch_add(1);
+        heap.push(task);
+    } // push()
+
+    template<typename Process>
+    Stats run(Process process) {
+        std::vector<Worker> workers;
+        for (size_t i = 0; i < threads; ++i)
+            workers.push_back(Worker{ *this, i });
+        parallelFor(threads, threads, [&](size_t i) {
+            Worker &worker = workers[i];
+            while (pending.load() > 0) {
+                std::unique_lock<std::mutex> guard{ lock };
+                if (heap.empty()) {
+                    guard.unlock();
+                    std::this_thread::yield();
+                    continue;
+                }
+                DistEntry task = heap.pop_top();
+                guard.unlock();
+                process(std::move(task), worker);
+                ++worker.processed;
+                pending.fetch_sub(1);
+            }
+        });
+        Stats total;
+        for (const Worker &worker : workers)
+            total.processed += worker.processed;
+        return total;
+    } // run()
+
+private:
+    size_t threads;
+    std::mutex lock;
+    BinaryPQ<DistEntry, DistEntryComp> heap;
+    std::atomic<size_t> pending{ 0 };
+}; // GlobalScheduler
+
+
+// One per worker, on its own cache line.
+struct alignas(64) WorkerCounts {
+    uint64_t expansions = 0;
+    uint64_t stale = 0;
+};
+
+
+struct Result {
+    double seconds = 0;
+    uint64_t expansions = 0;
+    uint64_t stale = 0;
+    size_t steals = 0;
+    bool correct = false;
+};
+
+
+// Description: Label-correcting SSSP from vertex 0 on the given scheduler.
+template<typename Scheduler>
+Result sssp(Scheduler &scheduler, size_t threads, const Graph &graph, const std::vector<uint64_t> &reference) {
+    std::vector<std::atomic<uint64_t>> dist(graph.size());
+    for (std::atomic<uint64_t> &d : dist)
+        d.store(UINT64_MAX, std::memory_order_relaxed);
+    std::vector<WorkerCounts> counts(threads);
+
+    Clock::time_point start = Clock::now();
+    dist[0].store(0);
+    scheduler.push(DistEntry{ 0, 0 });
+    auto stats = scheduler.run([&](DistEntry task, typename Scheduler::Worker &worker) {
+        WorkerCounts &mine = counts[worker.index()];
+        if (task.dist > dist[task.vertex].load(std::memory_order_relaxed)) {
+            ++mine.stale;
+            return;
+        }
+        ++mine.expansions;
+        for (const Edge &edge : graph[task.vertex]) {
+            const uint64_t candidate = task.dist + edge.weight;
+            std::atomic<uint64_t> &target = dist[edge.to];
+            uint64_t current = target.load(std::memory_order_relaxed);
+            while (candidate < current) {
+                if (target.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                    worker.push(DistEntry{ candidate, edge.to });
+                    break;
+                }
+            }
+        }
+    });
+
+    Result result;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (const WorkerCounts &mine : counts) {
+        result.expansions += mine.expansions;
+        result.stale += mine.stale;
+    }
+    result.steals = stats.steals;
+    result.correct = true;
+    for (size_t v = 0; v < graph.size(); ++v)
+        result.correct = result.correct && dist[v].load() == reference[v];
+    return result;
+} // sssp()
+
+
+Result runScheduler(const std::string &name, size_t threads, const Graph &graph,
+                    const std::vector<uint64_t> &reference) {
+    if (name == "Global") {
+        GlobalScheduler scheduler{ threads };
+        return sssp(scheduler, threads, graph, reference);
+    }
+    StealPolicy policy = name == "StealOne" ? StealPolicy::One : StealPolicy::Half;
+    WorkStealingScheduler<DistEntry, DistEntryComp> scheduler{ threads, DistEntryComp{}, policy };
+    return sssp(scheduler, threads, graph, reference);
+} // runScheduler()
+
+
+std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::istringstream iss{ list };
+    std::string item;
+    while (std::getline(iss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+} // splitList()
+
+
+void printHelp(const char *argv0) {
+    std::cout << "Usage: " << argv0 << " [options]\n"
+              << "  -n, --vertices N      vertices per graph (default 200000)\n"
+              << "  -d, --degree N        out-edges per vertex of the random graph (default 8)\n"
+              << "  -g, --graph LIST      comma separated: random,grid (default both)\n"
+              << "  -i, --impl LIST       comma separated: Global,StealOne,StealHalf (default all)\n"
+              << "  -s, --seed N          random seed (default 281)\n"
+              << "  -t, --threads LIST    thread counts (default 1,2,4,8)\n"
+              << "  -h, --help            show this message" << std::endl;
+} // printHelp()
+
+
+Options parseOptions(int argc, char *argv[]) {
+    static const option longOpts[] = {
+        { "vertices", required_argument, nullptr, 'n' },
+        { "degree", required_argument, nullptr, 'd' },
+        { "graph", required_argument, nullptr, 'g' },
+        { "impl", required_argument, nullptr, 'i' },
+        { "seed", required_argument, nullptr, 's' },
+        { "threads", required_argument, nullptr, 't' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, '\0' },
+    };
+
+    Options opt;
+    int choice = 0;
+    while ((choice = getopt_long(argc, argv, "n:d:g:i:s:t:h", longOpts, nullptr)) != -1) {
+        switch (choice) {
+        case 'n':
+            opt.vertices = std::max<size_t>(std::stoul(optarg), 4);
+            break;
+        case 'd':
+            opt.degree = std::max<size_t>(std::stoul(optarg), 1);
+            break;
+        case 'g':
+            opt.graphs = splitList(optarg);
+            break;
+        case 'i':
+            opt.schedulers = splitList(optarg);
+            break;
+        case 's':
+            opt.seed = static_cast<uint32_t>(std::stoul(optarg));
+            break;
+        case 't':
+            for (const std::string &count : splitList(optarg))
+                opt.threadCounts.push_back(std::max<size_t>(std::stoul(count), 1));
+            break;
+        case 'h':
+            printHelp(argv[0]);
+            std::exit(0);
+        default:
+            printHelp(argv[0]);
+            std::exit(1);
+        }
+    }
+
+    if (opt.graphs.empty())
+        opt.graphs = { "random", "grid" };
+    if (opt.schedulers.empty())
+        opt.schedulers = { "Global", "StealOne", "StealHalf" };
+    if (opt.threadCounts.empty())
+        opt.threadCounts = { 1, 2, 4, 8 };
+    for (const std::string &name : opt.schedulers) {
+        if (name != "Global" && name != "StealOne" && name != "StealHalf") {
+            std::cerr << "Unknown scheduler " << name << std::endl;
+            std::exit(1);
+        }
+    }
+    return opt;
+} // parseOptions()
+
+
+int main(int argc, char *argv[]) {
+    std::ios_base::sync_with_stdio(false);
+    Options opt = parseOptions(argc, argv);
+
+    std::cout << "Parallel SSSP benchmark, n = " << opt.vertices << ", seed = " << opt.seed
+              << ", hardware threads = " << std::thread::hardware_concurrency() << std::endl
+              << std::left << std::setw(8) << "graph" << std::setw(11) << "impl" << std::right
+              << std::setw(8) << "threads" << std::setw(10) << "ms" << std::setw(12) << "expansions"
+              << std::setw(9) << "wasted" << std::setw(12) << "stale pops" << std::setw(9) << "steals"
+              << std::setw(9) << "check" << std::endl;
+    bool allCorrect = true;
+    for (const std::string &kind : opt.graphs) {
+        std::mt19937 rng{ opt.seed };
+        Graph graph;
+        if (kind == "random") {
+            graph = makeRandomGraph(opt.vertices, opt.degree, rng);
+        }
+        else if (kind == "grid") {
+            graph = makeGridGraph(opt.vertices, rng);
+        }
+        else {
+            std::cerr << "Unknown graph " << kind << std::endl;
+            return 1;
+        }
+        const std::vector<uint64_t> reference = dijkstra(graph);
+
+        for (const std::string &name : opt.schedulers) {
+            for (size_t threads : opt.threadCounts) {
+                Result r = runScheduler(name, threads, graph, reference);
+                // Every vertex is reachable, so Dijkstra expands each once.
+                double wasted = static_cast<double>(r.expansions) / static_cast<double>(graph.size()) - 1.0;
+                allCorrect = allCorrect && r.correct;
+                std::cout << std::left << std::setw(8) << kind << std::setw(11) << name << std::right
+                          << std::setw(8) << threads << std::setw(10) << std::fixed << std::setprecision(1)
+                          << r.seconds * 1000 << std::setw(12) << r.expansions << std::setw(8)
+                          << std::setprecision(2) << wasted * 100 << '%' << std::setw(12) << r.stale
+                          << std::setw(9) << r.steals << std::setw(9) << (r.correct ? "ok" : "WRONG")
+                          << std::endl;
+            }
+        }
+    }
+    return allCorrect ? 0 : 1;
+} // main()
@@ -0,0 +1,346 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+/*
+ * Benchmark driver for timer queues, on a trace shaped like the timeouts of
+ * a server: n connections, each with one pending timer, and a clock that
+ * ticks in milliseconds. Every tick, e events hit random connections:
+ *
+ *   activity (90%)  the connection's timer is rescheduled (or scheduled, if
+ *                   the connection had none) to now + a timeout: an idle
+ *                   timeout of 30 s (60%), a request timeout of 5 s (30%),
+ *                   or a retransmission timeout of 200-1000 ms (10%)
+ *   close (10%)     the connection's timer is cancelled
+ *
+ * and then every timer due by the end of the tick expires. Most timers are
+ * therefore cancelled or rescheduled long before they fire. The trace is
+ * generated up front, so every queue runs exactly the same operations; the
+ * checksum folds in every expired timer in an order independent way and
+ * must be identical for all queues.
+ *
+ * Build with 'make benchTimers' (always an optimized build), then for
+ * example:
+ *
+ *     ./benchTimers                        every queue, default trace
+ *     ./benchTimers -n 1000000 -t 20000 -e 5000 -i Pairing,TimerWheel
+ *     ./benchTimers --help
+ *
+ * Queues:
+ *   Pairing        PairingPQ, addNode / updateElt / erase, and pop_top()
+ *                  while the top is due
+ *   IndexedBinary  IndexedBinaryPQ, the same operations
+ *   TimerWheel     TimerWheelPQ, addNode / updateElt / cancel, and
+ *                  advance() once per tick
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "IndexedBinaryPQ.h"
+#include "PQKey.h"
+#include "PairingPQ.h"
+#include "TimerWheelPQ.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+// A pending timeout: deadline in milliseconds, and the connection it is for.
+using Timer = std::pair<uint64_t, uint32_t>;
+
+
+struct Options {
+    size_t connections = 100000;
+    size_t ticks = 10000;
+    size_t eventsPerTick = 1000;
+    uint32_t seed = 281;
+    std::vector<std::string> impls;
+};
+
+
+struct Event {
+    uint32_t connection;
+    // Timeout in milliseconds, 0 for a close.
+    uint32_t timeout;
+};
+
+
+// Every event of the run, tick by tick, after one activity per connection
+// at time 0.
+struct Trace {
+    std::vector<uint32_t> initial;
+    std::vector<Event> events;
+};
+
+
+Trace makeTrace(const Options &opt) {
+    std::mt19937 rng{ opt.seed };
+    std::uniform_int_distribution<uint32_t> connection(0, static_cast<uint32_t>(opt.connections - 1));
+    std::uniform_int_distribution<uint32_t> percent(0, 99);
+    std::uniform_int_distribution<uint32_t> rto(200, 1000);
+    auto timeout = [&]() -> uint32_t {
+        uint32_t p = percent(rng);
+        if (p < 60)
+            return 30000;
+        if (p < 90)
+            return 5000;
+        return rto(rng);
+    };
+
+    Trace trace;
+    for (size_t i = 0; i < opt.connections; ++i)
+        trace.initial.push_back(timeout());
+    trace.events.reserve(opt.ticks * opt.eventsPerTick);
+    for (size_t i = 0; i < opt.ticks * opt.eventsPerTick; ++i) {
+        uint32_t c = connection(rng);
+        trace.events.push_back(Event{ c, percent(rng) < 10 ? 0 : timeout() });
+    }
+    return trace;
+} // makeTrace()
+
+
+// What a run did. Every queue must report the same counts and checksum.
+struct Result {
+    double seconds = 0;
+    uint64_t scheduled = 0;
+    uint64_t rescheduled = 0;
+    uint64_t cancelled = 0;
+    uint64_t expired = 0;
+    uint64_t checksum = 0;
+};
+
+
+// Heap based timer queues: PairingPQ and IndexedBinaryPQ, which have the
+// same handle API.
+template<typename PQ>
+class HeapTimers {
+public:
+    using Handle = decltype(std::declval<PQ &>().addNode(std::declval<const Timer &>()));
+
+    Handle schedule(const Timer &timer) {
+        return pq.addNode(timer);
+    } // schedule()
+
+    void reschedule(Handle handle, const Timer &timer) {
+        pq.updateElt(handle, timer);
+    } // reschedule()
+
+    void cancel(Handle handle) {
+        pq.erase(handle);
+    } // cancel()
+
+    template<typename Fire>
+    void expire(uint64_t now, Fire fire) {
+        while (!pq.empty() && pq.top().first <= now)
+            fire(pq.pop_top());
+    } // expire()
+
+private:
+    PQ pq{ FirstGreater() };
+}; // HeapTimers
+
+
+class WheelTimers {
+public:
+    using Wheel = TimerWheelPQ<Timer, FirstGreater>;
+    using Handle = Wheel::Node *;
+
+    Handle schedule(const Timer &timer) {
+        return wheel.addNode(timer);
+    } // schedule()
+
+    void reschedule(Handle handle, const Timer &timer) {
+        wheel.updateElt(handle, timer);
+    } // reschedule()
+
+    void cancel(Handle handle) {
+        wheel.cancel(handle);
+    } // cancel()
+
+    template<typename Fire>
+    void expire(uint64_t now, Fire fire) {
+        wheel.advance(now, fire);
+    } // expire()
+
+private:
+    Wheel wheel;
+}; // WheelTimers
+
+
+// Description: Replays the trace on one timer queue and times it.
+template<typename Timers>
+Result replay(const Trace &trace, const Options &opt) {
+    using Handle = typename Timers::Handle;
+    Timers timers;
+    std::vector<Handle> handles(opt.connections);
+    std::vector<bool> pending(opt.connections, false);
+    Result result;
+
+    auto fire = [&](Timer &&timer) {
+        pending[timer.second] = false;
+        ++result.expired;
+        result.checksum += timer.first * 1000003 + timer.second;
+    };
+
+    Clock::time_point start = Clock::now();
+    for (uint32_t c = 0; c < trace.initial.size(); ++c) {
+        handles[c] = timers.schedule(Timer{ trace.initial[c], c });
+        pending[c] = true;
+        ++result.scheduled;
+    }
+    size_t next = 0;
+    for (uint64_t now = 1; now <= opt.ticks; ++now) {
+        for (size_t i = 0; i < opt.eventsPerTick; ++i) {
+            const Event &event = trace.events[next++];
+            const uint32_t c = event.connection;
+            if (event.timeout == 0) {
+                if (pending[c]) {
+                    timers.cancel(handles[c]);
+                    pending[c] = false;
+                    ++result.cancelled;
+                }
+            }
+            else if (pending[c]) {
+                timers.reschedule(handles[c], Timer{ now + event.timeout, c });
+                ++result.rescheduled;
+            }
+            else {
+                handles[c] = timers.schedule(Timer{ now + event.timeout, c });
+                pending[c] = true;
+                ++result.scheduled;
+            }
+        }
+        timers.expire(now, fire);
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+} // replay()
+
+
+struct Impl {
+    const char *name;
+    Result (*run)(const Trace &, const Options &);
+};
+
+const std::vector<Impl> &implementations() {
+    static const std::vector<Impl> impls {
+        { "Pairing", replay<HeapTimers<PairingPQ<Timer, FirstGreater>>> },
+        { "IndexedBinary", replay<HeapTimers<IndexedBinaryPQ<Timer, FirstGreater>>> },
+        { "TimerWheel", replay<WheelTimers> },
+    };
+    return impls;
+} // implementations()
+
+
+std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::istringstream iss{ list };
+    std::string item;
+    while (std::getline(iss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+} // splitList()
+
+
+void printHelp(const char *argv0) {
+    std::cout << "Usage: " << argv0 << " [options]\n"
+              << "  -n, --connections N   connections, one timer each at most (default 100000)\n"
+              << "  -t, --ticks N         milliseconds simulated (default 10000)\n"
+              << "  -e, --events N        events per tick (default 1000)\n"
+              << "  -i, --impl LIST       comma separated queue names (default all)\n"
+              << "  -s, --seed N          random seed (default 281)\n"
+              << "  -h, --help            show this message\n"
+              << "Queues:";
+    for (const Impl &impl : implementations())
+        std::cout << ' ' << impl.name;
+    std::cout << std::endl;
+} // printHelp()
+
+
+Options parseOptions(int argc, char *argv[]) {
+    static const option longOpts[] = {
+        { "connections", required_argument, nullptr, 'n' },
+        { "ticks", required_argument, nullptr, 't' },
+        { "events", required_argument, nullptr, 'e' },
+        { "impl", required_argument, nullptr, 'i' },
+        { "seed", required_argument, nullptr, 's' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, '\0' },
+    };
+
+    Options opt;
+    int choice = 0;
+    while ((choice = getopt_long(argc, argv, "n:t:e:i:s:h", longOpts, nullptr)) != -1) {
+        switch (choice) {
+        case 'n':
+            opt.connections = std::max<size_t>(std::stoul(optarg), 1);
+            break;
+        case 't':
+            opt.ticks = std::stoul(optarg);
+            break;
+        case 'e':
+            opt.eventsPerTick = std::stoul(optarg);
+            break;
+        case 'i':
+            opt.impls = splitList(optarg);
+            break;
+        case 's':
+            opt.seed = static_cast<uint32_t>(std::stoul(optarg));
+            break;
+        case 'h':
+            printHelp(argv[0]);
+            std::exit(0);
+        default:
+            printHelp(argv[0]);
+            std::exit(1);
+        }
+    }
+
+    if (opt.impls.empty())
+        for (const Impl &impl : implementations())
+            opt.impls.push_back(impl.name);
+    return opt;
+} // parseOptions()
+
+
+int main(int argc, char *argv[]) {
+    std::ios_base::sync_with_stdio(false);
+    Options opt = parseOptions(argc, argv);
+    Trace trace = makeTrace(opt);
+
+    std::cout << "Timer benchmark, " << opt.connections << " connections, " << opt.ticks << " ticks, "
+              << opt.eventsPerTick << " events per tick, seed = " << opt.seed << std::endl
+              << std::left << std::setw(16) << "impl" << std::right << std::setw(10) << "ms"
+              << std::setw(14) << "ops/sec" << std::setw(11) << "scheduled" << std::setw(13) << "rescheduled"
+              << std::setw(11) << "cancelled" << std::setw(10) << "expired" << std::setw(22) << "checksum"
+              << std::endl;
+    for (const std::string &name : opt.impls) {
+        const Impl *impl = nullptr;
+        for (const Impl &candidate : implementations())
+            if (name == candidate.name)
+                impl = &candidate;
+        if (impl == nullptr) {
+            std::cerr << "Unknown queue " << name << std::endl;
+            return 1;
+        }
+
+        Result r = impl->run(trace, opt);
+        const uint64_t ops = r.scheduled + r.rescheduled + r.cancelled + r.expired;
+        std::cout << std::left << std::setw(16) << impl->name << std::right << std::fixed
+                  << std::setw(10) << std::setprecision(1) << r.seconds * 1000
+                  << std::setw(14) << std::setprecision(0)
+                  << (r.seconds > 0 ? static_cast<double>(ops) / r.seconds : 0.0)
+                  << std::setw(11) << r.scheduled << std::setw(13) << r.rescheduled << std::setw(11)
+                  << r.cancelled << std::setw(10) << r.expired << std::setw(22) << r.checksum << std::endl;
+    }
+    return 0;
+} // main()
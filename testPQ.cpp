@@ -24,18 +24,50 @@
  * do.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <ostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <set>
+#include <thread>
 #include <vector>
 
+#include <sys/resource.h>
+
 #include "BinaryPQ.h"
+#include "BufferedSortedPQ.h"
+#include "BucketPQ.h"
+#include "CompactPairingPQ.h"
+#include "DaryPQ.h"
+#include "ExternalPQ.h"
 #include "Eecs281PQ.h"
+#include "FibonacciPQ.h"
+#include "FindExtreme.h"
+#include "IndexedBinaryPQ.h"
+#include "LockedHeapPQ.h"
+#include "MultiQueuePQ.h"
 #include "PairingPQ.h"
+#include "ParallelRebuild.h"
+#include "PoolAllocator.h"
+#include "RadixPQ.h"
+#include "RankPairingPQ.h"
+#include "SkipListPQ.h"
 #include "SortedPQ.h"
+#include "TimerWheelPQ.h"
+#include "UnorderedFastPQ.h"
 #include "UnorderedPQ.h"
+#include "WorkStealingScheduler.h"
 
 
 // A type for representing priority queue types at runtime
@@ -44,6 +76,20 @@ enum class PQType {
     Sorted,
     Binary,
     Pairing,
+    UnorderedFast,
+    Dary,
+    CompactPairing,
+    IndexedBinary,
+    LockedHeap,
+    MultiQueue,
+    SkipList,
+    Radix,
+    TimerWheel,
+    Bucket,
+    Fibonacci,
+    RankPairing,
+    BHeap,
+    External,
 };
 
 // These can be pretty-printed :)
@@ -57,12 +103,53 @@ std::ostream& operator<<(std::ostream& ost, PQType pqType) {
         return ost << "Binary";
     case PQType::Pairing:
         return ost << "Pairing";
+    case PQType::UnorderedFast:
+        return ost << "UnorderedFast";
+    case PQType::Dary:
+        return ost << "Dary";
+    case PQType::CompactPairing:
+        return ost << "CompactPairing";
+    case PQType::IndexedBinary:
+        return ost << "IndexedBinary";
+    case PQType::LockedHeap:
+        return ost << "LockedHeap";
+    case PQType::MultiQueue:
+        return ost << "MultiQueue";
+    case PQType::SkipList:
+        return ost << "SkipList";
+    case PQType::Radix:
+        return ost << "Radix";
+    case PQType::TimerWheel:
+        return ost << "TimerWheel";
+    case PQType::Bucket:
+        return ost << "Bucket";
+    case PQType::Fibonacci:
+        return ost << "Fibonacci";
+    case PQType::RankPairing:
+        return ost << "RankPairing";
+    case PQType::BHeap:
+        return ost << "BHeap";
+    case PQType::External:
+        return ost << "External";
     }
 
     return ost << "Unknown PQType";
 }
 
 
+// DaryPQ takes its arity as a third template argument; these aliases give
+// it the PQ<TYPE, COMP> shape that the test templates expect.
+template <typename TYPE, typename COMP = std::less<TYPE>>
+using TernaryPQ = DaryPQ<TYPE, COMP, 3>;
+template <typename TYPE, typename COMP = std::less<TYPE>>
+using QuaternaryPQ = DaryPQ<TYPE, COMP, 4>;
+template <typename TYPE, typename COMP = std::less<TYPE>>
+using OctonaryPQ = DaryPQ<TYPE, COMP, 8>;
+// BinaryPQ in the B-heap layout.
+template <typename TYPE, typename COMP = std::less<TYPE>>
+using BHeapPQ = BinaryPQ<TYPE, COMP, HeapLayout::BHeap>;
+
+
 // Compares two int const* on the integers they point to
 struct IntPtrComp {
     bool operator()(const int *a, const int *b) const { return *a < *b; }
@@ -75,6 +162,9 @@ template <template <typename...> typename PQ>
 void testPrimitiveOperations() {
     std::cout << "Testing primitive priority queue operations..." << std::endl;
 
+    // Calls through the concrete type must be statically dispatched.
+    static_assert(IsStaticPQ<PQ<int>>::value, "PQ must be final");
+
     PQ<int> pq {};
     Eecs281PQ<int>& eecsPQ = pq;
 
@@ -165,6 +255,72 @@ void testHiddenData() {
 }
 
 
+// Counts how many times any instance is copied, so tests can check that
+// the move-aware operations really never copy.
+struct CopyCounter {
+    static int copies;
+    int key;
+    std::string payload;
+
+    explicit CopyCounter(int k) : key{ k }, payload(32, char('a' + k % 26)) {}
+    CopyCounter(const CopyCounter &other) : key{ other.key }, payload{ other.payload } {
+        ++copies;
+    }
+    CopyCounter(CopyCounter &&other) noexcept = default;
+    CopyCounter &operator=(const CopyCounter &other) {
+        key = other.key;
+        payload = other.payload;
+        ++copies;
+        return *this;
+    }
+    CopyCounter &operator=(CopyCounter &&other) noexcept = default;
+};
+
+int CopyCounter::copies = 0;
+
+struct CopyCounterComp {
+    bool operator()(const CopyCounter &a, const CopyCounter &b) const {
+        return a.key < b.key;
+    }
+};
+
+
+// Test push(TYPE &&), emplace() and pop_top(): none of them may copy.
+template <template <typename...> typename PQ>
+void testMoveSemantics() {
+    std::cout << "Testing move-aware operations..." << std::endl;
+
+    PQ<CopyCounter, CopyCounterComp> pq {};
+    Eecs281PQ<CopyCounter, CopyCounterComp>& eecsPQ = pq;
+    CopyCounter::copies = 0;
+
+    for (int i = 0; i < 20; ++i) {
+        int key = (i * 7) % 20;
+        if (i % 3 == 0) {
+            pq.emplace(key);
+        }
+        else if (i % 3 == 1) {
+            eecsPQ.emplace(key);
+        }
+        else {
+            CopyCounter value { key };
+            eecsPQ.push(std::move(value));
+        }
+    }
+    assert(eecsPQ.size() == 20);
+
+    for (int expected = 19; expected >= 0; --expected) {
+        CopyCounter value = eecsPQ.pop_top();
+        assert(value.key == expected);
+        assert(value.payload == std::string(32, char('a' + expected % 26)));
+    }
+    assert(eecsPQ.empty());
+    assert(CopyCounter::copies == 0);
+
+    std::cout << "testMoveSemantics succeeded!" << std::endl;
+}
+
+
 // Test the last public member function of Eecs281PQ, updatePriorities
 template <template <typename...> typename PQ>
 void testUpdatePriorities() {
@@ -226,6 +382,105 @@ void testUpdatePriorities() {
 }
 
 
+// Test notifyChanged, which only repairs the elements reported as changed:
+// first a few of them, then so many that the PQ rebuilds instead.
+template <template <typename...> typename PQ>
+void testNotifyChanged() {
+    std::cout << "Testing notifyChanged..." << std::endl;
+
+    std::vector<int> data(200);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<int>((i * 37) % 200);
+
+    PQ<const int*, IntPtrComp> pq {};
+    Eecs281PQ<const int*, IntPtrComp>& eecsPQ = pq;
+    for (size_t changes : { 3, 5, 100 }) {
+        if (eecsPQ.empty()) {
+            for (auto& datum : data)
+                eecsPQ.push(&datum);
+        }
+
+        // Raise and lower distinct elements, by more than the spread of the
+        // values, so they have to move.
+        std::vector<const int*> changed;
+        for (size_t i = 0; i < changes; ++i) {
+            size_t j = (i * 71 + changes) % data.size();
+            data[j] += (i % 2 == 0) ? 500 : -500;
+            changed.push_back(&data[j]);
+        }
+        eecsPQ.notifyChanged(changed);
+        assert(*eecsPQ.top() == *std::max_element(data.begin(), data.end()));
+        if (changes == 3)
+            continue;
+
+        std::vector<int> expected(data);
+        std::sort(expected.begin(), expected.end());
+        while (!expected.empty()) {
+            [[maybe_unused]] const int *got = eecsPQ.pop_top();
+            assert(*got == expected.back());
+            expected.pop_back();
+        }
+        assert(eecsPQ.empty());
+    }
+
+    // Nothing changed, nothing to do.
+    eecsPQ.notifyChanged({});
+    assert(eecsPQ.empty());
+
+    std::cout << "testNotifyChanged succeeded!" << std::endl;
+}
+
+
+// Test merge(PQ &&): shards of one set of values, merged back together in
+// different size ratios, must pop as that set, and leave the shards empty.
+template <template <typename...> typename PQ>
+void testMerge() {
+    std::cout << "Testing merge..." << std::endl;
+
+    std::vector<int> values;
+    for (int i = 0; i < 3000; ++i)
+        values.push_back((i * 7919) % 2003);
+
+    // Shards of very different sizes take both of BinaryPQ's paths.
+    const size_t bounds[] { 0, 1500, 1510, 1511, 2900, 3000 };
+    std::vector<PQ<int>> shards(std::size(bounds) - 1);
+    for (size_t s = 0; s + 1 < std::size(bounds); ++s) {
+        for (size_t i = bounds[s]; i < bounds[s + 1]; ++i)
+            shards[s].push(values[i]);
+        // A pop builds real trees in the node based heaps.
+        if (!shards[s].empty())
+            shards[s].push(shards[s].pop_top());
+    }
+
+    PQ<int> merged;
+    PQ<int> empty;
+    merged.merge(std::move(empty));
+    assert(merged.empty());
+    for (PQ<int> &shard : shards) {
+        merged.merge(std::move(shard));
+        assert(shard.empty());
+        merged.merge(std::move(merged));
+        merged.merge(std::move(empty));
+    }
+    assert(merged.size() == values.size());
+
+    // Shards can be reused after they were merged.
+    shards[0].push(5000);
+    merged.merge(std::move(shards[0]));
+    values.push_back(5000);
+
+    std::sort(values.begin(), values.end());
+    while (!values.empty()) {
+        [[maybe_unused]] int got = merged.pop_top();
+        assert(got == values.back());
+        values.pop_back();
+    }
+    assert(merged.empty());
+
+    std::cout << "testMerge succeeded!" << std::endl;
+}
+
+
 // Test the pairing heap's range-based constructor, copy constructor,
 // copy-assignment operator, and destructor
 // TODO: Test other operations specific to this PQ type.
@@ -289,16 +544,1606 @@ void testPairing() {
         std::cout << "Calling destructors" << std::endl;
     }
 
+    {
+        std::cout << "Testing two-pass pop, copy and rebuild" << std::endl;
+
+        // Enough pops to build deep, wide trees for the copy to walk.
+        PairingPQ<int> pq;
+        std::vector<int> values;
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back((i * 7919) % 1009);
+            pq.push(values.back());
+            if (i % 3 == 0) {
+                pq.pop();
+                values.erase(std::max_element(values.begin(), values.end()));
+            }
+        }
+        PairingPQ<int> copy { pq };
+        pq.updatePriorities();
+        std::sort(values.begin(), values.end());
+        while (!values.empty()) {
+            [[maybe_unused]] int got = pq.pop_top();
+            assert(got == values.back());
+            [[maybe_unused]] int copied = copy.pop_top();
+            assert(copied == values.back());
+            values.pop_back();
+        }
+        assert(pq.empty() && copy.empty());
+    }
+
+    {
+        std::cout << "Testing two-way updateElt and erase" << std::endl;
+
+        PairingPQ<int> pq;
+        std::vector<PairingPQ<int>::Node *> nodes;
+        std::vector<int> values;
+        for (int i = 0; i < 300; ++i) {
+            values.push_back((i * 7919) % 1013);
+            nodes.push_back(pq.addNode(values.back()));
+        }
+        // Pops build real trees, so updates hit nodes at every depth.
+        pq.pop();
+        size_t popped = size_t(std::max_element(values.begin(), values.end()) - values.begin());
+
+        for (size_t i = 0; i < nodes.size(); i += 3) {
+            if (i == popped)
+                continue;
+            values[i] = (i % 2 == 0) ? values[i] + 2000 : values[i] - 2000;
+            pq.updateElt(nodes[i], values[i]);
+            assert(nodes[i]->getElt() == values[i]);
+        }
+        // Lowering the root must hand the top to another element.
+        int top = pq.top();
+        size_t topIndex = size_t(std::find(values.begin(), values.end(), top) - values.begin());
+        values[topIndex] = -5000;
+        pq.updateElt(nodes[topIndex], values[topIndex]);
+        assert(pq.top() != -5000);
+
+        std::vector<int> expected;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (i == popped)
+                continue;
+            if (i % 10 == 1)
+                pq.erase(nodes[i]);
+            else
+                expected.push_back(values[i]);
+        }
+        assert(pq.size() == expected.size());
+        std::sort(expected.begin(), expected.end());
+        while (!expected.empty()) {
+            [[maybe_unused]] int got = pq.pop_top();
+            assert(got == expected.back());
+            expected.pop_back();
+        }
+
+        // Pointers stay equal when their pointees change, in either direction.
+        int keys[] { 10, 20, 30, 40 };
+        PairingPQ<const int *, IntPtrComp> ptrs;
+        std::vector<PairingPQ<const int *, IntPtrComp>::Node *> handles;
+        for (const int &key : keys)
+            handles.push_back(ptrs.addNode(&key));
+        ptrs.pop();
+        keys[2] = 0;
+        ptrs.updateElt(handles[2], &keys[2]);
+        assert(*ptrs.top() == 20);
+        keys[0] = 50;
+        ptrs.updateElt(handles[0], &keys[0]);
+        assert(*ptrs.top() == 50);
+    }
+
+    {
+        std::cout << "Testing notifyChangedNodes" << std::endl;
+
+        std::vector<int> keys(400);
+        for (size_t i = 0; i < keys.size(); ++i)
+            keys[i] = static_cast<int>((i * 7919) % 1013);
+        PairingPQ<const int *, IntPtrComp> ptrs;
+        std::vector<PairingPQ<const int *, IntPtrComp>::Node *> nodes;
+        for (const int &key : keys)
+            nodes.push_back(ptrs.addNode(&key));
+        // Pops build real trees, so the changes hit nodes at every depth.
+        size_t popped = size_t(ptrs.top() - keys.data());
+        ptrs.pop();
+
+        std::vector<PairingPQ<const int *, IntPtrComp>::Node *> changed;
+        for (size_t i = 1; i < keys.size(); i += 40) {
+            if (i == popped)
+                continue;
+            keys[i] += (i % 3 == 0) ? 2000 : -2000;
+            changed.push_back(nodes[i]);
+        }
+        ptrs.notifyChangedNodes(changed);
+
+        std::vector<int> expected(keys);
+        expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(popped));
+        std::sort(expected.begin(), expected.end());
+        while (!expected.empty()) {
+            [[maybe_unused]] const int *got = ptrs.pop_top();
+            assert(*got == expected.back());
+            expected.pop_back();
+        }
+    }
+
+    {
+        std::cout << "Testing bulk construction" << std::endl;
+
+        std::vector<int> values;
+        for (int i = 0; i < 1000; ++i)
+            values.push_back((i * 7919) % 1009);
+        PairingPQ<int> bulk { values.begin(), values.end() };
+
+        // An input iterator range cannot be sized in advance.
+        std::istringstream in { "5 3 9 1" };
+        PairingPQ<int> streamed { std::istream_iterator<int>{ in }, std::istream_iterator<int>{} };
+        assert(streamed.size() == 4 && streamed.top() == 9);
+
+        bulk.pop();
+        PairingPQ<int> copy { bulk };
+        std::sort(values.begin(), values.end());
+        values.pop_back();
+        while (!values.empty()) {
+            [[maybe_unused]] int got = bulk.pop_top();
+            assert(got == values.back());
+            [[maybe_unused]] int copied = copy.pop_top();
+            assert(copied == values.back());
+            values.pop_back();
+        }
+    }
+
+    {
+        std::cout << "Testing merge with handles" << std::endl;
+
+        // Nodes move with their pool: handles into the merged heap keep
+        // working after it is gone.
+        PairingPQ<int> into;
+        std::vector<PairingPQ<int>::Node *> handles;
+        for (int i = 0; i < 500; ++i)
+            into.push(i * 2);
+        {
+            PairingPQ<int> from;
+            for (int i = 0; i < 500; ++i)
+                handles.push_back(from.addNode(i * 2 + 1));
+            from.pop();
+            into.merge(std::move(from));
+            assert(from.empty());
+            from.push(3);
+        }
+        assert(into.size() == 999 && into.top() == 998);
+        into.updateElt(handles[10], 5000);
+        [[maybe_unused]] int got = into.pop_top();
+        assert(got == 5000);
+        into.erase(handles[20]);
+        for (int i = 0; i < 500; ++i)
+            into.push(i);
+        assert(into.size() == 1497);
+
+        // Strings cannot skip their destructors, and plain allocators
+        // always compare equal.
+        PairingPQ<std::string, std::less<std::string>, std::allocator<std::string>> words;
+        PairingPQ<std::string, std::less<std::string>, std::allocator<std::string>> more;
+        words.push("merge");
+        more.push("meld");
+        more.push("zip");
+        words.merge(std::move(more));
+        assert(more.empty() && words.size() == 3 && words.top() == "zip");
+
+        // Allocators that share a pool with a third party cannot give it
+        // away; the elements are moved one by one instead.
+        PoolAllocator<int> shared;
+        PairingPQ<std::string> left;
+        PairingPQ<std::string> right { std::less<std::string>{}, PoolAllocator<std::string>{ shared } };
+        PoolAllocator<std::string> keepsPool { shared };
+        left.push("a");
+        right.push("b");
+        right.push("c");
+        left.merge(std::move(right));
+        assert(right.empty() && left.size() == 3);
+        [[maybe_unused]] std::string top = left.pop_top();
+        assert(top == "c");
+    }
+
+    {
+        std::cout << "Testing node pool" << std::endl;
+
+        // Freed blocks are handed out again before new ones are carved.
+        PoolAllocator<int> alloc;
+        int *a = alloc.allocate(1);
+        alloc.deallocate(a, 1);
+        assert(alloc.allocate(1) == a);
+
+        PairingPQ<int> pooled;
+        std::vector<PairingPQ<int>::Node *> handles;
+        for (int i = 0; i < 1000; ++i)
+            handles.push_back(pooled.addNode(i));
+        for (int i = 0; i < 500; ++i)
+            pooled.pop();
+        // Handles of the surviving nodes still work after the churn.
+        for (int i = 0; i < 500; ++i)
+            pooled.push(i);
+        assert(handles[10]->getElt() == 10);
+        pooled.updateElt(handles[10], 5000);
+        assert(pooled.top() == 5000);
+        pooled.clear();
+        assert(pooled.empty());
+        pooled.push(7);
+        assert(pooled.top() == 7);
+
+        // Strings need their destructors run, so clear() walks the nodes.
+        PairingPQ<std::string> words;
+        words.push("pool");
+        words.push("slab");
+        PairingPQ<std::string> copy { words };
+        words.clear();
+        assert(words.empty());
+        assert(copy.size() == 2 && copy.top() == "slab");
+
+        // Any standard allocator works as well.
+        PairingPQ<int, std::less<int>, std::allocator<int>> plain;
+        plain.push(1);
+        plain.push(3);
+        [[maybe_unused]] int got = plain.pop_top();
+        assert(got == 3);
+    }
+
     std::cout << "testPairing succeeded!" << std::endl;
 }
 
 
+// The scalar loop findExtremeIndex() must agree with, tie-breaking included.
+template <typename TYPE, typename COMP>
+size_t scalarExtreme(const std::vector<TYPE> &data, COMP comp) {
+    size_t index = 0;
+    for (size_t i = 1; i < data.size(); ++i)
+        if (comp(data[index], data[i]))
+            index = i;
+    return index;
+}
+
+template <typename TYPE>
+void checkFindExtreme(const std::vector<TYPE> &data) {
+    for (size_t n = 1; n <= data.size(); ++n) {
+        std::vector<TYPE> prefix { data.begin(), data.begin() + static_cast<std::ptrdiff_t>(n) };
+        assert(findExtremeIndex(prefix.data(), n, std::less<TYPE>{})
+               == scalarExtreme(prefix, std::less<TYPE>{}));
+        assert(findExtremeIndex(prefix.data(), n, std::greater<TYPE>{})
+               == scalarExtreme(prefix, std::greater<TYPE>{}));
+#ifdef FIND_EXTREME_SIMD
+        // The SSE2 kernel is only picked on CPUs without AVX2, check it here.
+        using Kernel = SimdExtremeKernel<TYPE, true>;
+        if (n >= Kernel::MIN_SIZE) {
+            [[maybe_unused]] size_t index = Kernel::extremeIndexBaseline(prefix.data(), n);
+            assert(index == n || index == scalarExtreme(prefix, std::less<TYPE>{}));
+        }
+#endif
+    }
+}
+
+// Test the vectorized findExtreme of the unordered PQs against the scalar
+// loop on arithmetic types, with many ties, signed zeros and NaNs.
+void testFindExtreme() {
+    std::cout << "Testing vectorized findExtreme..." << std::endl;
+
+    std::vector<int> ints;
+    std::vector<uint64_t> words;
+    std::vector<double> doubles;
+    std::vector<float> floats;
+    unsigned int state = 281;
+    for (int i = 0; i < 200; ++i) {
+        state = state * 1103515245u + 12345u;
+        int value = int(state >> 16) % 23 - 11;
+        ints.push_back(value);
+        words.push_back(uint64_t(value + 11) << 40);
+        doubles.push_back(value == 0 && i % 2 ? -0.0 : value / 4.0);
+        floats.push_back(float(value) / 8.0f);
+    }
+    checkFindExtreme(ints);
+    checkFindExtreme(words);
+    checkFindExtreme(doubles);
+    checkFindExtreme(floats);
+
+    doubles[70] = std::nan("");
+    checkFindExtreme(doubles);
+    doubles[0] = std::nan("");
+    checkFindExtreme(doubles);
+
+    UnorderedPQ<int> unordered { ints.begin(), ints.end() };
+    UnorderedFastPQ<double, std::greater<double>> fast { floats.begin(), floats.end() };
+    while (!unordered.empty()) {
+        int expected = *std::max_element(ints.begin(), ints.end());
+        assert(unordered.top() == expected);
+        unordered.pop();
+        ints.erase(std::find(ints.begin(), ints.end(), expected));
+    }
+    assert(fast.top() == double(*std::min_element(floats.begin(), floats.end())));
+
+    std::cout << "testFindExtreme succeeded!" << std::endl;
+}
+
+
+// Test DaryPQ against a reference on a longer random sequence, and check
+// that the allocator puts each group of 8 int siblings in one cache line.
+void testDary() {
+    std::cout << "Testing d-ary heap layout..." << std::endl;
+
+    std::vector<int> values;
+    unsigned int state = 12345;
+    for (int i = 0; i < 1000; ++i) {
+        state = state * 1103515245u + 12345u;
+        values.push_back(int(state >> 8) % 500);
+    }
+
+    OctonaryPQ<int> pq { values.begin(), values.end() };
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < 300; ++i) {
+        assert(pq.top() == sorted.back());
+        pq.pop();
+        sorted.pop_back();
+    }
+
+    // top() is element 0; element 1 must start a cache line.
+    [[maybe_unused]] const char* root = reinterpret_cast<const char*>(&pq.top());
+    assert(reinterpret_cast<uintptr_t>(root + sizeof(int)) % 64 == 0);
+
+    std::cout << "testDary succeeded!" << std::endl;
+}
+
+
+// A 512 byte element, so that a B-heap page holds only 8 of them and a few
+// thousand elements already span several levels of pages.
+struct WideEntry {
+    int key;
+    char pad[508];
+};
+
+struct WideEntryComp {
+    bool operator()(const WideEntry &a, const WideEntry &b) const { return a.key < b.key; }
+};
+
+
+// Test the B-heap layout of BinaryPQ against a reference, with pages of 8
+// and of 1024 elements, and check that its pages start at page boundaries.
+void testBHeap() {
+    std::cout << "Testing B-heap layout..." << std::endl;
+
+    // Random pushes and pops of wide elements, with a rebuild halfway.
+    {
+        BHeapPQ<WideEntry, WideEntryComp> pq;
+        std::multiset<int> reference;
+        unsigned int state = 4321;
+        for (int i = 0; i < 20000; ++i) {
+            state = state * 1103515245u + 12345u;
+            if (reference.empty() || (state >> 8) % 3 != 0) {
+                WideEntry entry{};
+                entry.key = int(state >> 12) % 5000;
+                pq.push(entry);
+                reference.insert(entry.key);
+            }
+            else {
+                [[maybe_unused]] WideEntry got = pq.pop_top();
+                assert(got.key == *reference.rbegin());
+                reference.erase(std::prev(reference.end()));
+            }
+            assert(pq.size() == reference.size());
+            if (i == 10000)
+                pq.updatePriorities();
+        }
+        assert(pq.top().key == *reference.rbegin());
+        assert(reinterpret_cast<uintptr_t>(&pq.top()) % 4096 == sizeof(WideEntry));
+        while (!pq.empty()) {
+            [[maybe_unused]] WideEntry got = pq.pop_top();
+            assert(got.key == *reference.rbegin());
+            reference.erase(std::prev(reference.end()));
+        }
+    }
+
+    // Enough ints to fill more than the 513 pages of the first two levels.
+    {
+        std::vector<int> values;
+        unsigned int state = 12345;
+        for (int i = 0; i < 600000; ++i) {
+            state = state * 1103515245u + 12345u;
+            values.push_back(int(state >> 8) % 1000000);
+        }
+
+        BHeapPQ<int> pq { values.begin(), values.end() };
+        assert(reinterpret_cast<uintptr_t>(&pq.top()) % 4096 == sizeof(int));
+        std::sort(values.begin(), values.end());
+        for (size_t i = 0; i < 1000; ++i) {
+            [[maybe_unused]] int got = pq.pop_top();
+            assert(got == values.back());
+            pq.push(values.back() - 2000000);
+            values.pop_back();
+        }
+        while (!values.empty()) {
+            [[maybe_unused]] int got = pq.pop_top();
+            assert(got == values.back());
+            values.pop_back();
+        }
+        assert(pq.size() == 1000);
+    }
+
+    std::cout << "testBHeap succeeded!" << std::endl;
+}
+
+
+// Test ExternalPQ with a buffer and blocks small enough to spill many runs
+// of several blocks each, against a reference; then its copies, rebuilds
+// and I/O errors.
+void testExternal() {
+    std::cout << "Testing ExternalPQ separately..." << std::endl;
+
+    ExternalPQ<int> pq { std::less<int>(), 1000, 64 };
+    std::multiset<int> reference;
+    unsigned int state = 2024;
+    for (int i = 0; i < 40000; ++i) {
+        state = state * 1103515245u + 12345u;
+        if (reference.empty() || (state >> 8) % 4 != 0) {
+            int val = int(state >> 12) % 100000;
+            pq.push(val);
+            reference.insert(val);
+        }
+        else {
+            [[maybe_unused]] int got = pq.pop_top();
+            assert(got == *reference.rbegin());
+            reference.erase(std::prev(reference.end()));
+        }
+        assert(pq.size() == reference.size());
+    }
+    assert(pq.runCount() > 10);
+    assert(pq.spilledSize() + 1000 >= pq.size());
+    assert(pq.bytesSpilled() >= pq.spilledSize() * sizeof(int));
+    assert(pq.bytesReadBack() > 0);
+
+    {
+        // A copy gets its own spill file and pops the same elements.
+        ExternalPQ<int> copy { pq };
+        assert(copy.size() == pq.size());
+        assert(copy.runCount() == pq.runCount());
+        for (int i = 0; i < 5000; ++i) {
+            [[maybe_unused]] int copied = copy.pop_top();
+            [[maybe_unused]] int got = pq.pop_top();
+            assert(copied == got);
+        }
+        std::multiset<int>::iterator last = reference.end();
+        std::advance(last, -5000);
+        reference.erase(last, reference.end());
+    }
+
+    // Used up runs give their disk space back.
+    while (!pq.empty()) {
+        [[maybe_unused]] int got = pq.pop_top();
+        assert(got == *reference.rbegin());
+        reference.erase(std::prev(reference.end()));
+    }
+    assert(pq.runCount() == 0 && pq.spilledSize() == 0);
+    pq.push(7);
+    assert(pq.top() == 7);
+
+    // Spilled pointers are sorted anew when their pointees change.
+    std::vector<int> keys(3000);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = int(i);
+    ExternalPQ<const int *, IntPtrComp> ptrs { IntPtrComp(), 200, 16 };
+    for (const int &key : keys)
+        ptrs.push(&key);
+    assert(ptrs.runCount() > 0);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = int((i * 7919) % keys.size());
+    ptrs.updatePriorities();
+    for (int expected = int(keys.size()) - 1; expected >= 0; --expected) {
+        [[maybe_unused]] const int *got = ptrs.pop_top();
+        assert(*got == expected);
+    }
+    assert(ptrs.empty());
+
+    // A spill that cannot create its file throws and keeps the buffer.
+    ExternalPQ<int> nowhere { std::less<int>(), 2, 0, "/nonexistent/ExternalPQ" };
+    nowhere.push(1);
+    nowhere.push(2);
+    [[maybe_unused]] bool threw = false;
+    try {
+        nowhere.push(3);
+    }
+    catch (const std::system_error &) {
+        threw = true;
+    }
+    assert(threw);
+    assert(nowhere.size() == 2 && nowhere.top() == 2);
+
+    // A spill whose writes fail keeps every element in the buffer. The
+    // file size limit makes pwrite() fail with EFBIG once the spill file
+    // would grow past the runs already in it.
+    ExternalPQ<int> full { std::less<int>(), 1000, 64 };
+    for (int i = 0; i < 3000; ++i)
+        full.push(i);
+    assert(full.spilledSize() == 2000);
+    rlimit oldLimit {};
+    getrlimit(RLIMIT_FSIZE, &oldLimit);
+    rlimit limit = oldLimit;
+    limit.rlim_cur = 2000 * sizeof(int) + 100;
+    void (*oldHandler)(int) = std::signal(SIGXFSZ, SIG_IGN);
+    setrlimit(RLIMIT_FSIZE, &limit);
+    threw = false;
+    try {
+        full.push(3000);
+    }
+    catch (const std::system_error &) {
+        threw = true;
+    }
+    setrlimit(RLIMIT_FSIZE, &oldLimit);
+    std::signal(SIGXFSZ, oldHandler);
+    assert(threw);
+    assert(full.size() == 3000 && full.spilledSize() == 2000);
+    full.push(3000);
+    for (int expected = 3000; expected >= 0; --expected) {
+        [[maybe_unused]] int got = full.pop_top();
+        assert(got == expected);
+    }
+    assert(full.empty());
+
+    std::cout << "testExternal succeeded!" << std::endl;
+}
+
+
+// Test the index handles, slot reuse and flat serialization of
+// CompactPairingPQ, checking every pop against a sorted copy.
+void testCompactPairing() {
+    std::cout << "Testing CompactPairingPQ separately..." << std::endl;
+
+    CompactPairingPQ<int> pq;
+    std::vector<CompactPairingPQ<int>::Handle> handles;
+    std::vector<int> values;
+    for (int i = 0; i < 200; ++i) {
+        int value = (i * 37) % 211;
+        handles.push_back(pq.addNode(value));
+        values.push_back(value);
+    }
+
+    // Raise some elements, including leftmost and non-leftmost children.
+    for (size_t i = 0; i < handles.size(); i += 7) {
+        values[i] += 300;
+        pq.updateElt(handles[i], values[i]);
+        assert(pq.getElt(handles[i]) == values[i]);
+    }
+
+    // A copy and a deserialized heap must pop the same sequence.
+    CompactPairingPQ<int> copy { pq };
+    CompactPairingPQ<int> loaded;
+    loaded.deserialize(pq.serialize());
+    assert(loaded.size() == pq.size());
+
+    // Truncated or corrupt buffers are rejected and leave the heap alone.
+    {
+        const std::vector<unsigned char> good = pq.serialize();
+        std::vector<std::vector<unsigned char>> bad;
+        bad.emplace_back(good.begin(), good.begin() + 8);
+        bad.emplace_back(good.begin(), good.end() - 1);
+        bad.push_back(good);
+        const uint32_t farRoot = 0x7fffffff;
+        std::memcpy(bad.back().data() + 2 * sizeof(uint64_t), &farRoot, sizeof(farRoot));
+        bad.push_back(good);
+        const uint64_t wrongSize = pq.size() + 1;
+        std::memcpy(bad.back().data() + sizeof(uint64_t), &wrongSize, sizeof(wrongSize));
+
+        // Buffers with consistent sizes but broken links. A slot of a
+        // CompactPairingPQ<int> is the element and then child, sibling and
+        // prev, 4 bytes each, after a 24 byte header whose last two fields
+        // are root and freeList.
+        CompactPairingPQ<int> small { values.begin(), values.begin() + 10 };
+        small.pop();
+        small.pop();
+        const std::vector<unsigned char> holey = small.serialize();
+        const size_t header = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+        auto field = [&](size_t slot, size_t index) {
+            return header + (4 * slot + index + 1) * sizeof(uint32_t);
+        };
+        auto read = [&](size_t offset) {
+            uint32_t link = 0;
+            std::memcpy(&link, holey.data() + offset, sizeof(link));
+            return link;
+        };
+        auto corrupt = [&](size_t offset, uint32_t link) {
+            bad.push_back(holey);
+            std::memcpy(bad.back().data() + offset, &link, sizeof(link));
+        };
+        const uint32_t smallRoot = read(2 * sizeof(uint64_t));
+        const uint32_t freed = read(2 * sizeof(uint64_t) + sizeof(uint32_t));
+        const uint32_t child = read(field(smallRoot, 0));
+        assert(freed != UINT32_MAX && child != UINT32_MAX);
+        // The root is a free slot.
+        corrupt(2 * sizeof(uint64_t), freed);
+        // A live slot links to a free one.
+        corrupt(field(smallRoot, 0), freed);
+        // A cycle back to the root's child.
+        corrupt(field(child, 0), child);
+        // The root's children are cut off, so fewer slots are reachable.
+        corrupt(field(smallRoot, 0), UINT32_MAX);
+        CompactPairingPQ<int> check;
+        check.deserialize(holey);
+        assert(check.size() == 8 && check.top() == small.top());
+
+        CompactPairingPQ<int> victim { values.begin(), values.begin() + 3 };
+        for (const std::vector<unsigned char> &buffer : bad) {
+            [[maybe_unused]] bool thrown = false;
+            try {
+                victim.deserialize(buffer);
+            }
+            catch (const std::invalid_argument &) {
+                thrown = true;
+            }
+            assert(thrown);
+            assert(victim.size() == 3);
+        }
+    }
+
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < 100; ++i) {
+        [[maybe_unused]] int got = pq.pop_top();
+        assert(got == values.back());
+        [[maybe_unused]] int copied = copy.pop_top();
+        assert(copied == values.back());
+        [[maybe_unused]] int reloaded = loaded.pop_top();
+        assert(reloaded == values.back());
+        values.pop_back();
+    }
+
+    // Popped slots are reused by later pushes; older handles stay valid.
+    CompactPairingPQ<int>::Handle survivor = handles[1];
+    [[maybe_unused]] int survivorValue = pq.getElt(survivor);
+    for (int i = 0; i < 100; ++i)
+        pq.push(-i);
+    assert(pq.getElt(survivor) == survivorValue);
+    pq.updateElt(survivor, 1000);
+    assert(pq.top() == 1000);
+    assert(pq.size() == 200);
+
+    // Strings are not trivially copyable but everything else works.
+    CompactPairingPQ<std::string> words;
+    words.emplace(3, 'b');
+    words.push("aaaa");
+    words.pop();
+    words.emplace(2, 'c');
+    assert(words.top() == "cc");
+
+    std::cout << "testCompactPairing succeeded!" << std::endl;
+}
+
+
+// Test updatePriorities and range construction with several rebuild
+// threads, on queues large enough to take the parallel path.
+template <template <typename...> typename PQ>
+void testParallelRebuild() {
+    std::cout << "Testing parallel rebuilds..." << std::endl;
+
+    setRebuildThreads(4);
+    assert(rebuildWorkers(4 * PARALLEL_REBUILD_GRAIN) == 4);
+    assert(rebuildWorkers(100) == 1);
+
+    std::vector<int> keys(4 * PARALLEL_REBUILD_GRAIN + 123);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = static_cast<int>((i * 7919) % 100003);
+    std::vector<const int *> ptrs;
+    for (const int &key : keys)
+        ptrs.push_back(&key);
+
+    PQ<const int *, IntPtrComp> pq { ptrs.begin(), ptrs.end() };
+    assert(*pq.top() == 100002);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = static_cast<int>((i * 104729) % 99991);
+    pq.updatePriorities();
+
+    std::vector<int> expected(keys);
+    std::sort(expected.begin(), expected.end());
+    while (!expected.empty()) {
+        assert(*pq.top() == expected.back());
+        pq.pop();
+        expected.pop_back();
+    }
+
+    // A task that throws stops the loop and the exception reaches the caller.
+    [[maybe_unused]] bool thrown = false;
+    try {
+        parallelFor(4, 100, [](size_t i) {
+            if (i == 10)
+                throw std::runtime_error("task failed");
+        });
+    }
+    catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    setRebuildThreads(1);
+    std::cout << "testParallelRebuild succeeded!" << std::endl;
+}
+
+
+// Test WorkStealingScheduler: every task, including the ones tasks push,
+// runs exactly once with either steal policy, and an exception thrown by a
+// task reaches the caller.
+void testWorkStealing() {
+    std::cout << "Testing the work-stealing scheduler..." << std::endl;
+
+    // Task n pushes 2n + 1 and 2n + 2 below the limit: a binary tree with
+    // every number below it exactly once.
+    constexpr int LIMIT = 20000;
+    for (StealPolicy policy : { StealPolicy::One, StealPolicy::Half }) {
+        for (size_t workers : { 1, 4 }) {
+            std::vector<std::atomic<int>> runs(LIMIT);
+            WorkStealingScheduler<int> scheduler { workers, std::less<int>(), policy };
+            assert(scheduler.workers() == workers);
+            scheduler.push(0);
+            [[maybe_unused]] auto stats = scheduler.run([&](int task, WorkStealingScheduler<int>::Worker &worker) {
+                assert(worker.index() < workers);
+                ++runs[size_t(task)];
+                for (int child : { 2 * task + 1, 2 * task + 2 })
+                    if (child < LIMIT)
+                        worker.push(child);
+            });
+            assert(stats.processed == LIMIT);
+            for ([[maybe_unused]] const std::atomic<int> &count : runs)
+                assert(count == 1);
+            if (workers == 1)
+                assert(stats.steals == 0);
+        }
+    }
+
+    // With one worker the order is exact.
+    WorkStealingScheduler<int> single { 1 };
+    for (int i : { 5, 1, 9, 3 })
+        single.push(i);
+    std::vector<int> order;
+    single.run([&](int task, WorkStealingScheduler<int>::Worker &) {
+        order.push_back(task);
+    });
+    assert((order == std::vector<int> { 9, 5, 3, 1 }));
+
+    // A failing task stops the run and drops the rest.
+    WorkStealingScheduler<int> failing { 4 };
+    for (int i = 0; i < 100; ++i)
+        failing.push(i);
+    [[maybe_unused]] bool thrown = false;
+    try {
+        failing.run([](int task, WorkStealingScheduler<int>::Worker &) {
+            if (task == 50)
+                throw std::runtime_error("task failed");
+        });
+    }
+    catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    [[maybe_unused]] auto stats = failing.run([](int, WorkStealingScheduler<int>::Worker &) {});
+    assert(stats.processed == 0);
+
+    std::cout << "testWorkStealing succeeded!" << std::endl;
+}
+
+
+// Test push_batch of SortedPQ and the push buffer of BufferedSortedPQ
+// against a sorted vector.
+void testSortedBatch() {
+    std::cout << "Testing SortedPQ batches and buffered pushes..." << std::endl;
+
+    SortedPQ<int> pq;
+    std::vector<int> expected;
+    std::vector<int> batch;
+    for (int round = 0; round < 5; ++round) {
+        batch.clear();
+        for (int i = 0; i < 200; ++i)
+            batch.push_back((i * 7919 + round * 31) % 1013);
+        pq.push_batch(batch.begin(), batch.end());
+        expected.insert(expected.end(), batch.begin(), batch.end());
+        pq.pop();
+        std::sort(expected.begin(), expected.end());
+        expected.pop_back();
+    }
+    assert(pq.size() == expected.size());
+
+    // Buffered pushes: the top is right before anything is merged, and
+    // pops that do not reach the buffer leave it alone.
+    BufferedSortedPQ<int> buffered { expected.begin(), expected.end() };
+    buffered.push(2000);
+    buffered.push(-5);
+    buffered.push(1500);
+    expected.insert(expected.end(), { 2000, -5, 1500 });
+    assert(buffered.top() == 2000);
+    assert(buffered.size() == expected.size());
+    for (int i = 0; i < 100; ++i) {
+        std::sort(expected.begin(), expected.end());
+        [[maybe_unused]] int got = buffered.pop_top();
+        assert(got == expected.back());
+        expected.pop_back();
+        buffered.emplace(i * 13 % 1100);
+        expected.push_back(i * 13 % 1100);
+    }
+    buffered.flush();
+    buffered.push_batch(expected.begin(), expected.begin() + 1);
+    buffered.push(3000);
+    expected.push_back(expected.front());
+    expected.push_back(3000);
+
+    std::sort(expected.begin(), expected.end());
+    while (!expected.empty()) {
+        [[maybe_unused]] int got = buffered.pop_top();
+        assert(got == expected.back());
+        expected.pop_back();
+    }
+    assert(buffered.empty());
+
+    // Buffered elements are picked up by updatePriorities and
+    // notifyChanged.
+    std::vector<int> keys { 5, 1, 9, 3 };
+    BufferedSortedPQ<const int *, IntPtrComp> ptrs;
+    ptrs.push(&keys[2]);
+    ptrs.flush();
+    for (const int &key : keys)
+        ptrs.push(&key);
+    keys[1] = 20;
+    ptrs.updatePriorities();
+    assert(ptrs.top() == &keys[1]);
+    ptrs.push(&keys[0]);
+    keys[0] = 30;
+    ptrs.notifyChanged({ &keys[0] });
+    [[maybe_unused]] const int *got = ptrs.pop_top();
+    assert(got == &keys[0]);
+    keys[2] = 40;
+    ptrs.notifyChanged({ &keys[2] });
+    assert(ptrs.top() == &keys[2]);
+    assert(ptrs.size() == keys.size() + 1);
+
+    std::cout << "testSortedBatch succeeded!" << std::endl;
+}
+
+
+// Test handles, two-way updateElt and erase of IndexedBinaryPQ against a
+// plain vector of the live values.
+void testIndexedBinary() {
+    std::cout << "Testing IndexedBinaryPQ separately..." << std::endl;
+
+    using Handle = IndexedBinaryPQ<int>::Handle;
+    IndexedBinaryPQ<int> pq;
+    std::vector<Handle> handles;
+    std::vector<int> values;
+    for (int i = 0; i < 300; ++i) {
+        values.push_back((i * 7919) % 1013);
+        handles.push_back(pq.addNode(values.back()));
+    }
+
+    // Raise and lower elements, then erase some.
+    for (size_t i = 0; i < handles.size(); i += 3) {
+        values[i] = (i % 2 == 0) ? values[i] + 2000 : values[i] - 2000;
+        pq.updateElt(handles[i], values[i]);
+        assert(pq.getElt(handles[i]) == values[i]);
+    }
+    for (size_t i = 1; i < handles.size(); i += 10) {
+        pq.erase(handles[i]);
+        assert(not pq.contains(handles[i]));
+    }
+    assert(pq.getElt(handles[0]) == values[0]);
+
+    std::vector<int> expected;
+    for (size_t i = 0; i < values.size(); ++i)
+        if (i % 10 != 1)
+            expected.push_back(values[i]);
+    std::sort(expected.begin(), expected.end());
+    assert(pq.size() == expected.size());
+
+    // The top handle always points at the top element.
+    while (!expected.empty()) {
+        assert(pq.getElt(pq.topHandle()) == pq.top());
+        [[maybe_unused]] int got = pq.pop_top();
+        assert(got == expected.back());
+        expected.pop_back();
+    }
+
+    // Handles of popped elements are reused.
+    Handle reused = pq.addNode(5);
+    assert(reused < handles.size());
+    pq.updateElt(reused, 1);
+    assert(pq.top() == 1);
+
+    // Pointer elements whose pointees change can be repaired by handle.
+    std::vector<int> keys(300);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = static_cast<int>((i * 7919) % 1013);
+    IndexedBinaryPQ<const int *, IntPtrComp> ptrs;
+    std::vector<Handle> changed;
+    for (const int &key : keys)
+        ptrs.addNode(&key);
+    for (Handle handle = 2; handle < keys.size(); handle += 50) {
+        keys[handle] += (handle % 4 == 0) ? 2000 : -2000;
+        changed.push_back(handle);
+    }
+    ptrs.notifyChangedHandles(changed);
+    std::vector<int> sorted(keys);
+    std::sort(sorted.begin(), sorted.end());
+    for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
+        [[maybe_unused]] const int *got = ptrs.pop_top();
+        assert(*got == *it);
+    }
+
+    std::cout << "testIndexedBinary succeeded!" << std::endl;
+}
+
+
+// Test a heap with PairingPQ's Node* handle API (FibonacciPQ,
+// RankPairingPQ) against a std::multiset: random addNode, two-way updateElt,
+// erase and pop, with copies and rebuilds along the way.
+template <template <typename...> typename PQ>
+void testNodeHandles() {
+    std::cout << "Testing Node* handles..." << std::endl;
+
+    // Values are key * 65536 + a tag unique to the node, so they are all
+    // distinct and every pop identifies the node it removed.
+    using Node = typename PQ<int>::Node;
+    PQ<int> pq;
+    std::set<int> reference;
+    std::vector<Node *> nodes;
+    int tag = 0;
+    uint32_t state = 281;
+    auto next = [&state](uint32_t bound) {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 8) % bound);
+    };
+
+    for (int step = 0; step < 20000; ++step) {
+        const int action = next(100);
+        if (nodes.empty() || action < 35) {
+            int value = next(16384) * 65536 + tag++;
+            nodes.push_back(pq.addNode(value));
+            reference.insert(value);
+        }
+        else if (action < 70) {
+            // Mostly promotions, as in Dijkstra, but demotions and
+            // updates to the same value too.
+            size_t i = static_cast<size_t>(next(static_cast<uint32_t>(nodes.size())));
+            int old = nodes[i]->getElt();
+            int key = old / 65536;
+            if (action < 60)
+                key = std::min(key + next(2000), 32767);
+            else if (action < 69)
+                key = std::max(key - next(2000), 0);
+            int value = key * 65536 + old % 65536;
+            pq.updateElt(nodes[i], value);
+            assert(**nodes[i] == value);
+            reference.erase(old);
+            reference.insert(value);
+        }
+        else if (action < 80) {
+            size_t i = static_cast<size_t>(next(static_cast<uint32_t>(nodes.size())));
+            reference.erase(nodes[i]->getElt());
+            pq.erase(nodes[i]);
+            nodes[i] = nodes.back();
+            nodes.pop_back();
+        }
+        else {
+            auto it = std::find(nodes.begin(), nodes.end(), nullptr);
+            for (auto n = nodes.begin(); n != nodes.end(); ++n) {
+                if ((*n)->getElt() == pq.top())
+                    it = n;
+            }
+            assert(it != nodes.end());
+            [[maybe_unused]] int got = pq.pop_top();
+            assert(got == *reference.rbegin());
+            reference.erase(std::prev(reference.end()));
+            *it = nodes.back();
+            nodes.pop_back();
+        }
+        assert(pq.size() == reference.size());
+        if (!reference.empty())
+            assert(pq.top() == *reference.rbegin());
+
+        if (step % 5000 == 4999) {
+            // A copy has the same elements in the same order.
+            PQ<int> copy { pq };
+            PQ<int> assigned;
+            assigned = copy;
+            for (auto it = reference.rbegin(); it != reference.rend(); ++it) {
+                [[maybe_unused]] int copied = copy.pop_top();
+                [[maybe_unused]] int reassigned = assigned.pop_top();
+                assert(copied == *it && reassigned == *it);
+            }
+            assert(copy.empty() && assigned.empty());
+            pq.updatePriorities();
+        }
+    }
+    while (!reference.empty()) {
+        [[maybe_unused]] int got = pq.pop_top();
+        assert(got == *reference.rbegin());
+        reference.erase(std::prev(reference.end()));
+    }
+    assert(pq.empty());
+
+    // Pointers stay equal when their pointees change, in either direction.
+    int keys[] { 10, 20, 30, 40, 50, 60 };
+    PQ<const int *, IntPtrComp> ptrs;
+    std::vector<typename PQ<const int *, IntPtrComp>::Node *> handles;
+    for (const int &key : keys)
+        handles.push_back(ptrs.addNode(&key));
+    ptrs.pop();
+    keys[4] = 0;
+    ptrs.updateElt(handles[4], &keys[4]);
+    assert(*ptrs.top() == 40);
+    keys[0] = 70;
+    ptrs.updateElt(handles[0], &keys[0]);
+    assert(*ptrs.top() == 70);
+    keys[0] = 5;
+    ptrs.updateElt(handles[0], &keys[0]);
+    for ([[maybe_unused]] int expected : { 40, 30, 20, 5, 0 }) {
+        [[maybe_unused]] const int *got = ptrs.pop_top();
+        assert(*got == expected);
+    }
+    assert(ptrs.empty());
+
+    // Strings need their destructors run, so clear() walks the nodes.
+    PQ<std::string> words;
+    for (const char *word : { "fib", "rank", "pair", "heap", "node" })
+        words.push(word);
+    words.pop();
+    PQ<std::string> copy { words };
+    words.clear();
+    assert(words.empty());
+    assert(copy.size() == 4 && copy.top() == "pair");
+
+    std::cout << "testNodeHandles succeeded!" << std::endl;
+}
+
+
+// Test a thread-safe PQ from several threads: concurrent pushes, then
+// concurrent pushes and try_pops, must neither lose nor duplicate an
+// element. What is left afterwards must still pop in order.
+template <template <typename...> typename PQ>
+void testConcurrent() {
+    std::cout << "Testing concurrent pushes and pops..." << std::endl;
+
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 5000;
+    PQ<int> pq {};
+
+    auto pushAll = [&](int t) {
+        for (int i = 0; i < PER_THREAD; ++i)
+            pq.push(t * PER_THREAD + (i * 7919) % PER_THREAD);
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+        threads.emplace_back(pushAll, t);
+    for (std::thread &thread : threads)
+        thread.join();
+    threads.clear();
+    assert(pq.size() == THREADS * PER_THREAD);
+
+    // Each thread pushes a second batch while popping as many elements.
+    std::vector<std::vector<int>> popped(THREADS);
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                pq.push((THREADS + t) * PER_THREAD + i);
+                int value = -1;
+                if (pq.try_pop(value))
+                    popped[size_t(t)].push_back(value);
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    std::vector<int> seen;
+    for (const std::vector<int> &values : popped)
+        seen.insert(seen.end(), values.begin(), values.end());
+    std::vector<int> rest;
+    while (!pq.empty()) {
+        rest.push_back(pq.pop_top());
+        assert(rest.size() < 2 || rest[rest.size() - 2] >= rest.back());
+    }
+    int value = 0;
+    [[maybe_unused]] bool found = pq.try_pop(value);
+    assert(not found);
+
+    seen.insert(seen.end(), rest.begin(), rest.end());
+    std::sort(seen.begin(), seen.end());
+    assert(seen.size() == size_t(2 * THREADS * PER_THREAD));
+    for (size_t i = 0; i < seen.size(); ++i)
+        assert(seen[i] == int(i));
+
+    std::cout << "testConcurrent succeeded!" << std::endl;
+}
+
+
+// An element whose copy throws for negative keys, for queues that must
+// stay usable after a push fails.
+struct FragileCopy {
+    int key;
+
+    explicit FragileCopy(int k) : key{ k } {}
+    FragileCopy(const FragileCopy &other) : key{ other.key } {
+        if (key < 0)
+            throw std::runtime_error("FragileCopy: copy failed");
+    }
+    FragileCopy(FragileCopy &&other) noexcept = default;
+    FragileCopy &operator=(const FragileCopy &other) = default;
+    FragileCopy &operator=(FragileCopy &&other) noexcept = default;
+};
+
+struct FragileCopyComp {
+    bool operator()(const FragileCopy &a, const FragileCopy &b) const { return a.key < b.key; }
+};
+
+
+// Test the lane and choice parameters of MultiQueuePQ's range constructor,
+// and that a push that throws leaves its lane unlocked and uncounted.
+void testMultiQueue() {
+    std::cout << "Testing MultiQueuePQ separately..." << std::endl;
+
+    std::vector<int> values;
+    for (int i = 0; i < 100; ++i)
+        values.push_back((i * 7919) % 101);
+    MultiQueuePQ<int> pq { values.begin(), values.end(), std::less<int>(), 3, 1 };
+    assert(pq.lanes() == 3);
+    assert(pq.size() == values.size());
+    int value = -1;
+    [[maybe_unused]] bool popped = pq.try_pop(value);
+    assert(popped);
+    std::sort(values.begin(), values.end());
+    values.erase(std::find(values.begin(), values.end(), value));
+    while (!values.empty()) {
+        [[maybe_unused]] int got = pq.pop_top();
+        assert(got == values.back());
+        values.pop_back();
+    }
+    assert(pq.empty());
+
+    // With one lane, a lock left behind would make the next push spin.
+    MultiQueuePQ<FragileCopy, FragileCopyComp> fragile { FragileCopyComp(), 1 };
+    fragile.push(FragileCopy { 1 });
+    const FragileCopy broken { -1 };
+    [[maybe_unused]] bool thrown = false;
+    try {
+        fragile.push(broken);
+    }
+    catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(fragile.size() == 1);
+    fragile.push(FragileCopy { 2 });
+    FragileCopy out { 0 };
+    popped = fragile.try_pop(out);
+    assert(popped && out.key == 2);
+    [[maybe_unused]] FragileCopy last = fragile.pop_top();
+    assert(last.key == 1 && fragile.empty());
+
+    std::cout << "testMultiQueue succeeded!" << std::endl;
+}
+
+
+// Test what is particular to SkipListPQ: claimed nodes stay in the list for
+// a while, and pop_top copies instead of moving.
+void testSkipList() {
+    std::cout << "Testing SkipListPQ separately..." << std::endl;
+
+    // Enough pops that the claimed prefix is cut off several times, with
+    // pushes landing both in front of and behind the elements left.
+    SkipListPQ<int> pq;
+    std::vector<int> expected;
+    for (int i = 0; i < 1000; ++i) {
+        pq.push((i * 7919) % 1013);
+        expected.push_back((i * 7919) % 1013);
+    }
+    std::sort(expected.begin(), expected.end());
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 60; ++i) {
+            int top = -1;
+            [[maybe_unused]] bool found = pq.try_top(top);
+            assert(found && top == expected.back());
+            [[maybe_unused]] int got = pq.pop_top();
+            assert(got == expected.back());
+            expected.pop_back();
+        }
+        pq.push(2000 + round);
+        pq.push(-round);
+        expected.insert(expected.end(), { 2000 + round, -round });
+        std::sort(expected.begin(), expected.end());
+        assert(pq.top() == expected.back());
+        assert(pq.size() == expected.size());
+    }
+
+    // Copies and rebuilds leave the claimed nodes behind.
+    SkipListPQ<int> copy { pq };
+    pq.updatePriorities();
+    while (!expected.empty()) {
+        [[maybe_unused]] int copied = copy.pop_top();
+        assert(copied == expected.back());
+        [[maybe_unused]] int got = pq.pop_top();
+        assert(got == expected.back());
+        expected.pop_back();
+    }
+    int value = 0;
+    [[maybe_unused]] bool found = pq.try_top(value);
+    [[maybe_unused]] bool popped = pq.try_pop(value);
+    assert(not found && not popped);
+
+    // Other threads may still read a claimed element, so it is copied out.
+    SkipListPQ<CopyCounter, CopyCounterComp> counters;
+    CopyCounter::copies = 0;
+    for (int i = 0; i < 10; ++i)
+        counters.emplace(i);
+    assert(CopyCounter::copies == 0);
+    for (int i = 9; i >= 0; --i) {
+        [[maybe_unused]] CopyCounter got = counters.pop_top();
+        assert(got.key == i);
+    }
+    assert(CopyCounter::copies == 10);
+
+    std::cout << "testSkipList succeeded!" << std::endl;
+}
+
+
+// RadixPQ needs an integer key; CopyCounterComp orders by the key member,
+// largest first.
+template <>
+struct PQKey<CopyCounter, CopyCounterComp> {
+    using key_type = PQKey<int, std::less<int>>::key_type;
+
+    static key_type key(const CopyCounter &val) {
+        return PQKey<int, std::less<int>>::key(val.key);
+    }
+};
+
+
+// Test RadixPQ. Its elements must be popped in monotone order, which the
+// generic tests do not do, so it is checked against BinaryPQ on monotone
+// workloads instead, and for rejecting the pushes that break the order.
+void testRadix() {
+    std::cout << "Testing RadixPQ separately..." << std::endl;
+
+    // Smallest first, Dijkstra style: every push is at least the last key
+    // popped, by offsets from 0 up to 2^40 so that every bucket is used.
+    RadixPQ<uint64_t> pq;
+    BinaryPQ<uint64_t, std::greater<uint64_t>> reference;
+    uint64_t state = 281;
+    uint64_t last = 0;
+    for (int i = 0; i < 5000; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t key = last + ((state >> 24) >> (state % 41));
+        pq.push(key);
+        reference.push(key);
+        if (i % 3 == 2) {
+            assert(pq.top() == reference.top());
+            last = pq.pop_top();
+            [[maybe_unused]] uint64_t expected = reference.pop_top();
+            assert(last == expected);
+            assert(pq.lastKey() == last);
+        }
+    }
+    RadixPQ<uint64_t> copy { pq };
+    pq.updatePriorities();
+    assert(pq.size() == reference.size());
+    while (!reference.empty()) {
+        assert(copy.top() == reference.top());
+        [[maybe_unused]] uint64_t copied = copy.pop_top();
+        assert(copied == reference.top());
+        [[maybe_unused]] uint64_t got = pq.pop_top();
+        [[maybe_unused]] uint64_t expected = reference.pop_top();
+        assert(got == expected);
+    }
+    assert(pq.empty() && copy.empty());
+
+    // Largest first, with negative ints, through the range constructor.
+    std::vector<int> values { -5, 3, -100, 42, 0, 3, -1 };
+    RadixPQ<int, std::less<int>> ints { values.begin(), values.end() };
+    std::sort(values.begin(), values.end());
+    assert(ints.top() == 42);
+    ints.pop();
+    ints.push(17);
+    ints.push(42);
+    values.back() = 17;
+    values.push_back(42);
+    std::sort(values.begin(), values.end());
+    while (!values.empty()) {
+        [[maybe_unused]] int got = ints.pop_top();
+        assert(got == values.back());
+        values.pop_back();
+    }
+
+    // Key-value pairs: pop removes the very element top() returned, even
+    // among equal keys.
+    RadixPQ<std::pair<unsigned, std::string>, FirstGreater> pairs;
+    pairs.push({ 7, "g" });
+    pairs.push({ 3, "c1" });
+    pairs.push({ 9, "i" });
+    pairs.push({ 3, "c2" });
+    std::vector<std::string> popped;
+    while (!pairs.empty()) {
+        std::string expected = pairs.top().second;
+        popped.push_back(pairs.pop_top().second);
+        assert(popped.back() == expected);
+        if (popped.size() == 1)
+            pairs.push({ 3, "c3" });
+    }
+    std::vector<std::string> tail { popped.begin(), popped.begin() + 3 };
+    std::sort(tail.begin(), tail.end());
+    assert((tail == std::vector<std::string> { "c1", "c2", "c3" }));
+    assert(popped[3] == "g" && popped[4] == "i");
+
+    // Pushing before the last key popped is reported, and changes nothing.
+    RadixPQ<unsigned> strict;
+    strict.push(10);
+    strict.push(20);
+    [[maybe_unused]] unsigned first = strict.pop_top();
+    assert(first == 10);
+    [[maybe_unused]] bool thrown = false;
+    try {
+        strict.push(9);
+    }
+    catch (const std::logic_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(strict.size() == 1 && strict.top() == 20);
+    strict.push(10);
+    first = strict.pop_top();
+    [[maybe_unused]] unsigned second = strict.pop_top();
+    assert(first == 10 && second == 20 && strict.empty());
+
+    std::cout << "testRadix succeeded!" << std::endl;
+}
+
+
+// Test TimerWheelPQ against a std::set of (deadline, id) timers, with
+// deadlines spread over every level of the wheel and some of them already
+// in the past (the late list).
+void testTimerWheel() {
+    std::cout << "Testing TimerWheelPQ separately..." << std::endl;
+
+    using Timer = std::pair<uint64_t, uint32_t>;
+    using Wheel = TimerWheelPQ<Timer, FirstGreater>;
+    Wheel wheel;
+    std::set<Timer> reference;
+    std::vector<Wheel::Node*> handles;
+    std::vector<uint64_t> deadlines;
+
+    uint64_t state = 281;
+    auto next = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return state >> 16;
+    };
+    auto deadline = [&]() -> uint64_t {
+        const uint64_t spans[] = { 1, 64, 4096, 1ULL << 20, 1ULL << 40 };
+        uint64_t offset = next() % spans[next() % 5];
+        if (next() % 10 == 0)
+            return wheel.time() > offset ? wheel.time() - offset : 0;
+        return wheel.time() + offset;
+    };
+    auto expire = [&](uint64_t to) {
+        std::vector<Timer> fired;
+        [[maybe_unused]] size_t count = wheel.advance(to, [&](Timer &&timer) { fired.push_back(timer); });
+        assert(count == fired.size());
+        for (size_t i = 0; i < fired.size(); ++i) {
+            assert(fired[i].first <= to);
+            assert(i == 0 || fired[i - 1].first <= fired[i].first);
+            [[maybe_unused]] size_t erased = reference.erase(fired[i]);
+            assert(erased == 1);
+            handles[fired[i].second] = nullptr;
+        }
+        assert(reference.empty() || reference.begin()->first > to);
+        assert(wheel.time() >= to);
+    };
+
+    for (int step = 0; step < 20000; ++step) {
+        uint32_t id = static_cast<uint32_t>(next() % 2000);
+        if (id >= handles.size()) {
+            handles.resize(id + 1, nullptr);
+            deadlines.resize(id + 1, 0);
+        }
+        switch (next() % 8) {
+        case 0: case 1: case 2:
+            // Schedule, or reschedule if already pending.
+            if (handles[id] == nullptr) {
+                deadlines[id] = deadline();
+                handles[id] = wheel.addNode(Timer{ deadlines[id], id });
+            }
+            else {
+                reference.erase(Timer{ deadlines[id], id });
+                deadlines[id] = deadline();
+                wheel.updateElt(handles[id], Timer{ deadlines[id], id });
+            }
+            reference.insert(Timer{ deadlines[id], id });
+            break;
+        case 3: case 4:
+            if (handles[id] != nullptr) {
+                reference.erase(Timer{ deadlines[id], id });
+                wheel.cancel(handles[id]);
+                handles[id] = nullptr;
+            }
+            break;
+        case 5: case 6:
+            expire(wheel.time() + next() % (step % 100 == 0 ? 1ULL << 30 : 256));
+            break;
+        default:
+            if (!wheel.empty()) {
+                assert(wheel.top().first == reference.begin()->first);
+                Timer timer = wheel.pop_top();
+                [[maybe_unused]] size_t erased = reference.erase(timer);
+                assert(erased == 1);
+                handles[timer.second] = nullptr;
+            }
+            break;
+        }
+        assert(wheel.size() == reference.size());
+        if (!wheel.empty())
+            assert(wheel.top().first == reference.begin()->first);
+    }
+
+    // Copies and rebuilds keep every timer; rebuilds keep the handles.
+    Wheel copy { wheel };
+    Wheel assigned;
+    assigned = copy;
+    wheel.updatePriorities();
+    for (uint32_t id = 0; id < handles.size(); ++id) {
+        if (handles[id] != nullptr)
+            assert(handles[id]->getElt() == Timer(deadlines[id], id));
+    }
+    for (Wheel *w : { &wheel, &copy, &assigned }) {
+        std::set<Timer> left { reference };
+        while (!w->empty()) {
+            assert(w->top().first == left.begin()->first);
+            [[maybe_unused]] size_t erased = left.erase(w->pop_top());
+            assert(erased == 1);
+        }
+        assert(left.empty());
+    }
+
+    // Largest first with ints, pushed out of order: everything larger than
+    // the last pop goes through the late list.
+    std::vector<int> values { 5, -3, 12, 7, 0, 12, -40, 99 };
+    TimerWheelPQ<int, std::less<int>> ints { values.begin(), values.begin() + 4 };
+    [[maybe_unused]] int got = ints.pop_top();
+    assert(got == 12);
+    for (auto it = values.begin() + 4; it != values.end(); ++it)
+        ints.push(*it);
+    std::sort(values.begin(), values.end());
+    values.erase(std::find(values.begin(), values.end(), 12));
+    while (!values.empty()) {
+        assert(ints.top() == values.back());
+        ints.pop();
+        values.pop_back();
+    }
+    assert(ints.empty());
+
+    std::cout << "testTimerWheel succeeded!" << std::endl;
+}
+
+
+// BucketPQ takes the priority from a key extractor, and needs to know which
+// end of the range the comparator puts on top.
+template <>
+struct HighestFirst<IntPtrComp> : std::true_type {};
+
+template <>
+struct HighestFirst<CopyCounterComp> : std::true_type {};
+
+struct IntPtrPriority {
+    int operator()(const int *ptr) const { return *ptr; }
+};
+
+struct CopyCounterPriority {
+    int operator()(const CopyCounter &val) const { return val.key; }
+};
+
+
+// Test BucketPQ against BinaryPQ, and for what is particular to it: FIFO
+// order within a priority, the range, and its own key extractors.
+void testBucket() {
+    std::cout << "Testing BucketPQ..." << std::endl;
+
+    // Random pushes and pops of priorities 0..4095, largest first.
+    BucketPQ<int> pq { 0, 4095 };
+    Eecs281PQ<int> &eecsPQ = pq;
+    BinaryPQ<int> reference;
+    uint32_t state = 281;
+    for (int i = 0; i < 20000; ++i) {
+        state = state * 1103515245 + 12345;
+        if (reference.empty() || (state >> 16) % 3 != 0) {
+            int value = static_cast<int>((state >> 8) % 4096);
+            eecsPQ.push(value);
+            reference.push(value);
+        }
+        else {
+            assert(eecsPQ.top() == reference.top());
+            [[maybe_unused]] int got = eecsPQ.pop_top();
+            [[maybe_unused]] int expected = reference.pop_top();
+            assert(got == expected);
+        }
+        assert(eecsPQ.size() == reference.size());
+    }
+    BucketPQ<int> copy { pq };
+    pq.updatePriorities();
+    while (!reference.empty()) {
+        [[maybe_unused]] int copied = copy.pop_top();
+        assert(copied == reference.top());
+        [[maybe_unused]] int got = pq.pop_top();
+        [[maybe_unused]] int expected = reference.pop_top();
+        assert(got == expected);
+    }
+    assert(pq.empty() && copy.empty());
+
+    // Smallest first over a range of many bitmap words, including negative
+    // priorities; equal priorities come out in the order they went in.
+    using Job = std::pair<int, int>;
+    std::vector<Job> jobs { { 70000, 0 }, { -3, 1 }, { 9, 2 }, { -3, 3 }, { 70000, 4 }, { 9, 5 } };
+    BucketPQ<Job, FirstGreater> fifo { jobs.begin(), jobs.end(), -100, 100000 };
+    std::vector<int> order;
+    while (!fifo.empty())
+        order.push_back(fifo.pop_top().second);
+    assert((order == std::vector<int> { 1, 3, 2, 5, 0, 4 }));
+
+    // A bucket that never runs empty is compacted, and stays FIFO.
+    for (int i = 0; i < 1000; ++i) {
+        fifo.push(Job{ 5, 2 * i });
+        fifo.push(Job{ 5, 2 * i + 1 });
+        [[maybe_unused]] Job got = fifo.pop_top();
+        assert(got.second == i);
+    }
+    assert(fifo.size() == 1000 && fifo.top().second == 1000);
+
+    // Priorities outside the range are rejected and change nothing.
+    [[maybe_unused]] bool thrown = false;
+    try {
+        fifo.push(Job{ 100001, 0 });
+    }
+    catch (const std::out_of_range &) {
+        thrown = true;
+    }
+    assert(thrown && fifo.size() == 1000);
+    thrown = false;
+    try {
+        BucketPQ<int> backwards { 10, 0 };
+    }
+    catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Pointers ordered by their pointees, repaired by updatePriorities().
+    std::vector<int> data { 1, 5, 3, 8, 2 };
+    BucketPQ<const int *, IntPtrComp, IntPtrPriority> pointers { 0, 100 };
+    for (const int &datum : data)
+        pointers.push(&datum);
+    assert(*pointers.top() == 8);
+    data[0] = 50;
+    data[3] = 0;
+    pointers.updatePriorities();
+    assert(pointers.top() == &data[0]);
+    pointers.pop();
+    [[maybe_unused]] const int *first = pointers.pop_top();
+    [[maybe_unused]] const int *second = pointers.pop_top();
+    assert(*first == 5 && *second == 3);
+
+    // Moves, never copies.
+    BucketPQ<CopyCounter, CopyCounterComp, CopyCounterPriority> counters { 0, 19 };
+    CopyCounter::copies = 0;
+    for (int i = 0; i < 20; ++i)
+        counters.emplace((i * 7) % 20);
+    for (int expected = 19; expected >= 0; --expected) {
+        [[maybe_unused]] CopyCounter got = counters.pop_top();
+        assert(got.key == expected);
+    }
+    assert(CopyCounter::copies == 0);
+
+    std::cout << "testBucket succeeded!" << std::endl;
+}
+
+
 // Run all tests for a particular PQ type.
 template <template <typename...> typename PQ>
 void testPriorityQueue() {
     testPrimitiveOperations<PQ>();
     testHiddenData<PQ>();
     testUpdatePriorities<PQ>();
+    testNotifyChanged<PQ>();
+    testMoveSemantics<PQ>();
 }
 
 // PairingPQ has some extra behavior we need to test in updateElement.
@@ -309,9 +2154,23 @@ void testPriorityQueue<PairingPQ>() {
     testPrimitiveOperations<PairingPQ>();
     testHiddenData<PairingPQ>();
     testUpdatePriorities<PairingPQ>();
+    testNotifyChanged<PairingPQ>();
+    testMoveSemantics<PairingPQ>();
     testPairing();
 }
 
+// SkipListPQ::pop_top copies by design (see SkipListPQ.h), so it runs its
+// own test of that instead of testMoveSemantics.
+template <>
+void testPriorityQueue<SkipListPQ>() {
+    testPrimitiveOperations<SkipListPQ>();
+    testHiddenData<SkipListPQ>();
+    testUpdatePriorities<SkipListPQ>();
+    testNotifyChanged<SkipListPQ>();
+    testSkipList();
+}
+
+
 
 int main() {
     const std::vector<PQType> types {
@@ -319,6 +2178,20 @@ int main() {
         PQType::Sorted,
         PQType::Binary,
         PQType::Pairing,
+        PQType::UnorderedFast,
+        PQType::Dary,
+        PQType::CompactPairing,
+        PQType::IndexedBinary,
+        PQType::LockedHeap,
+        PQType::MultiQueue,
+        PQType::SkipList,
+        PQType::Radix,
+        PQType::TimerWheel,
+        PQType::Bucket,
+        PQType::Fibonacci,
+        PQType::RankPairing,
+        PQType::BHeap,
+        PQType::External,
     };
 
     std::cout << "PQ tester" << std::endl << std::endl;
@@ -339,15 +2212,88 @@ int main() {
     switch (pqType) {
     case PQType::Unordered:
         testPriorityQueue<UnorderedPQ>();
+        testFindExtreme();
         break;
     case PQType::Sorted:
         testPriorityQueue<SortedPQ>();
+        testMerge<SortedPQ>();
+        testSortedBatch();
+        testParallelRebuild<SortedPQ>();
+        testPriorityQueue<BufferedSortedPQ>();
+        testMerge<BufferedSortedPQ>();
         break;
     case PQType::Binary:
         testPriorityQueue<BinaryPQ>();
+        testMerge<BinaryPQ>();
+        testParallelRebuild<BinaryPQ>();
+        testWorkStealing();
         break;
     case PQType::Pairing:
         testPriorityQueue<PairingPQ>();
+        testMerge<PairingPQ>();
+        break;
+    case PQType::UnorderedFast:
+        testPriorityQueue<UnorderedFastPQ>();
+        testFindExtreme();
+        break;
+    case PQType::Dary:
+        testPriorityQueue<TernaryPQ>();
+        testPriorityQueue<QuaternaryPQ>();
+        testPriorityQueue<OctonaryPQ>();
+        testDary();
+        break;
+    case PQType::CompactPairing:
+        testPriorityQueue<CompactPairingPQ>();
+        testCompactPairing();
+        break;
+    case PQType::IndexedBinary:
+        testPriorityQueue<IndexedBinaryPQ>();
+        testIndexedBinary();
+        break;
+    case PQType::LockedHeap:
+        testPriorityQueue<LockedHeapPQ>();
+        testConcurrent<LockedHeapPQ>();
+        break;
+    case PQType::MultiQueue:
+        testPriorityQueue<MultiQueuePQ>();
+        testConcurrent<MultiQueuePQ>();
+        testMultiQueue();
+        break;
+    case PQType::SkipList:
+        testPriorityQueue<SkipListPQ>();
+        testConcurrent<SkipListPQ>();
+        break;
+    case PQType::Radix:
+        testMoveSemantics<RadixPQ>();
+        testRadix();
+        break;
+    case PQType::TimerWheel:
+        testMoveSemantics<TimerWheelPQ>();
+        testTimerWheel();
+        break;
+    case PQType::Bucket:
+        testBucket();
+        break;
+    case PQType::Fibonacci:
+        testPriorityQueue<FibonacciPQ>();
+        testNodeHandles<FibonacciPQ>();
+        break;
+    case PQType::RankPairing:
+        testPriorityQueue<RankPairingPQ>();
+        testNodeHandles<RankPairingPQ>();
+        break;
+    case PQType::BHeap:
+        testPriorityQueue<BHeapPQ>();
+        testMerge<BHeapPQ>();
+        testBHeap();
+        break;
+    case PQType::External:
+        // Elements are spilled as bytes, so there is no testMoveSemantics.
+        testPrimitiveOperations<ExternalPQ>();
+        testHiddenData<ExternalPQ>();
+        testUpdatePriorities<ExternalPQ>();
+        testNotifyChanged<ExternalPQ>();
+        testExternal();
         break;
     default:
         std::cout << "Unrecognized PQ type " << pqType << " in main.\n"